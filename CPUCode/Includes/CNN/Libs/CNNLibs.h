@@ -5,6 +5,8 @@
 
 		#include "DataManagement/DataManagement.h"
 		#include "Debugging/Debugging.h"
+		#include "LinearAlgebra/LinearAlgebra.h"
+		#include "Threading/Threading.h"
 		#include "Timing/Timing.h"
 	
 #endif
\ No newline at end of file
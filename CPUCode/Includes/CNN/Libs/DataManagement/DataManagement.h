@@ -5,10 +5,62 @@
 
 		#include "Libs/DataManagementLibs.h"
 
-	// 2 --- Function Prototypes --- //
+	// 2 --- Structures --- //
+
+		// 2.1 --- Tensor --- //
+
+			typedef struct
+			{
+				double* Data;				// First element of the Volume
+
+				int Dims[4];				// {Samples, Channels, Height, Width}
+				int Strides[3];				// Elements between consecutive Samples, Channels and Rows. Columns are always contiguous
+
+				char Owner;					// 1 if Data was allocated by this Tensor, 0 if it is a View
+
+			} Tensor;
+
+		// 2.2 --- Arena --- //
+
+			typedef struct
+			{
+				double* Data;				// Aligned Memory Tensors are carved from
+
+				size_t Size;				// Doubles in Data
+				size_t Used;				// Doubles handed out, from the start of Data
+				size_t Peak;				// Most Doubles asked for at once, including Requests that did not fit. Data grows to it once empty
+				size_t Overflow;			// Doubles handed out from the Heap since the Arena was last empty
+
+			} Arena;
+
+		// 2.3 --- Random State --- //
+
+			// xoshiro256** Generator. Each Thread keeps its own, so drawing takes no Lock and the Sequence only depends on the Seed
+			typedef struct
+			{
+				uint64_t State[4];
+
+			} RandState;
+
+	// 3 --- Tensor Access --- //
+
+			#define TensorAlignment 64
+
+			#define TensorAt(T, n, c, y, x) ((T)->Data[(n) * (T)->Strides[0] + (c) * (T)->Strides[1] + (y) * (T)->Strides[2] + (x)])
+			#define TensorRow(T, n, c, y) ((T)->Data + (n) * (T)->Strides[0] + (c) * (T)->Strides[1] + (y) * (T)->Strides[2])
+
+	// 4 --- Function Prototypes --- //
 
 			double GenerateRand(double Min, double Max);
 
+			void SeedRand(RandState* Rand, uint64_t Seed);
+			uint64_t NextRand(RandState* Rand);
+			double UniformRand(RandState* Rand);
+			int RandBelow(RandState* Rand, int Bound);
+			RandState* ThreadRand();
+
+			void ShuffleIndices(RandState* Rand, int* Indices, int Count);
+
 			double* Init1D(int Dim);
 			double*** Init3D(int* Dims);
 
@@ -30,4 +82,27 @@
 			void Free1D(double* Input);
 			void Free3D(double*** Input);
 
+			Tensor InitTensor(int Samples, int* Dims);
+			Tensor ViewTensor(double* Data, int Samples, int* Dims);
+			Tensor SampleView(Tensor* Input, int Sample);
+			Tensor FlattenTensor(Tensor* Input);
+
+			int TensorSize(Tensor* Input);
+			int SampleSize(Tensor* Input);
+
+			void ZeroTensor(Tensor* Input);
+			void RandomizeTensor(Tensor* Input, double Min, double Max);
+			void CopyTensor(Tensor* Input, Tensor* Output);
+			void CompareTensor(Tensor* Input1, Tensor* Input2, double Margin);
+			void PadTensor(Tensor* Input, Tensor* Output, int Padding);
+
+			void FreeTensor(Tensor* Input);
+
+			Arena* ScratchArena();
+			size_t ArenaDoubles(int Samples, int* Dims);
+			void ReserveArena(Arena* Space, size_t Doubles);
+			Tensor ArenaTensor(Arena* Space, int Samples, int* Dims);
+			void ReleaseArena(Arena* Space, size_t Mark);
+			void FreeArena(Arena* Space);
+
 #endif
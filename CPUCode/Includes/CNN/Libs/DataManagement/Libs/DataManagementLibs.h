@@ -3,7 +3,10 @@
 
 	// 1 --- Standart Libs --- //
 
+		#include <pthread.h>
+		#include <stdint.h>
 		#include <stdio.h>
 		#include <stdlib.h>
+		#include <string.h>
 
 #endif
\ No newline at end of file
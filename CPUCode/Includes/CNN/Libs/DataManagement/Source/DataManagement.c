@@ -5,6 +5,13 @@
 
 	1 - Math Operations
 		1.1 - Generate Random
+		1.2 - Random State
+			1.2.1 - Seed
+			1.2.2 - Next
+			1.2.3 - Uniform
+			1.2.4 - Below
+			1.2.5 - Thread
+		1.3 - Shuffle
 
     2 - Array Operations
 
@@ -35,6 +42,38 @@
 		2.7 - Free
 			2.7.1 - 1D
 			2.7.2 - 3D
+
+	3 - Tensor Operations
+
+		3.1 - Init
+			3.1.1 - Init
+			3.1.2 - Views
+			3.1.3 - Flatten
+
+		3.2 - Size
+			3.2.1 - Tensor
+			3.2.2 - Sample
+
+		3.3 - Fill
+			3.3.1 - Zero
+			3.3.2 - Randomize
+
+		3.4 - Copy
+
+		3.5 - Compare
+
+		3.6 - Pad
+
+		3.7 - Free
+
+	4 - Arena Operations
+
+		4.1 - Scratch
+		4.2 - Size
+		4.3 - Reserve
+		4.4 - Tensors
+		4.5 - Release
+		4.6 - Free
 */
 
 // 1 --- Math Operations --- //
@@ -55,6 +94,153 @@
 			return ( (Max - Min) * ((double)rand() / RAND_MAX) ) + Min;
 		}
 
+	// 1.2 --- Random State --- //
+
+		// 1.2.1 --- Seed --- //
+
+			/*
+				Seed a Generator. The Seed is expanded with SplitMix64, so close Seeds still give unrelated Sequences
+
+	            Rand - Generator
+	            Seed - Any Value
+	            
+	            Return Value - Nothing
+	        */
+
+			void SeedRand(RandState* Rand, uint64_t Seed)
+			{
+				for(int i = 0; i < 4; ++i)
+				{
+					Seed += 0x9E3779B97F4A7C15ULL;
+
+					uint64_t Mixed = Seed;
+					Mixed = (Mixed ^ (Mixed >> 30)) * 0xBF58476D1CE4E5B9ULL;
+					Mixed = (Mixed ^ (Mixed >> 27)) * 0x94D049BB133111EBULL;
+
+					Rand->State[i] = Mixed ^ (Mixed >> 31);
+				}
+			}
+
+		// 1.2.2 --- Next --- //
+
+			/*
+				Next Value of a Generator
+
+	            Rand - Generator
+	            
+	            Return Value - 64 random bits
+	        */
+
+			uint64_t NextRand(RandState* Rand)
+			{
+				uint64_t* s = Rand->State;
+
+				uint64_t Product = s[1] * 5;
+				uint64_t Result = ((Product << 7) | (Product >> 57)) * 9;
+
+				uint64_t Shifted = s[1] << 17;
+
+				s[2] ^= s[0];
+				s[3] ^= s[1];
+				s[1] ^= s[2];
+				s[0] ^= s[3];
+
+				s[2] ^= Shifted;
+				s[3] = (s[3] << 45) | (s[3] >> 19);
+
+				return Result;
+			}
+
+		// 1.2.3 --- Uniform --- //
+
+			/*
+				Uniform double from a Generator
+
+	            Rand - Generator
+	            
+	            Return Value - Random number in [0, 1), a multiple of 2^-53
+	        */
+
+			double UniformRand(RandState* Rand)
+			{
+				return (NextRand(Rand) >> 11) * 0x1.0p-53;
+			}
+
+		// 1.2.4 --- Below --- //
+
+			/*
+				Uniform integer from a Generator, without the bias of a modulo or of rounding a double
+
+	            Rand - Generator
+	            Bound - Amount of possible Values, at least 1
+	            
+	            Return Value - Random integer in [0, Bound)
+	        */
+
+			int RandBelow(RandState* Rand, int Bound)
+			{
+				// Multiply and keep the high bits. Draws landing in the uneven Remainder are redrawn
+				uint64_t Range = (uint32_t) Bound;
+				uint64_t Threshold = (0x100000000ULL - Range) % Range;
+
+				uint64_t Product;
+
+				do
+				{
+					Product = (NextRand(Rand) >> 32) * Range;
+				}
+				while((uint32_t) Product < Threshold);
+
+				return Product >> 32;
+			}
+
+		// 1.2.5 --- Thread --- //
+
+			static __thread RandState ThreadState;
+			static __thread char ThreadSeeded = 0;
+
+			/*
+				Get the Generator of the calling Thread. Seeded from rand() on first use, and reseeded by whoever needs
+				a Sequence that doesn't depend on which Thread draws it
+
+	            Return Value - Generator of the calling Thread
+	        */
+
+			RandState* ThreadRand()
+			{
+				if(!ThreadSeeded)
+				{
+					SeedRand(&ThreadState, ((uint64_t) rand() << 31) ^ rand());
+					ThreadSeeded = 1;
+				}
+
+				return &ThreadState;
+			}
+
+	// 1.3 --- Shuffle --- //
+
+		/*
+			Shuffle Indices in place with Fisher-Yates, so every Permutation is equally likely
+
+            Rand - Generator
+            Indices - Indices
+            Count - Amount of Indices
+            
+            Return Value - Nothing
+        */
+
+		void ShuffleIndices(RandState* Rand, int* Indices, int Count)
+		{
+			for(int i = Count - 1; i > 0; --i)
+			{
+				int j = RandBelow(Rand, i + 1);
+
+				int Swap = Indices[i];
+				Indices[i] = Indices[j];
+				Indices[j] = Swap;
+			}
+		}
+
 // 2 --- Array Operations
 
 	// 2.1 --- Init --- //
@@ -419,3 +605,513 @@
         {
         	free(Input);
 		}
+
+// 3 --- Tensor Operations --- //
+
+	// 3.1 --- Init --- //
+
+		// 3.1.1 --- Init --- //
+
+			/*
+				Init Tensor holding Samples Volumes of the given size in one aligned, contiguous buffer
+
+	            Samples - Amount of Volumes
+	            Dims - Volume Dimensions {Channels, Height, Width}
+	            
+	            Return Value - Tensor with all values initialized to 0. Data is NULL if the allocation failed
+	        */
+
+			Tensor InitTensor(int Samples, int* Dims)
+			{
+				Tensor Output = ViewTensor(NULL, Samples, Dims);
+
+				// Round Size up to the Alignment, posix_memalign does not accept a Size of 0
+				size_t Bytes = (size_t) TensorSize(&Output) * sizeof(double);
+				Bytes += TensorAlignment - (Bytes % TensorAlignment);
+
+				void* Data;
+				if(posix_memalign(&Data, TensorAlignment, Bytes) != 0)
+				{
+					return Output;
+				}
+
+				memset(Data, 0, Bytes);
+
+				Output.Data = (double*) Data;
+				Output.Owner = 1;
+
+				return Output;
+			}
+
+		// 3.1.2 --- Views --- //
+
+			/*
+				Create a Tensor over memory that is already allocated. Nothing is copied
+
+	            Data - Contiguous Values, Samples x Dims. For a volume from Init3D this is Input[0][0]
+	            Samples - Amount of Volumes
+	            Dims - Volume Dimensions {Channels, Height, Width}
+	            
+	            Return Value - Tensor View of Data
+	        */
+
+			Tensor ViewTensor(double* Data, int Samples, int* Dims)
+			{
+				Tensor Output;
+
+				Output.Data = Data;
+
+				Output.Dims[0] = Samples;
+				Output.Dims[1] = Dims[0];
+				Output.Dims[2] = Dims[1];
+				Output.Dims[3] = Dims[2];
+
+				Output.Strides[2] = Dims[2];
+				Output.Strides[1] = Dims[1] * Dims[2];
+				Output.Strides[0] = Dims[0] * Dims[1] * Dims[2];
+
+				Output.Owner = 0;
+
+				return Output;
+			}
+
+			/*
+				Create a View of a single Volume of a Tensor
+
+	            Input - Source Tensor
+	            Sample - Index of the Volume
+	            
+	            Return Value - Tensor View with 1 Sample
+	        */
+
+			Tensor SampleView(Tensor* Input, int Sample)
+			{
+				Tensor Output = *Input;
+
+				Output.Data = Input->Data + (size_t) Sample * Input->Strides[0];
+				Output.Dims[0] = 1;
+				Output.Owner = 0;
+
+				return Output;
+			}
+
+		// 3.1.3 --- Flatten --- //
+
+			/*
+				Reinterpret every Volume of a Tensor as a 1x1xN Volume. Nothing is copied
+
+	            Input - Source Tensor. Each of its Volumes has to be contiguous
+	            
+	            Return Value - Tensor View with Dims {Samples, 1, 1, Channels * Height * Width}
+	        */
+
+			Tensor FlattenTensor(Tensor* Input)
+			{
+				Tensor Output = *Input;
+
+				Output.Dims[1] = 1;
+				Output.Dims[2] = 1;
+				Output.Dims[3] = SampleSize(Input);
+
+				Output.Strides[1] = Output.Dims[3];
+				Output.Strides[2] = Output.Dims[3];
+
+				Output.Owner = 0;
+
+				return Output;
+			}
+
+	// 3.2 --- Size --- //
+
+		// 3.2.1 --- Tensor --- //
+
+			/*
+				Amount of Values in a Tensor
+
+	            Input - Tensor
+	            
+	            Return Value - Samples * Channels * Height * Width
+	        */
+
+			int TensorSize(Tensor* Input)
+			{
+				return Input->Dims[0] * Input->Dims[1] * Input->Dims[2] * Input->Dims[3];
+			}
+
+		// 3.2.2 --- Sample --- //
+
+			/*
+				Amount of Values in each Volume of a Tensor
+
+	            Input - Tensor
+	            
+	            Return Value - Channels * Height * Width
+	        */
+
+			int SampleSize(Tensor* Input)
+			{
+				return Input->Dims[1] * Input->Dims[2] * Input->Dims[3];
+			}
+
+	// 3.3 --- Fill --- //
+
+		// 3.3.1 --- Zero --- //
+
+			/*
+				Set every Value of a Tensor to 0
+
+	            Input - Tensor
+	            
+	            Return Value - Nothing
+	        */
+
+			void ZeroTensor(Tensor* Input)
+			{
+				// Contiguous Tensors are cleared at once
+				if(Input->Strides[2] == Input->Dims[3] && Input->Strides[1] == Input->Dims[2] * Input->Dims[3] && Input->Strides[0] == SampleSize(Input))
+				{
+					memset(Input->Data, 0, (size_t) TensorSize(Input) * sizeof(double));
+					return;
+				}
+
+				for(int n = 0; n < Input->Dims[0]; ++n)
+				{
+					for(int c = 0; c < Input->Dims[1]; ++c)
+					{
+						for(int y = 0; y < Input->Dims[2]; ++y)
+						{
+							memset(TensorRow(Input, n, c, y), 0, Input->Dims[3] * sizeof(double));
+						}
+					}
+				}
+			}
+
+		// 3.3.2 --- Randomize --- //
+
+			/*
+				Randomize Tensor, with random numbers between min and max.
+
+	            Input - Tensor
+	            Min - minimum value
+	            Max - max value
+	            
+	            Return Value - Nothing
+	        */
+
+			void RandomizeTensor(Tensor* Input, double Min, double Max)
+			{
+				for(int n = 0; n < Input->Dims[0]; ++n)
+				{
+					for(int c = 0; c < Input->Dims[1]; ++c)
+					{
+						for(int y = 0; y < Input->Dims[2]; ++y)
+						{
+							double* Row = TensorRow(Input, n, c, y);
+
+							for(int x = 0; x < Input->Dims[3]; ++x)
+							{
+								Row[x] = GenerateRand(Min, Max);
+							}
+						}
+					}
+				}
+			}
+
+	// 3.4 --- Copy --- //
+
+		/*
+			Copy Tensor. Input and Output need the same Dimensions
+
+            Input - Source Tensor
+            Output - Destination Tensor
+            
+            Return Value - Nothing.
+        */
+
+		void CopyTensor(Tensor* Input, Tensor* Output)
+		{
+			for(int n = 0; n < Input->Dims[0]; ++n)
+			{
+				for(int c = 0; c < Input->Dims[1]; ++c)
+				{
+					for(int y = 0; y < Input->Dims[2]; ++y)
+					{
+						memcpy(TensorRow(Output, n, c, y), TensorRow(Input, n, c, y), Input->Dims[3] * sizeof(double));
+					}
+				}
+			}
+		}
+
+	// 3.5 --- Compare --- //
+
+		/*
+			Compare two Tensors with the same Dimensions
+
+            Input1 - First Tensor
+            Input2 - Second Tensor
+            Margin - Maximum allowed Difference
+            
+            Return Value - Nothing.
+        */
+
+		void CompareTensor(Tensor* Input1, Tensor* Input2, double Margin)
+		{
+			for(int n = 0; n < Input1->Dims[0]; ++n)
+			{
+				for(int c = 0; c < Input1->Dims[1]; ++c)
+				{
+					for(int y = 0; y < Input1->Dims[2]; ++y)
+					{
+						for(int x = 0; x < Input1->Dims[3]; ++x)
+						{
+							double Value1 = TensorAt(Input1, n, c, y, x);
+							double Value2 = TensorAt(Input2, n, c, y, x);
+
+							if(Value1 > (Value2 + Margin) || Value1 < (Value2 - Margin))
+							{
+								printf("Compare Error. in1[%d][%d][%d][%d] = %.10f\tin2[%d][%d][%d][%d] = %.10f\n", n, c, y, x, Value1, n, c, y, x, Value2);
+								return;
+							}
+						}
+					}
+				}
+			}
+			printf("Tensors Contain The same values!\n");
+		}
+
+	// 3.6 --- Pad --- //
+
+		/*
+			Pad Tensor with Padding pixels on every side of each Channel
+
+            Input - Input Tensor
+            Output - Padded Tensor. Has to be zeroed, with Height and Width of Input + 2 * Padding
+            Padding - Amount of pixels to Pad
+            
+            Return Value - Nothing.
+        */
+
+		void PadTensor(Tensor* Input, Tensor* Output, int Padding)
+		{
+			for(int n = 0; n < Input->Dims[0]; ++n)
+			{
+				for(int c = 0; c < Input->Dims[1]; ++c)
+				{
+					for(int y = 0; y < Input->Dims[2]; ++y)
+					{
+						memcpy(TensorRow(Output, n, c, y + Padding) + Padding, TensorRow(Input, n, c, y), Input->Dims[3] * sizeof(double));
+					}
+				}
+			}
+		}
+
+	// 3.7 --- Free --- //
+
+		/*
+			Frees Tensor. Views are left untouched
+
+            Input - Tensor
+            
+            Return Value - Nothing.
+        */
+
+		void FreeTensor(Tensor* Input)
+		{
+			if(Input->Owner)
+			{
+				free(Input->Data);
+			}
+
+			Input->Data = NULL;
+			Input->Owner = 0;
+		}
+
+// 4 --- Arena Operations --- //
+
+	// 4.1 --- Scratch --- //
+
+		static pthread_key_t ScratchKey;
+		static pthread_once_t ScratchOnce = PTHREAD_ONCE_INIT;
+
+		static __thread Arena* Scratch = NULL;
+
+		// Free the Scratch Arena of a Thread when it exits
+		static void FreeScratch(void* Space)
+		{
+			FreeArena(Space);
+			free(Space);
+		}
+
+		static void InitScratchKey()
+		{
+			pthread_key_create(&ScratchKey, FreeScratch);
+		}
+
+		/*
+			Get the Scratch Arena of the calling Thread. Every Thread has its own, so Layers running on a Thread Pool
+			can take temporary buffers without Locks. It starts empty, and is freed when its Thread exits
+
+            Return Value - Arena of the calling Thread
+        */
+
+		Arena* ScratchArena()
+		{
+			if(Scratch == NULL)
+			{
+				pthread_once(&ScratchOnce, InitScratchKey);
+
+				Scratch = calloc(1, sizeof(Arena));
+				if(Scratch == NULL)
+				{
+					printf("Memory Allocation Error.\n");
+					exit(-5);						// MemoryError
+				}
+
+				pthread_setspecific(ScratchKey, Scratch);
+			}
+
+			return Scratch;
+		}
+
+	// 4.2 --- Size --- //
+
+		/*
+			Doubles an ArenaTensor takes, so Workspaces can be planned ahead
+
+            Samples - Amount of Volumes
+            Dims - Volume Dimensions {Channels, Height, Width}
+            
+            Return Value - Size of the Tensor, rounded up to TensorAlignment
+        */
+
+		size_t ArenaDoubles(int Samples, int* Dims)
+		{
+			size_t Align = TensorAlignment / sizeof(double);
+			size_t Doubles = (size_t) Samples * Dims[0] * Dims[1] * Dims[2];
+
+			return (Doubles + Align - 1) / Align * Align;
+		}
+
+	// 4.3 --- Reserve --- //
+
+		// Grow Data to Peak. Only called while nothing is handed out, so no Tensor is moved
+		static void GrowArena(Arena* Space)
+		{
+			if(Space->Peak <= Space->Size)
+			{
+				return;
+			}
+
+			free(Space->Data);
+			Space->Data = NULL;
+			Space->Size = 0;
+
+			void* Data;
+			if(posix_memalign(&Data, TensorAlignment, Space->Peak * sizeof(double)) == 0)
+			{
+				Space->Data = (double*) Data;
+				Space->Size = Space->Peak;
+			}
+		}
+
+		/*
+			Make sure an Arena can hand out Doubles at once. Arenas only grow, and only while empty.
+			Otherwise the Arena grows as soon as it is Released to empty
+
+            Space - Arena
+            Doubles - Doubles needed
+            
+            Return Value - Nothing
+        */
+
+		void ReserveArena(Arena* Space, size_t Doubles)
+		{
+			if(Doubles > Space->Peak)
+			{
+				Space->Peak = Doubles;
+			}
+
+			if(Space->Used == 0)
+			{
+				GrowArena(Space);
+			}
+		}
+
+	// 4.4 --- Tensors --- //
+
+		/*
+			Take a Tensor from an Arena. Nothing is allocated while the Arena is big enough.
+			If it is not, the Tensor comes from InitTensor instead, and the Arena grows once it is empty again
+
+            Space - Arena
+            Samples - Amount of Volumes
+            Dims - Volume Dimensions {Channels, Height, Width}
+            
+            Return Value - Tensor. Values are not initialized unless it came from the Heap. Data is NULL if the allocation failed.
+            				Has to be given back with FreeTensor, then ReleaseArena
+        */
+
+		Tensor ArenaTensor(Arena* Space, int Samples, int* Dims)
+		{
+			size_t Doubles = ArenaDoubles(Samples, Dims);
+
+			if(Space->Used + Space->Overflow + Doubles > Space->Peak)
+			{
+				Space->Peak = Space->Used + Space->Overflow + Doubles;
+			}
+
+			if(Space->Used + Doubles > Space->Size)
+			{
+				Space->Overflow += Doubles;
+
+				return InitTensor(Samples, Dims);
+			}
+
+			Tensor Output = ViewTensor(Space->Data + Space->Used, Samples, Dims);
+			Space->Used += Doubles;
+
+			return Output;
+		}
+
+	// 4.5 --- Release --- //
+
+		/*
+			Give back every Tensor taken from an Arena since Mark. Tensors have to be given back in the reverse order they were taken
+
+            Space - Arena
+            Mark - Value of Space->Used before the Tensors were taken
+            
+            Return Value - Nothing
+        */
+
+		void ReleaseArena(Arena* Space, size_t Mark)
+		{
+			Space->Used = Mark;
+
+			if(Mark == 0)
+			{
+				Space->Overflow = 0;
+				GrowArena(Space);
+			}
+		}
+
+	// 4.6 --- Free --- //
+
+		/*
+			Frees the Memory of an Arena. Tensors taken from it can no longer be used
+
+            Space - Arena
+            
+            Return Value - Nothing.
+        */
+
+		void FreeArena(Arena* Space)
+		{
+			free(Space->Data);
+
+			Space->Data = NULL;
+			Space->Size = 0;
+			Space->Used = 0;
+			Space->Peak = 0;
+			Space->Overflow = 0;
+		}
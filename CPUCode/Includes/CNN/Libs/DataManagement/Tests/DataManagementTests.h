@@ -8,6 +8,7 @@
 	// 2 --- Function Prototypes --- //
 		
 		void GenerateRandTest();
+		void ShuffleTest();
 
 		void Init1DTest();
 		void Init3DTest();
@@ -27,4 +28,11 @@
 		void PadTest();
 		void FlipTest();
 
+		void InitTensorTest();
+		void TensorViewTest();
+		void CopyTensorTest();
+		void PadTensorTest();
+
+		void ArenaTest();
+
 #endif
\ No newline at end of file
@@ -5,6 +5,7 @@
 
 	1 - Math Operations
 		1.1 - Generate Random
+		1.2 - Shuffle
 
     2 - Array Operations
 
@@ -31,6 +32,14 @@
 		2.6 - Array Math
 			2.6.1 - Pad
 			2.6.1 - Flip
+
+	3 - Tensor Operations
+		3.1 - Init
+		3.2 - Views
+		3.3 - Copy
+		3.4 - Pad
+
+	4 - Arena Operations
 */
 static void Print1DMatrix(double* Input, int Dim)
 {
@@ -60,6 +69,30 @@ static void Print3DMatrix(double*** Input, int* Dims)
 	printf("\n\n");
 }
 
+static void PrintTensor(Tensor* Input)
+{
+	for(int n = 0; n < Input->Dims[0]; ++n)
+	{
+		printf("Sample %d\n", n + 1);
+
+		for(int i = 0; i < Input->Dims[1]; ++i)
+		{
+			printf("Channel %d\n", i + 1);
+
+			for(int j = 0; j < Input->Dims[2]; ++j)
+			{
+				for(int z = 0; z < Input->Dims[3]; ++z)
+				{
+					printf("%.3f ", TensorAt(Input, n, i, j, z));
+				}
+				printf("\n");
+			}
+			printf("\n");
+		}
+	}
+	printf("\n\n");
+}
+
 
 
 // 1 --- Math Operations --- //
@@ -84,6 +117,101 @@ static void Print3DMatrix(double*** Input, int* Dims)
 			printf("GenerateRandTest Finished\n\n");
 		}
 
+	// 1.2 --- Shuffle --- //
+
+		void ShuffleTest()
+		{
+			printf("Starting ShuffleTest\n\n");
+
+			int Count = 1000;
+			int Shuffles = 1000;
+			uint64_t Seed = 42;
+
+			int* Indices = malloc(sizeof(int) * Count);
+			int* Again = malloc(sizeof(int) * Count);
+			int* Seen = calloc(Count, sizeof(int));
+
+			RandState Rand, Repeat;
+			SeedRand(&Rand, Seed);
+			SeedRand(&Repeat, Seed);
+
+			int Missing = 0;
+			int Mismatches = 0;
+
+			for(int s = 0; s < Shuffles; ++s)
+			{
+				for(int i = 0; i < Count; ++i)
+				{
+					Indices[i] = i;
+					Again[i] = i;
+				}
+
+				ShuffleIndices(&Rand, Indices, Count);
+				ShuffleIndices(&Repeat, Again, Count);
+
+				// --- Every Index exactly once, and the same Permutation for the same Seed --- //
+
+					for(int i = 0; i < Count; ++i)
+					{
+						Seen[Indices[i]] = s + 1;
+						Mismatches += Indices[i] != Again[i];
+					}
+
+					for(int i = 0; i < Count; ++i)
+					{
+						Missing += Seen[i] != s + 1;
+					}
+			}
+
+			// --- Every Index should land in every Position Shuffles / Small times, within 5 Standard Deviations --- //
+
+				int Small = 10;
+				int SmallShuffles = 100000;
+
+				int Positions[Small][Small];
+				memset(Positions, 0, sizeof(Positions));
+
+				for(int s = 0; s < SmallShuffles; ++s)
+				{
+					for(int i = 0; i < Small; ++i)
+					{
+						Indices[i] = i;
+					}
+
+					ShuffleIndices(&Rand, Indices, Small);
+
+					for(int p = 0; p < Small; ++p)
+					{
+						++Positions[Indices[p]][p];
+					}
+				}
+
+				// Binomial, SmallShuffles Draws with Probability 1 / Small
+				double Mean = (double) SmallShuffles / Small;
+				double Variance = Mean * (1 - 1.0 / Small);
+
+				int Biased = 0;
+
+				for(int i = 0; i < Small; ++i)
+				{
+					for(int p = 0; p < Small; ++p)
+					{
+						double Deviation = Positions[i][p] - Mean;
+						Biased += Deviation * Deviation > 25 * Variance;
+					}
+				}
+
+			printf("Missing Indices = %d\n", Missing);
+			printf("Mismatches = %d\n", Mismatches);
+			printf("Biased Positions = %d\n", Biased);
+
+			free(Indices);
+			free(Again);
+			free(Seen);
+
+			printf("ShuffleTest Finished\n\n");
+		}
+
 // 2 --- Array Operations --- //
 
 	// 2.1 --- Init  --- //
@@ -529,3 +657,280 @@ static void Print3DMatrix(double*** Input, int* Dims)
 
 				printf("Flip Test Complete\n\n");
 			}
+
+// 3 --- Tensor Operations --- //
+
+	// 3.1 --- Init --- //
+
+		void InitTensorTest()
+		{
+			printf("Starting InitTensor Test\n\n");
+
+			double DimMin = 1;
+			double DimMax = 5;
+
+			int Samples = GenerateRand(DimMin, DimMax);
+			int Dims[3];
+			for(int i = 0; i < 3; ++i)
+			{
+				Dims[i] = GenerateRand(DimMin, DimMax);
+			}
+
+			Tensor Input = InitTensor(Samples, Dims);
+
+			printf("Initialized Tensor (%d, %d, %d, %d):\n", Samples, Dims[0], Dims[1], Dims[2]);
+			PrintTensor(&Input);
+
+			if(((size_t) Input.Data) % TensorAlignment != 0)
+			{
+				printf("Tensor Data is not aligned to %d bytes!\n", TensorAlignment);
+			}
+
+			FreeTensor(&Input);
+
+			printf("InitTensor Test Complete\n\n");
+		}
+
+	// 3.2 --- Views --- //
+
+		void TensorViewTest()
+		{
+			printf("Starting TensorView Test\n\n");
+
+			double RandMin = -25;
+			double RandMax = 25;
+
+			double DimMin = 1;
+			double DimMax = 5;
+
+			int Dims[3];
+			for(int i = 0; i < 3; ++i)
+			{
+				Dims[i] = GenerateRand(DimMin, DimMax);
+			}
+
+			// A View over an Init3D Volume has to see the same values as the Volume itself
+			double*** Input = Init3D(Dims);
+			RandomizeArray3D(Input, Dims, RandMin, RandMax);
+
+			Tensor InputView = ViewTensor(Input[0][0], 1, Dims);
+
+			printf("Input (%d, %d, %d):\n", Dims[0], Dims[1], Dims[2]);
+			Print3DMatrix(Input, Dims);
+			printf("View:\n");
+			PrintTensor(&InputView);
+
+			// A Flattened View has to see the same values as ConvertTo1D
+			double* Input1D = Init1D(Dims[0] * Dims[1] * Dims[2]);
+			ConvertTo1D(Input, Input1D, Dims);
+
+			Tensor Flat = FlattenTensor(&InputView);
+			Compare1D(TensorRow(&Flat, 0, 0, 0), Input1D, SampleSize(&Flat), 0);
+
+			// Every Sample View of a Batch has to start at its own Volume
+			int Samples = 3;
+			Tensor Batch = InitTensor(Samples, Dims);
+			RandomizeTensor(&Batch, RandMin, RandMax);
+
+			Tensor Last = SampleView(&Batch, Samples - 1);
+			printf("Last Sample of Batch:\n");
+			PrintTensor(&Last);
+
+			if(&TensorAt(&Last, 0, 0, 0, 0) != &TensorAt(&Batch, Samples - 1, 0, 0, 0))
+			{
+				printf("SampleView points to the wrong Volume!\n");
+			}
+
+			// Freeing Views leaves the Data untouched
+			FreeTensor(&InputView);
+			FreeTensor(&Flat);
+			FreeTensor(&Last);
+
+			Free3D(Input);
+			Free1D(Input1D);
+			FreeTensor(&Batch);
+
+			printf("TensorView Test Complete\n\n");
+		}
+
+	// 3.3 --- Copy --- //
+
+		void CopyTensorTest()
+		{
+			printf("Starting CopyTensor Test\n\n");
+
+			double RandMin = -25;
+			double RandMax = 25;
+
+			double DimMin = 1;
+			double DimMax = 5;
+
+			int Samples = GenerateRand(DimMin, DimMax);
+			int Dims[3];
+			for(int i = 0; i < 3; ++i)
+			{
+				Dims[i] = GenerateRand(DimMin, DimMax);
+			}
+
+			Tensor Input = InitTensor(Samples, Dims);
+			Tensor Output = InitTensor(Samples, Dims);
+
+			RandomizeTensor(&Input, RandMin, RandMax);
+			CopyTensor(&Input, &Output);
+
+			printf("Input (%d, %d, %d, %d) [%.2f, %.2f]:\n", Samples, Dims[0], Dims[1], Dims[2], RandMin, RandMax);
+			PrintTensor(&Input);
+			printf("Output:\n");
+			PrintTensor(&Output);
+
+			CompareTensor(&Input, &Output, 0);
+
+			ZeroTensor(&Output);
+			printf("Output after Zero:\n");
+			PrintTensor(&Output);
+
+			FreeTensor(&Input);
+			FreeTensor(&Output);
+
+			printf("CopyTensor Test Complete\n\n");
+		}
+
+	// 3.4 --- Pad --- //
+
+		void PadTensorTest()
+		{
+			printf("Starting PadTensor Test\n\n");
+
+			double MinPixels = 1;
+			double MaxPixels = 5;
+			int Pixels = GenerateRand(MinPixels, MaxPixels);
+
+			double RandMin = -100;
+			double RandMax = 100;
+
+			double DimMin = 1;
+			double DimMax = 5;
+			int InDims[3];
+			int OutDims[3];
+			for(int i = 0; i < 2; ++i)
+			{
+				InDims[i] = GenerateRand(DimMin, DimMax);
+			}
+			InDims[2] = InDims[1];
+			OutDims[0] = InDims[0];
+			OutDims[1] = InDims[1] + 2*Pixels;
+			OutDims[2] = InDims[2] + 2*Pixels;
+
+			// PadTensor has to match Pad
+			double*** Input = Init3D(InDims);
+			double*** Output = Init3D(OutDims);
+
+			RandomizeArray3D(Input, InDims, RandMin, RandMax);
+			Pad(Input, Output, InDims, Pixels);
+
+			Tensor InputView = ViewTensor(Input[0][0], 1, InDims);
+			Tensor Padded = InitTensor(1, OutDims);
+			PadTensor(&InputView, &Padded, Pixels);
+
+			printf("Pixels = %d\n", Pixels);
+			printf("Input (%d, %d, %d) :\n", InDims[0], InDims[1], InDims[2]);
+			PrintTensor(&InputView);
+			printf("Output (%d, %d, %d) :\n", OutDims[0], OutDims[1], OutDims[2]);
+			PrintTensor(&Padded);
+
+			Tensor OutputView = ViewTensor(Output[0][0], 1, OutDims);
+			CompareTensor(&Padded, &OutputView, 0);
+
+			Free3D(Input);
+			Free3D(Output);
+			FreeTensor(&Padded);
+
+			printf("PadTensor Test Complete\n\n");
+		}
+
+// 4 --- Arena Operations --- //
+
+	void ArenaTest()
+	{
+		printf("Starting Arena Test\n\n");
+
+		double RandMin = -25;
+		double RandMax = 25;
+
+		double DimMin = 1;
+		double DimMax = 5;
+
+		int Samples = GenerateRand(DimMin, DimMax);
+		int Dims[3];
+		for(int i = 0; i < 3; ++i)
+		{
+			Dims[i] = GenerateRand(DimMin, DimMax);
+		}
+
+		Arena Space = {0};
+
+		// --- Too small: Tensors come from the Heap, and the Arena grows once empty --- //
+
+			Tensor First = ArenaTensor(&Space, Samples, Dims);
+			Tensor Second = ArenaTensor(&Space, Samples, Dims);
+
+			if(First.Owner != 1 || Second.Owner != 1)
+			{
+				printf("Empty Arena handed out its own Memory!\n");
+			}
+
+			FreeTensor(&Second);
+			FreeTensor(&First);
+			ReleaseArena(&Space, 0);
+
+			if(Space.Size < 2 * ArenaDoubles(Samples, Dims))
+			{
+				printf("Arena did not grow to %zu Doubles, has %zu!\n", 2 * ArenaDoubles(Samples, Dims), Space.Size);
+			}
+
+		// --- Big enough: Tensors are aligned Views, handed out one after the other --- //
+
+			First = ArenaTensor(&Space, Samples, Dims);
+
+			size_t Mark = Space.Used;
+			Second = ArenaTensor(&Space, Samples, Dims);
+
+			if(First.Owner != 0 || Second.Owner != 0 || Second.Data != First.Data + ArenaDoubles(Samples, Dims))
+			{
+				printf("Arena Tensors are not consecutive Views!\n");
+			}
+			if(((size_t) Second.Data) % TensorAlignment != 0)
+			{
+				printf("Arena Tensor Data is not aligned to %d bytes!\n", TensorAlignment);
+			}
+
+			// Releasing to a Mark gives the same Memory back
+			RandomizeTensor(&First, RandMin, RandMax);
+			ReleaseArena(&Space, Mark);
+
+			Tensor Third = ArenaTensor(&Space, Samples, Dims);
+			if(Third.Data != Second.Data)
+			{
+				printf("Released Memory was not reused!\n");
+			}
+
+			// Tensors below the Mark are untouched
+			Tensor Copy = InitTensor(Samples, Dims);
+			CopyTensor(&First, &Copy);
+			RandomizeTensor(&Third, RandMin, RandMax);
+			CompareTensor(&First, &Copy, 0);
+
+			FreeTensor(&Copy);
+			ReleaseArena(&Space, 0);
+
+		// --- Every Thread has its own Scratch Arena --- //
+
+			if(ScratchArena() != ScratchArena())
+			{
+				printf("Scratch Arena changed between calls!\n");
+			}
+
+		FreeArena(&Space);
+
+		printf("Arena Test Complete\n\n");
+	}
@@ -14,5 +14,6 @@
 		void ToggleDebugMode();
 		void Print1DMatrix(double* Input, int Dim);
 		void Print3DMatrix(double*** Input, int* Dims);
+		void PrintTensor(Tensor* Input);
 
 #endif
@@ -8,4 +8,8 @@
 		#include <time.h>
 		#include <unistd.h>
 
+	// 2 --- Other Libs --- //
+
+		#include "../../DataManagement/DataManagement.h"
+
 #endif
@@ -12,6 +12,7 @@
     3 - Print 
    		3.1 - 1D
    		3.2 - 3D
+   		3.3 - Tensor
 
    	4 - SetRandomSeed
 */
@@ -127,4 +128,38 @@
 			printf("\n\n");
 		}
 
+	// 3.3 --- Tensor --- //
+
+		/*
+			Prints every Volume of a Tensor
+
+            Input - Input Tensor
+            
+            Return Value - Nothing.
+        */
+
+		void PrintTensor(Tensor* Input)
+		{
+			for(int n = 0; n < Input->Dims[0]; ++n)
+			{
+				printf("Sample %d\n", n + 1);
+
+				for(int i = 0; i < Input->Dims[1]; ++i)
+				{
+					printf("Channel %d\n", i + 1);
+
+					for(int j = 0; j < Input->Dims[2]; ++j)
+					{
+						for(int z = 0; z < Input->Dims[3]; ++z)
+						{
+							printf("%.3f ", TensorAt(Input, n, i, j, z));
+						}
+						printf("\n");
+					}
+					printf("\n");
+				}
+			}
+			printf("\n\n");
+		}
+
 // 4 --- 
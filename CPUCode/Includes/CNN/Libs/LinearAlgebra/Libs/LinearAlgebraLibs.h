@@ -0,0 +1,14 @@
+#ifndef LINEARALGEBRALIBS_DEFINED
+#define LINEARALGEBRALIBS_DEFINED
+
+	// 1 --- Standart Libs --- //
+
+		#include <stdio.h>
+		#include <stdlib.h>
+		#include <string.h>
+
+	// 2 --- Other Libs --- //
+
+		#include "../../DataManagement/DataManagement.h"
+
+#endif
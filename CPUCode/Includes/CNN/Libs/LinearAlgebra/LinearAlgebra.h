@@ -0,0 +1,42 @@
+#ifndef LINEARALGEBRA_DEFINED
+#define LINEARALGEBRA_DEFINED
+
+	// 1 --- Required Libs --- //
+
+		#include "Libs/LinearAlgebraLibs.h"
+
+	// 2 --- Gemm Blocking --- //
+
+		// 2.1 --- Register Blocking --- //
+
+			#define GemmMR 4				// Rows of C computed at once by the Micro Kernel
+			#define GemmNR 8				// Columns of C computed at once by the Micro Kernel
+
+		// 2.2 --- Cache Blocking --- //
+
+			#define GemmMC 96				// Rows of A kept in L2
+			#define GemmKC 256				// Shared dimension kept in L1 / L2
+			#define GemmNC 2048				// Columns of B kept in L3
+
+		// 2.3 --- Packing --- //
+
+			#define GemmScratch (GemmMC * GemmKC + GemmKC * (GemmNC + GemmNR))	// Doubles of Scratch Arena a Gemm call takes
+
+	// 3 --- Transpose Flags --- //
+
+			#define NoTrans 'N'
+			#define Trans 'T'
+
+	// 4 --- Function Prototypes --- //
+
+			void Gemm(char TransA, char TransB, int M, int N, int K,
+					  double Alpha, double* A, int LdA,
+					  double* B, int LdB,
+					  double Beta, double* C, int LdC);
+
+			void Gemv(char TransA, int M, int N,
+					  double Alpha, double* A, int LdA,
+					  double* X,
+					  double Beta, double* Y);
+
+#endif
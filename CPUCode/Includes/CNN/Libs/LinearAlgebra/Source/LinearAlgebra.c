@@ -0,0 +1,650 @@
+#include "../LinearAlgebra.h"
+
+/*
+            File Structure
+
+	1 - Global Variables
+
+	2 - Packing
+		2.1 - Pack A
+		2.2 - Pack B
+
+	3 - Micro Kernel
+		3.1 - Store Tile
+		3.2 - SSE2
+		3.3 - AVX2
+		3.4 - Select
+
+	4 - Gemm
+		4.1 - Scale C
+		4.2 - Gemm
+
+	5 - Gemv
+		5.1 - Rows
+		5.2 - Columns
+		5.3 - Gemv
+*/
+
+// 1 --- Global Variables --- //
+
+	// 2 and 4 doubles handled as a single value. They map to one SSE2 / AVX register
+	typedef double GemmVector2 __attribute__ ((vector_size (16)));
+	typedef double GemmVector4 __attribute__ ((vector_size (32)));
+
+	// Same as GemmVector4, loaded from any double. Gemv reads A and X in place, without packing
+	typedef double GemvVector4 __attribute__ ((vector_size (32), aligned (8)));
+
+	// Micro Kernel picked for this CPU on the first call to Gemm. GemmOnce makes the pick once, even when the first calls run on a Thread Pool
+	static pthread_once_t GemmOnce = PTHREAD_ONCE_INIT;
+	static void (*GemmKernel)(int Depth, double* A, double* B, double Alpha, double* C, int LdC, int Rows, int Cols);
+
+	// Gemv Kernels, picked with the Gemm one
+	static void (*GemvRowsKernel)(int M, int N, double Alpha, double* A, int LdA, double* X, double* Y);
+	static void (*GemvColsKernel)(int M, int N, double Alpha, double* A, int LdA, double* X, double* Y);
+
+// 2 --- Packing --- //
+
+	// 2.1 --- Pack A --- //
+
+		/*
+			Copy a Block of op(A) into GemmMR Row Panels, stored Column by Column.
+			Rows past the end of A are filled with 0, so the Micro Kernel never needs edge checks
+
+            TransA - NoTrans or Trans
+            Rows - Rows of the Block
+            Depth - Columns of the Block
+            A - First element of the Block
+            LdA - Elements between consecutive Rows of A (as stored)
+            Packed - Destination
+
+            Return Value - Nothing
+        */
+
+		static void PackA(char TransA, int Rows, int Depth, double* A, int LdA, double* Packed)
+		{
+			for(int Panel = 0; Panel < Rows; Panel += GemmMR)
+			{
+				for(int p = 0; p < Depth; ++p)
+				{
+					for(int i = 0; i < GemmMR; ++i)
+					{
+						if(Panel + i < Rows)
+						{
+							*Packed = TransA == Trans ? A[p * LdA + Panel + i] : A[(Panel + i) * LdA + p];
+						}
+						else
+						{
+							*Packed = 0;
+						}
+						++Packed;
+					}
+				}
+			}
+		}
+
+	// 2.2 --- Pack B --- //
+
+		/*
+			Copy a Block of op(B) into GemmNR Column Panels, stored Row by Row.
+			Columns past the end of B are filled with 0
+
+            TransB - NoTrans or Trans
+            Depth - Rows of the Block
+            Cols - Columns of the Block
+            B - First element of the Block
+            LdB - Elements between consecutive Rows of B (as stored)
+            Packed - Destination
+
+            Return Value - Nothing
+        */
+
+		static void PackB(char TransB, int Depth, int Cols, double* B, int LdB, double* Packed)
+		{
+			for(int Panel = 0; Panel < Cols; Panel += GemmNR)
+			{
+				for(int p = 0; p < Depth; ++p)
+				{
+					for(int j = 0; j < GemmNR; ++j)
+					{
+						if(Panel + j < Cols)
+						{
+							*Packed = TransB == Trans ? B[(Panel + j) * LdB + p] : B[p * LdB + Panel + j];
+						}
+						else
+						{
+							*Packed = 0;
+						}
+						++Packed;
+					}
+				}
+			}
+		}
+
+// 3 --- Micro Kernel --- //
+
+	// 3.1 --- Store Tile --- //
+
+		/*
+			Add the valid part of a GemmMR x GemmNR Tile to C
+
+	        Tile - Tile computed by a Micro Kernel
+	        Alpha - Scale of the Product
+	        C - First element of the C Tile
+	        LdC - Elements between consecutive Rows of C
+	        Rows - Valid Rows of the Tile
+	        Cols - Valid Columns of the Tile
+
+	        Return Value - Nothing
+	    */
+
+		static void StoreTile(double Tile[GemmMR][GemmNR], double Alpha, double* C, int LdC, int Rows, int Cols)
+		{
+			for(int i = 0; i < Rows; ++i)
+			{
+				for(int j = 0; j < Cols; ++j)
+				{
+					C[i * LdC + j] += Alpha * Tile[i][j];
+				}
+			}
+		}
+
+	// 3.2 --- SSE2 --- //
+
+		/*
+			Multiply a GemmMR Row Panel of A by a GemmNR Column Panel of B, keeping the
+			Result in Registers, and add it to C. 16 SSE2 registers only fit half the Tile,
+			so the Panel is done in two GemmMR x 4 halves.
+
+	        Depth - Shared Dimension
+	        A - Packed A Panel
+	        B - Packed B Panel
+	        Alpha - Scale of the Product
+	        C - First element of the C Tile
+	        LdC - Elements between consecutive Rows of C
+	        Rows - Valid Rows of the Tile
+	        Cols - Valid Columns of the Tile
+
+	        Return Value - Nothing
+	    */
+
+		static void GemmKernelSse(int Depth, double* A, double* B, double Alpha, double* C, int LdC, int Rows, int Cols)
+		{
+			double Tile[GemmMR][GemmNR] __attribute__ ((aligned (32)));
+
+			for(int Half = 0; Half < GemmNR; Half += 4)
+			{
+				GemmVector2 C00 = {0}, C01 = {0};
+				GemmVector2 C10 = {0}, C11 = {0};
+				GemmVector2 C20 = {0}, C21 = {0};
+				GemmVector2 C30 = {0}, C31 = {0};
+
+				double* a = A;
+				double* b = B + Half;
+
+				for(int p = 0; p < Depth; ++p)
+				{
+					GemmVector2 B0 = *((GemmVector2*) (b));
+					GemmVector2 B1 = *((GemmVector2*) (b + 2));
+
+					C00 += a[0] * B0;	C01 += a[0] * B1;
+					C10 += a[1] * B0;	C11 += a[1] * B1;
+					C20 += a[2] * B0;	C21 += a[2] * B1;
+					C30 += a[3] * B0;	C31 += a[3] * B1;
+
+					a += GemmMR;
+					b += GemmNR;
+				}
+
+				*((GemmVector2*) &Tile[0][Half]) = C00;	*((GemmVector2*) &Tile[0][Half + 2]) = C01;
+				*((GemmVector2*) &Tile[1][Half]) = C10;	*((GemmVector2*) &Tile[1][Half + 2]) = C11;
+				*((GemmVector2*) &Tile[2][Half]) = C20;	*((GemmVector2*) &Tile[2][Half + 2]) = C21;
+				*((GemmVector2*) &Tile[3][Half]) = C30;	*((GemmVector2*) &Tile[3][Half + 2]) = C31;
+			}
+
+			StoreTile(Tile, Alpha, C, LdC, Rows, Cols);
+		}
+
+	// 3.3 --- AVX2 --- //
+
+		/*
+			Same as 3.2, with the whole GemmMR x GemmNR Tile held in 8 AVX registers.
+			Compiled for AVX2 + FMA regardless of the build flags, only called when the CPU has them.
+
+	        Return Value - Nothing
+	    */
+
+	#if defined(__x86_64__) || defined(__i386__)
+
+		__attribute__ ((target ("avx2,fma")))
+		static void GemmKernelAvx(int Depth, double* A, double* B, double Alpha, double* C, int LdC, int Rows, int Cols)
+		{
+			GemmVector4 C00 = {0}, C01 = {0};
+			GemmVector4 C10 = {0}, C11 = {0};
+			GemmVector4 C20 = {0}, C21 = {0};
+			GemmVector4 C30 = {0}, C31 = {0};
+
+			for(int p = 0; p < Depth; ++p)
+			{
+				GemmVector4 B0 = *((GemmVector4*) (B));
+				GemmVector4 B1 = *((GemmVector4*) (B + 4));
+
+				C00 += A[0] * B0;	C01 += A[0] * B1;
+				C10 += A[1] * B0;	C11 += A[1] * B1;
+				C20 += A[2] * B0;	C21 += A[2] * B1;
+				C30 += A[3] * B0;	C31 += A[3] * B1;
+
+				A += GemmMR;
+				B += GemmNR;
+			}
+
+			double Tile[GemmMR][GemmNR] __attribute__ ((aligned (32)));
+
+			*((GemmVector4*) &Tile[0][0]) = C00;	*((GemmVector4*) &Tile[0][4]) = C01;
+			*((GemmVector4*) &Tile[1][0]) = C10;	*((GemmVector4*) &Tile[1][4]) = C11;
+			*((GemmVector4*) &Tile[2][0]) = C20;	*((GemmVector4*) &Tile[2][4]) = C21;
+			*((GemmVector4*) &Tile[3][0]) = C30;	*((GemmVector4*) &Tile[3][4]) = C31;
+
+			StoreTile(Tile, Alpha, C, LdC, Rows, Cols);
+		}
+
+	#endif
+
+	// 3.4 --- Select --- //
+
+		// Gemv Kernels, defined in 5
+		static void GemvRowsSse(int M, int N, double Alpha, double* A, int LdA, double* X, double* Y);
+		static void GemvColsSse(int M, int N, double Alpha, double* A, int LdA, double* X, double* Y);
+
+	#if defined(__x86_64__) || defined(__i386__)
+
+		static void GemvRowsAvx(int M, int N, double Alpha, double* A, int LdA, double* X, double* Y);
+		static void GemvColsAvx(int M, int N, double Alpha, double* A, int LdA, double* X, double* Y);
+
+	#endif
+
+		/*
+			Pick the widest Gemm and Gemv Kernels this CPU supports
+
+	        Return Value - Nothing
+	    */
+
+		static void SelectGemmKernel()
+		{
+			GemvRowsKernel = GemvRowsSse;
+			GemvColsKernel = GemvColsSse;
+			GemmKernel = GemmKernelSse;
+
+			#if defined(__x86_64__) || defined(__i386__)
+
+				__builtin_cpu_init();
+
+				if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+				{
+					GemvRowsKernel = GemvRowsAvx;
+					GemvColsKernel = GemvColsAvx;
+					GemmKernel = GemmKernelAvx;
+				}
+
+			#endif
+		}
+
+// 4 --- Gemm --- //
+
+	// 4.1 --- Scale C --- //
+
+		/*
+			C = Beta * C. Beta = 0 clears C, so old NaNs don't leak into the Result
+
+            M - Rows of C
+            N - Columns of C
+            Beta - Scale
+            C - Matrix
+            LdC - Elements between consecutive Rows of C
+
+            Return Value - Nothing
+        */
+
+		static void ScaleC(int M, int N, double Beta, double* C, int LdC)
+		{
+			if(Beta == 1)
+			{
+				return;
+			}
+
+			for(int i = 0; i < M; ++i)
+			{
+				if(Beta == 0)
+				{
+					memset(C + i * LdC, 0, N * sizeof(double));
+					continue;
+				}
+
+				for(int j = 0; j < N; ++j)
+				{
+					C[i * LdC + j] *= Beta;
+				}
+			}
+		}
+
+	// 4.2 --- Gemm --- //
+
+		/*
+			General Matrix Multiply, Row Major.
+
+			C = Alpha * op(A) * op(B) + Beta * C
+
+			op(A) is M x K, op(B) is K x N, C is M x N.
+			B is split in GemmKC x GemmNC Blocks, A in GemmMC x GemmKC Blocks. Both are packed so
+			the Micro Kernel streams through contiguous memory.
+
+            TransA - NoTrans: A is stored M x K. Trans: A is stored K x M
+            TransB - NoTrans: B is stored K x N. Trans: B is stored N x K
+            M, N, K - Dimensions
+            Alpha - Scale of the Product
+            A - Matrix A
+            LdA - Elements between consecutive Rows of A (as stored)
+            B - Matrix B
+            LdB - Elements between consecutive Rows of B (as stored)
+            Beta - Scale of C before adding the Product
+            C - Matrix C
+            LdC - Elements between consecutive Rows of C
+
+            Return Value - Nothing
+        */
+
+		void Gemm(char TransA, char TransB, int M, int N, int K,
+				  double Alpha, double* A, int LdA,
+				  double* B, int LdB,
+				  double Beta, double* C, int LdC)
+		{
+			ScaleC(M, N, Beta, C, LdC);
+
+			if(M == 0 || N == 0 || K == 0 || Alpha == 0)
+			{
+				return;
+			}
+
+			pthread_once(&GemmOnce, SelectGemmKernel);
+
+			// --- Packing Buffers --- //
+
+				// Taken from the Scratch Arena of this Thread, so Gemm calls inside Tasks don't allocate
+				Arena* Space = ScratchArena();
+				size_t Mark = Space->Used;
+
+				int PackADims[3] = {1, GemmMC, GemmKC};
+				int PackBDims[3] = {1, GemmKC, GemmNC + GemmNR};
+
+				Tensor PackedATensor = ArenaTensor(Space, 1, PackADims);
+				Tensor PackedBTensor = ArenaTensor(Space, 1, PackBDims);
+
+				if(PackedATensor.Data == NULL || PackedBTensor.Data == NULL)
+				{
+					printf("Memory Allocation Error.\n");
+					exit(-5);						// MemoryError
+				}
+
+				double* PackedA = PackedATensor.Data;
+				double* PackedB = PackedBTensor.Data;
+
+			// --- Blocked Product --- //
+
+				for(int jc = 0; jc < N; jc += GemmNC)
+				{
+					int NC = N - jc < GemmNC ? N - jc : GemmNC;
+
+					for(int pc = 0; pc < K; pc += GemmKC)
+					{
+						int KC = K - pc < GemmKC ? K - pc : GemmKC;
+
+						PackB(TransB, KC, NC, TransB == Trans ? B + jc * LdB + pc : B + pc * LdB + jc, LdB, PackedB);
+
+						for(int ic = 0; ic < M; ic += GemmMC)
+						{
+							int MC = M - ic < GemmMC ? M - ic : GemmMC;
+
+							PackA(TransA, MC, KC, TransA == Trans ? A + pc * LdA + ic : A + ic * LdA + pc, LdA, PackedA);
+
+							// Go Through the Block one Register Tile at a time
+							for(int jr = 0; jr < NC; jr += GemmNR)
+							{
+								for(int ir = 0; ir < MC; ir += GemmMR)
+								{
+									GemmKernel(KC, PackedA + ir * KC, PackedB + jr * KC, Alpha,
+											   C + (ic + ir) * LdC + jc + jr, LdC,
+											   MC - ir < GemmMR ? MC - ir : GemmMR,
+											   NC - jr < GemmNR ? NC - jr : GemmNR);
+								}
+							}
+						}
+					}
+				}
+
+			// --- Free --- //
+
+				FreeTensor(&PackedBTensor);
+				FreeTensor(&PackedATensor);
+				ReleaseArena(Space, Mark);
+		}
+
+// 5 --- Gemv --- //
+
+	// 5.1 --- Rows --- //
+
+		/*
+			Y += Alpha * A * X, with A stored M x N. Each Y is the Dot Product of a contiguous Row of A with X,
+			so 4 Rows are done at once and every load of X is shared between them.
+			Inlined into one Kernel per Instruction Set, the Vectors map to 2 SSE2 or 1 AVX register
+
+            M - Rows of A
+            N - Columns of A
+            Alpha - Scale of the Product
+            A - Matrix A
+            LdA - Elements between consecutive Rows of A
+            X - Vector of N
+            Y - Vector of M
+
+            Return Value - Nothing
+        */
+
+		static inline __attribute__ ((always_inline)) void GemvRows(int M, int N, double Alpha, double* A, int LdA, double* X, double* Y)
+		{
+			int Tail = N - N % 4;
+			int i = 0;
+
+			for(; i + 4 <= M; i += 4)
+			{
+				double* A0 = A + i * LdA;
+				double* A1 = A0 + LdA;
+				double* A2 = A1 + LdA;
+				double* A3 = A2 + LdA;
+
+				GemmVector4 S0 = {0}, S1 = {0}, S2 = {0}, S3 = {0};
+
+				for(int j = 0; j < Tail; j += 4)
+				{
+					GemmVector4 x = *((GemvVector4*) (X + j));
+
+					S0 += *((GemvVector4*) (A0 + j)) * x;
+					S1 += *((GemvVector4*) (A1 + j)) * x;
+					S2 += *((GemvVector4*) (A2 + j)) * x;
+					S3 += *((GemvVector4*) (A3 + j)) * x;
+				}
+
+				double Sum0 = S0[0] + S0[1] + S0[2] + S0[3];
+				double Sum1 = S1[0] + S1[1] + S1[2] + S1[3];
+				double Sum2 = S2[0] + S2[1] + S2[2] + S2[3];
+				double Sum3 = S3[0] + S3[1] + S3[2] + S3[3];
+
+				for(int j = Tail; j < N; ++j)
+				{
+					Sum0 += A0[j] * X[j];
+					Sum1 += A1[j] * X[j];
+					Sum2 += A2[j] * X[j];
+					Sum3 += A3[j] * X[j];
+				}
+
+				Y[i] += Alpha * Sum0;
+				Y[i + 1] += Alpha * Sum1;
+				Y[i + 2] += Alpha * Sum2;
+				Y[i + 3] += Alpha * Sum3;
+			}
+
+			// Rows left over
+			for(; i < M; ++i)
+			{
+				double* Row = A + i * LdA;
+
+				GemmVector4 S = {0};
+
+				for(int j = 0; j < Tail; j += 4)
+				{
+					S += *((GemvVector4*) (Row + j)) * *((GemvVector4*) (X + j));
+				}
+
+				double Sum = S[0] + S[1] + S[2] + S[3];
+
+				for(int j = Tail; j < N; ++j)
+				{
+					Sum += Row[j] * X[j];
+				}
+
+				Y[i] += Alpha * Sum;
+			}
+		}
+
+		static void GemvRowsSse(int M, int N, double Alpha, double* A, int LdA, double* X, double* Y)
+		{
+			GemvRows(M, N, Alpha, A, LdA, X, Y);
+		}
+
+	#if defined(__x86_64__) || defined(__i386__)
+
+		__attribute__ ((target ("avx2,fma")))
+		static void GemvRowsAvx(int M, int N, double Alpha, double* A, int LdA, double* X, double* Y)
+		{
+			GemvRows(M, N, Alpha, A, LdA, X, Y);
+		}
+
+	#endif
+
+	// 5.2 --- Columns --- //
+
+		/*
+			Y += Alpha * A' * X, with A stored M x N. Each Row of A is scaled by its X and added to all of Y,
+			4 Rows at a time so Y is loaded and stored once for every 4 Rows
+
+            M - Rows of A
+            N - Columns of A
+            Alpha - Scale of the Product
+            A - Matrix A
+            LdA - Elements between consecutive Rows of A
+            X - Vector of M
+            Y - Vector of N
+
+            Return Value - Nothing
+        */
+
+		static inline __attribute__ ((always_inline)) void GemvCols(int M, int N, double Alpha, double* A, int LdA, double* X, double* Y)
+		{
+			int Tail = N - N % 4;
+			int i = 0;
+
+			for(; i + 4 <= M; i += 4)
+			{
+				double* A0 = A + i * LdA;
+				double* A1 = A0 + LdA;
+				double* A2 = A1 + LdA;
+				double* A3 = A2 + LdA;
+
+				double X0 = Alpha * X[i], X1 = Alpha * X[i + 1], X2 = Alpha * X[i + 2], X3 = Alpha * X[i + 3];
+
+				for(int j = 0; j < Tail; j += 4)
+				{
+					*((GemvVector4*) (Y + j)) += X0 * *((GemvVector4*) (A0 + j)) + X1 * *((GemvVector4*) (A1 + j))
+											   + X2 * *((GemvVector4*) (A2 + j)) + X3 * *((GemvVector4*) (A3 + j));
+				}
+
+				for(int j = Tail; j < N; ++j)
+				{
+					Y[j] += X0 * A0[j] + X1 * A1[j] + X2 * A2[j] + X3 * A3[j];
+				}
+			}
+
+			// Rows left over
+			for(; i < M; ++i)
+			{
+				double* Row = A + i * LdA;
+				double Scale = Alpha * X[i];
+
+				for(int j = 0; j < Tail; j += 4)
+				{
+					*((GemvVector4*) (Y + j)) += Scale * *((GemvVector4*) (Row + j));
+				}
+
+				for(int j = Tail; j < N; ++j)
+				{
+					Y[j] += Scale * Row[j];
+				}
+			}
+		}
+
+		static void GemvColsSse(int M, int N, double Alpha, double* A, int LdA, double* X, double* Y)
+		{
+			GemvCols(M, N, Alpha, A, LdA, X, Y);
+		}
+
+	#if defined(__x86_64__) || defined(__i386__)
+
+		__attribute__ ((target ("avx2,fma")))
+		static void GemvColsAvx(int M, int N, double Alpha, double* A, int LdA, double* X, double* Y)
+		{
+			GemvCols(M, N, Alpha, A, LdA, X, Y);
+		}
+
+	#endif
+
+	// 5.3 --- Gemv --- //
+
+		/*
+			General Matrix Vector Multiply, Row Major. Gemm for a single Vector, without packing.
+
+			Y = Alpha * op(A) * X + Beta * Y
+
+			op(A) is M x N.
+
+            TransA - NoTrans: A is stored M x N. Trans: A is stored N x M
+            M, N - Dimensions
+            Alpha - Scale of the Product
+            A - Matrix A
+            LdA - Elements between consecutive Rows of A (as stored)
+            X - Vector of N
+            Beta - Scale of Y before adding the Product
+            Y - Vector of M
+
+            Return Value - Nothing
+        */
+
+		void Gemv(char TransA, int M, int N,
+				  double Alpha, double* A, int LdA,
+				  double* X,
+				  double Beta, double* Y)
+		{
+			ScaleC(1, M, Beta, Y, M);
+
+			if(M == 0 || N == 0 || Alpha == 0)
+			{
+				return;
+			}
+
+			pthread_once(&GemmOnce, SelectGemmKernel);
+
+			if(TransA == Trans)
+			{
+				GemvColsKernel(N, M, Alpha, A, LdA, X, Y);
+			}
+			else
+			{
+				GemvRowsKernel(M, N, Alpha, A, LdA, X, Y);
+			}
+		}
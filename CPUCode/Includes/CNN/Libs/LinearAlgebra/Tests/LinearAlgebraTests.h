@@ -0,0 +1,13 @@
+#ifndef LINEARALGEBRATESTS_DEFINED
+#define LINEARALGEBRATESTS_DEFINED
+
+	// 1 --- Required Libs --- //
+
+		#include "TestLibs/LinearAlgebraTestLibs.h"
+
+	// 2 --- Function Prototypes --- //
+
+		void GemmTest();
+		void GemvTest();
+
+#endif
@@ -0,0 +1,15 @@
+#ifndef LINEARALGEBRATESTLIBS_DEFINED
+#define LINEARALGEBRATESTLIBS_DEFINED
+
+	// 1 --- Standart Libs --- //
+
+		#include <stdio.h>
+		#include <stdlib.h>
+
+	// 2 --- Extra Libs --- //
+
+		#include "../../LinearAlgebra.h"
+		#include "../../../DataManagement/DataManagement.h"
+		#include "../../../Timing/Timing.h"
+
+#endif
@@ -0,0 +1,190 @@
+#include "../LinearAlgebraTests.h"
+
+/*
+            File Structure
+
+	1 - Gemm
+
+	2 - Gemv
+*/
+
+// 1 --- Gemm --- //
+
+	void GemmTest()
+	{
+		printf("Starting Gemm Test\n\n");
+
+		double RandMin = -1;
+		double RandMax = 1;
+
+		double DimMin = 1;
+		double DimMax = 300;
+
+		double Margin = 1e-9;
+
+		char Flags[2] = {NoTrans, Trans};
+
+		// Every Transpose Combination, on Sizes that don't divide the Blocking
+		for(int ta = 0; ta < 2; ++ta)
+		{
+			for(int tb = 0; tb < 2; ++tb)
+			{
+				int M = GenerateRand(DimMin, DimMax);
+				int N = GenerateRand(DimMin, DimMax);
+				int K = GenerateRand(DimMin, DimMax);
+
+				double Alpha = GenerateRand(RandMin, RandMax);
+				double Beta = GenerateRand(RandMin, RandMax);
+
+				double* A = Init1D(M * K);
+				double* B = Init1D(K * N);
+				double* C = Init1D(M * N);
+				double* Reference = Init1D(M * N);
+
+				RandomizeArray1D(A, M * K, RandMin, RandMax);
+				RandomizeArray1D(B, K * N, RandMin, RandMax);
+				RandomizeArray1D(C, M * N, RandMin, RandMax);
+				Copy1D(C, Reference, M * N);
+
+				int LdA = Flags[ta] == Trans ? M : K;
+				int LdB = Flags[tb] == Trans ? K : N;
+
+				// --- Reference Triple Loop --- //
+
+					for(int i = 0; i < M; ++i)
+					{
+						for(int j = 0; j < N; ++j)
+						{
+							double Sum = 0;
+							for(int p = 0; p < K; ++p)
+							{
+								double a = Flags[ta] == Trans ? A[p * LdA + i] : A[i * LdA + p];
+								double b = Flags[tb] == Trans ? B[j * LdB + p] : B[p * LdB + j];
+								Sum += a * b;
+							}
+							Reference[i * N + j] = Alpha * Sum + Beta * Reference[i * N + j];
+						}
+					}
+
+				Gemm(Flags[ta], Flags[tb], M, N, K, Alpha, A, LdA, B, LdB, Beta, C, N);
+
+				printf("TransA = %c, TransB = %c, M = %d, N = %d, K = %d\n", Flags[ta], Flags[tb], M, N, K);
+				Compare1D(C, Reference, M * N, Margin);
+
+				Free1D(A);
+				Free1D(B);
+				Free1D(C);
+				Free1D(Reference);
+			}
+		}
+
+		// --- Throughput --- //
+
+			int Dim = 512;
+
+			double* A = Init1D(Dim * Dim);
+			double* B = Init1D(Dim * Dim);
+			double* C = Init1D(Dim * Dim);
+
+			RandomizeArray1D(A, Dim * Dim, RandMin, RandMax);
+			RandomizeArray1D(B, Dim * Dim, RandMin, RandMax);
+
+			StartTiming();
+			Gemm(NoTrans, NoTrans, Dim, Dim, Dim, 1, A, Dim, B, Dim, 0, C, Dim);
+			double Time = StopTiming();
+
+			printf("%dx%d Gemm: %.2f ms (%.2f GFlops)\n", Dim, Dim, Time/1000, (2.0 * Dim * Dim * Dim)/(Time * 1000));
+
+			Free1D(A);
+			Free1D(B);
+			Free1D(C);
+
+		printf("Gemm Test Complete\n\n");
+	}
+
+// 2 --- Gemv --- //
+
+	void GemvTest()
+	{
+		printf("Starting Gemv Test\n\n");
+
+		double RandMin = -1;
+		double RandMax = 1;
+
+		double DimMin = 1;
+		double DimMax = 300;
+
+		double Margin = 1e-9;
+
+		char Flags[2] = {NoTrans, Trans};
+
+		// Both Transpose Flags, on Sizes that aren't multiples of 4
+		for(int ta = 0; ta < 2; ++ta)
+		{
+			int M = GenerateRand(DimMin, DimMax);
+			int N = GenerateRand(DimMin, DimMax);
+
+			double Alpha = GenerateRand(RandMin, RandMax);
+			double Beta = GenerateRand(RandMin, RandMax);
+
+			double* A = Init1D(M * N);
+			double* X = Init1D(N);
+			double* Y = Init1D(M);
+			double* Reference = Init1D(M);
+
+			RandomizeArray1D(A, M * N, RandMin, RandMax);
+			RandomizeArray1D(X, N, RandMin, RandMax);
+			RandomizeArray1D(Y, M, RandMin, RandMax);
+			Copy1D(Y, Reference, M);
+
+			int LdA = Flags[ta] == Trans ? M : N;
+
+			// --- Reference Double Loop --- //
+
+				for(int i = 0; i < M; ++i)
+				{
+					double Sum = 0;
+					for(int j = 0; j < N; ++j)
+					{
+						Sum += (Flags[ta] == Trans ? A[j * LdA + i] : A[i * LdA + j]) * X[j];
+					}
+					Reference[i] = Alpha * Sum + Beta * Reference[i];
+				}
+
+			Gemv(Flags[ta], M, N, Alpha, A, LdA, X, Beta, Y);
+
+			printf("TransA = %c, M = %d, N = %d\n", Flags[ta], M, N);
+			Compare1D(Y, Reference, M, Margin);
+
+			Free1D(A);
+			Free1D(X);
+			Free1D(Y);
+			Free1D(Reference);
+		}
+
+		// --- Throughput, on an Fcon sized Matrix --- //
+
+			int Dim = 4096;
+
+			double* A = Init1D(Dim * Dim);
+			double* X = Init1D(Dim);
+			double* Y = Init1D(Dim);
+
+			RandomizeArray1D(A, Dim * Dim, RandMin, RandMax);
+			RandomizeArray1D(X, Dim, RandMin, RandMax);
+
+			for(int ta = 0; ta < 2; ++ta)
+			{
+				StartTiming();
+				Gemv(Flags[ta], Dim, Dim, 1, A, Dim, X, 0, Y);
+				double Time = StopTiming();
+
+				printf("TransA = %c, %dx%d Gemv: %.2f ms (%.2f GFlops)\n", Flags[ta], Dim, Dim, Time/1000, (2.0 * Dim * Dim)/(Time * 1000));
+			}
+
+			Free1D(A);
+			Free1D(X);
+			Free1D(Y);
+
+		printf("Gemv Test Complete\n\n");
+	}
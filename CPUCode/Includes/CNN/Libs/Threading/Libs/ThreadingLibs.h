@@ -0,0 +1,10 @@
+#ifndef THREADINGLIBS_DEFINED
+#define THREADINGLIBS_DEFINED
+
+	// 1 --- Standart Libs --- //
+
+		#include <pthread.h>
+		#include <stdio.h>
+		#include <stdlib.h>
+
+#endif
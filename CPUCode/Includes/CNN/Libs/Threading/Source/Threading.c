@@ -0,0 +1,310 @@
+#include "../Threading.h"
+
+/*
+
+			File Structure
+
+	1 - Workers
+		1.1 - Share
+		1.2 - Worker Loop
+
+	2 - Thread Pool
+		2.1 - Create
+		2.2 - Free
+		2.3 - Threads
+
+	3 - Parallel For
+
+*/
+
+// 1 --- Workers --- //
+
+	// --- Global Variables --- //
+
+		static __thread int ThreadIndex = 0;				// Index of the running Thread in its Pool. 0 outside Workers
+
+	// 1.1 --- Share --- //
+
+		/*
+			Run the Share of a Task belonging to a Thread.
+			Items are split in NThreads contiguous ranges, so the same Thread always gets the same Items.
+
+			Pool - Thread Pool
+			Thread - Index of the Thread
+
+			Return Value - Nothing
+		*/
+
+		static void RunShare(ThreadPool* Pool, int Thread)
+		{
+			int Start = (long long) Pool->Items * Thread / Pool->NThreads;
+			int End = (long long) Pool->Items * (Thread + 1) / Pool->NThreads;
+
+			if(Start < End)
+			{
+				Pool->Task(Pool->Args, Start, End, Thread);
+			}
+		}
+
+	// 1.2 --- Worker Loop --- //
+
+		// Arguments of a Worker
+		typedef struct
+		{
+			ThreadPool* Pool;
+			int Thread;
+
+		} WorkerArgs;
+
+		/*
+			Wait for Tasks and run this Worker's Share, until the Pool stops
+
+			Args - WorkerArgs of this Worker. Freed by the Worker
+
+			Return Value - NULL
+		*/
+
+		static void* WorkerLoop(void* Args)
+		{
+			ThreadPool* Pool = ((WorkerArgs*) Args)->Pool;
+			int Thread = ((WorkerArgs*) Args)->Thread;
+			free(Args);
+
+			ThreadIndex = Thread;
+
+			unsigned int Seen = 0;
+
+			pthread_mutex_lock(&(Pool->Lock));
+
+			while(1)
+			{
+				// --- Wait for a Task --- //
+
+					while(Pool->Generation == Seen && !Pool->Stop)
+					{
+						pthread_cond_wait(&(Pool->Wake), &(Pool->Lock));
+					}
+
+					if(Pool->Stop)
+					{
+						break;
+					}
+
+					Seen = Pool->Generation;
+
+				// --- Run Share --- //
+
+					pthread_mutex_unlock(&(Pool->Lock));
+
+					RunShare(Pool, Thread);
+
+					pthread_mutex_lock(&(Pool->Lock));
+
+					if(--Pool->Pending == 0)
+					{
+						pthread_cond_signal(&(Pool->Done));
+					}
+			}
+
+			pthread_mutex_unlock(&(Pool->Lock));
+
+			return NULL;
+		}
+
+// 2 --- Thread Pool --- //
+
+	// 2.1 --- Create --- //
+
+		/*
+			Create a Thread Pool. Workers are started once and wait for Tasks until FreeThreadPool
+
+			NThreads - Threads taking part in each ParallelFor, including the caller
+
+			Return Value - Thread Pool, NULL if NThreads < 2 or it could not be created
+		*/
+
+		ThreadPool* CreateThreadPool(int NThreads)
+		{
+			if(NThreads < 2)
+			{
+				return NULL;
+			}
+
+			ThreadPool* Pool = calloc(1, sizeof(ThreadPool));
+			if(Pool == NULL)
+			{
+				return NULL;
+			}
+
+			Pool->Workers = malloc(sizeof(pthread_t) * (NThreads - 1));
+			if(Pool->Workers == NULL)
+			{
+				free(Pool);
+				return NULL;
+			}
+
+			pthread_mutex_init(&(Pool->Lock), NULL);
+			pthread_cond_init(&(Pool->Wake), NULL);
+			pthread_cond_init(&(Pool->Done), NULL);
+
+			// --- Start Workers --- //
+
+				Pool->NThreads = 1;
+
+				for(int i = 1; i < NThreads; ++i)
+				{
+					WorkerArgs* Args = malloc(sizeof(WorkerArgs));
+
+					if(Args == NULL)
+					{
+						break;
+					}
+
+					Args->Pool = Pool;
+					Args->Thread = i;
+
+					if(pthread_create(&(Pool->Workers[i - 1]), NULL, WorkerLoop, Args) != 0)
+					{
+						free(Args);
+						break;
+					}
+
+					++Pool->NThreads;
+				}
+
+			// Not a single Worker could be started
+			if(Pool->NThreads < 2)
+			{
+				FreeThreadPool(Pool);
+				return NULL;
+			}
+
+			return Pool;
+		}
+
+	// 2.2 --- Free --- //
+
+		/*
+			Stop every Worker and Free a Thread Pool
+
+			Pool - Thread Pool. Can be NULL
+
+			Return Value - Nothing
+		*/
+
+		void FreeThreadPool(ThreadPool* Pool)
+		{
+			if(Pool == NULL)
+			{
+				return;
+			}
+
+			pthread_mutex_lock(&(Pool->Lock));
+			Pool->Stop = 1;
+			pthread_cond_broadcast(&(Pool->Wake));
+			pthread_mutex_unlock(&(Pool->Lock));
+
+			for(int i = 0; i < Pool->NThreads - 1; ++i)
+			{
+				pthread_join(Pool->Workers[i], NULL);
+			}
+
+			pthread_mutex_destroy(&(Pool->Lock));
+			pthread_cond_destroy(&(Pool->Wake));
+			pthread_cond_destroy(&(Pool->Done));
+
+			free(Pool->Workers);
+			free(Pool);
+		}
+
+	// 2.3 --- Threads --- //
+
+		/*
+			Get how many Threads a ParallelFor on a Pool uses
+
+			Pool - Thread Pool. Can be NULL
+
+			Return Value - Threads, 1 if Pool is NULL
+		*/
+
+		int PoolThreads(ThreadPool* Pool)
+		{
+			return Pool == NULL ? 1 : Pool->NThreads;
+		}
+
+// 3 --- Parallel For --- //
+
+	/*
+		Run Task over Items [0, Items) with every Thread of a Pool, and wait for it to finish.
+
+		Thread i always gets Items [Items * i / NThreads, Items * (i + 1) / NThreads).
+		Without a Pool, Task runs serially as Task(Args, 0, Items, 0).
+		Called from inside a Task, it runs serially on the calling Thread, keeping its Thread index.
+		A Pool is meant to be driven by a single Thread.
+
+		Pool - Thread Pool. Can be NULL
+		Items - How many Items to process
+		Task - Function processing a range of Items
+		Args - Passed to Task
+
+		Return Value - Nothing
+	*/
+
+	void ParallelFor(ThreadPool* Pool, int Items, ThreadTask Task, void* Args)
+	{
+		if(Items <= 0)
+		{
+			return;
+		}
+
+		// --- Serial --- //
+
+			char Serial = Pool == NULL || Items == 1;
+
+			if(!Serial)
+			{
+				pthread_mutex_lock(&(Pool->Lock));
+
+				Serial = Pool->Busy;
+				Pool->Busy = 1;
+
+				if(Serial)
+				{
+					pthread_mutex_unlock(&(Pool->Lock));
+				}
+			}
+
+			if(Serial)
+			{
+				Task(Args, 0, Items, ThreadIndex);
+				return;
+			}
+
+		// --- Post Task --- //
+
+			Pool->Task = Task;
+			Pool->Args = Args;
+			Pool->Items = Items;
+			Pool->Pending = Pool->NThreads - 1;
+			++Pool->Generation;
+
+			pthread_cond_broadcast(&(Pool->Wake));
+			pthread_mutex_unlock(&(Pool->Lock));
+
+		// --- Caller Share --- //
+
+			RunShare(Pool, 0);
+
+		// --- Wait for Workers --- //
+
+			pthread_mutex_lock(&(Pool->Lock));
+
+			while(Pool->Pending > 0)
+			{
+				pthread_cond_wait(&(Pool->Done), &(Pool->Lock));
+			}
+
+			Pool->Busy = 0;
+
+			pthread_mutex_unlock(&(Pool->Lock));
+	}
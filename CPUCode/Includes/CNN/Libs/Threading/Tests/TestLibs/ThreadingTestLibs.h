@@ -0,0 +1,13 @@
+#ifndef THREADINGTESTLIBS_DEFINED
+#define THREADINGTESTLIBS_DEFINED
+
+	// 1 --- Standart Libs --- //
+
+		#include <stdio.h>
+		#include <stdlib.h>
+
+	// 2 --- Extra Libs --- //
+
+		#include "../../Threading.h"
+
+#endif
@@ -0,0 +1,80 @@
+#include "../ThreadingTests.h"
+
+/*
+            File Structure
+
+	1 - Parallel For
+
+*/
+
+// 1 --- Parallel For --- //
+
+	// Arguments of the Test Task
+	typedef struct
+	{
+		double* Values;
+		int* Owners;
+
+	} TestArgs;
+
+	// Fill Values with their Index and record which Thread wrote them
+	static void TestTask(void* Args, int Start, int End, int Thread)
+	{
+		TestArgs* Test = Args;
+
+		for(int i = Start; i < End; ++i)
+		{
+			Test->Values[i] = i;
+			Test->Owners[i] = Thread;
+		}
+	}
+
+	void ParallelForTest()
+	{
+		printf("Starting Parallel For Test!\n\n");
+
+		int Items = 1000;
+		int Calls = 1000;
+
+		for(int NThreads = 1; NThreads <= 8; NThreads *= 2)
+		{
+			ThreadPool* Pool = CreateThreadPool(NThreads);
+
+			TestArgs Test;
+			Test.Values = calloc(Items, sizeof(double));
+			Test.Owners = calloc(Items, sizeof(int));
+
+			int Errors = 0;
+
+			// Many short Tasks, to check Workers are reused
+			for(int Call = 0; Call < Calls; ++Call)
+			{
+				ParallelFor(Pool, Items, TestTask, &Test);
+
+				for(int i = 0; i < Items; ++i)
+				{
+					// Every Item has to be done, by the Thread that owns its range
+					int Owner = 0;
+					while((long long) Items * (Owner + 1) / PoolThreads(Pool) <= i)
+					{
+						++Owner;
+					}
+
+					if(Test.Values[i] != i || Test.Owners[i] != Owner)
+					{
+						++Errors;
+					}
+
+					Test.Values[i] = -1;
+				}
+			}
+
+			printf("Threads = %d, Errors = %d\n", PoolThreads(Pool), Errors);
+
+			free(Test.Values);
+			free(Test.Owners);
+			FreeThreadPool(Pool);
+		}
+
+		printf("Parallel For Test Complete!\n\n");
+	}
@@ -0,0 +1,12 @@
+#ifndef THREADINGTESTS_DEFINED
+#define THREADINGTESTS_DEFINED
+
+	// 1 --- Required Libs --- //
+
+		#include "TestLibs/ThreadingTestLibs.h"
+
+	// 2 --- Function Prototypes --- //
+
+		void ParallelForTest();
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef THREADING_DEFINED
+#define THREADING_DEFINED
+
+	// 1 --- Required Libs --- //
+
+		#include "Libs/ThreadingLibs.h"
+
+	// 2 --- Structures --- //
+
+		// 2.1 --- Task --- //
+
+			// Processes Items [Start, End) of a ParallelFor. Thread is the index of the calling Thread, 0 being the caller
+			typedef void (*ThreadTask)(void* Args, int Start, int End, int Thread);
+
+		// 2.2 --- Thread Pool --- //
+
+			typedef struct
+			{
+				pthread_t* Workers;			// NThreads - 1 Workers. The Thread calling ParallelFor does the first share
+				int NThreads;				// Threads taking part in a ParallelFor, including the caller
+
+				pthread_mutex_t Lock;		// Protects everything below
+				pthread_cond_t Wake;		// Signaled when a new Task is posted or the Pool stops
+				pthread_cond_t Done;		// Signaled when the last Worker finishes its share
+
+				ThreadTask Task;			// Current Task
+				void* Args;					// Arguments of the current Task
+				int Items;					// Items of the current Task
+
+				unsigned int Generation;	// Incremented for every posted Task
+				int Pending;				// Workers still running the current Task
+				char Busy;					// 1 while a Task runs. Nested ParallelFors run serially
+				char Stop;					// 1 when Workers have to exit
+
+			} ThreadPool;
+
+	// 3 --- Function Prototypes --- //
+
+		ThreadPool* CreateThreadPool(int NThreads);
+		void FreeThreadPool(ThreadPool* Pool);
+
+		int PoolThreads(ThreadPool* Pool);
+
+		void ParallelFor(ThreadPool* Pool, int Items, ThreadTask Task, void* Args);
+
+#endif
@@ -0,0 +1,251 @@
+#include "../../../CNN.h"
+
+/*
+	Binary Cache of a DataSet. Written the first time a DataSet is read from its Source Files,
+	and mapped on later Loads instead of parsing them again
+
+			File Structure
+
+	1 - Stamp
+
+	2 - Read
+
+	3 - Write
+
+*/
+
+// 1 --- Stamp --- //
+
+	/*
+		Get the Size and Modification Time of a Source File, so a Cache of an older Version of it is not used
+
+		Source - Path of the File. Can be NULL
+		Size - Where to place its Size. 0 if it doesn't exist
+		Time - Where to place its Modification Time. 0 if it doesn't exist
+
+		Return Value - 1 if the File exists, 0 if it doesn't or Source is NULL
+	*/
+
+	static int SourceStamp(char* Source, uint64_t* Size, int64_t* Time)
+	{
+		struct stat Info;
+
+		*Size = 0;
+		*Time = 0;
+
+		if(Source != NULL && stat(Source, &Info) == 0)
+		{
+			*Size = Info.st_size;
+			*Time = Info.st_mtime;
+
+			return 1;
+		}
+
+		return 0;
+	}
+
+// 2 --- Read --- //
+
+	/*
+		Map a Cache File. Pixels are used straight from the Mapping, so nothing is read until a Sample is used.
+		Labels are stored as one Class byte per Sample
+
+		Path - Cache File
+		Source - File the DataSet is read from without the Cache. If it changed since the Cache was written, the Cache is not used.
+				 If it is missing, the Cache is used with a Warning, as it can not be checked. NULL uses the Cache without checking
+		Data - Where to place the DataSet. Free it with FreeDataBuffer
+
+		Return Value - 0, or 1 if there is no valid Cache. Data is untouched then
+	*/
+
+	int ReadDataCache(char* Path, char* Source, DataBuffer* Data)
+	{
+		// --- Map the File --- //
+
+			int File = open(Path, O_RDONLY);
+
+			if(File < 0)
+			{
+				return 1;
+			}
+
+			struct stat Info;
+			void* Map = MAP_FAILED;
+
+			if(fstat(File, &Info) == 0 && (size_t) Info.st_size >= sizeof(DataCacheHeader))
+			{
+				Map = mmap(NULL, Info.st_size, PROT_READ, MAP_PRIVATE, File, 0);
+			}
+
+			close(File);
+
+			if(Map == MAP_FAILED)
+			{
+				return 1;
+			}
+
+		// --- Check the Header --- //
+
+			DataCacheHeader* Header = Map;
+
+			uint64_t SourceSize;
+			int64_t SourceTime;
+
+			char Found = SourceStamp(Source, &SourceSize, &SourceTime);
+
+			// Sizes of a corrupt Header could wrap around when multiplied, and then look like they fit in the File
+			uint64_t Values = Header->Samples;
+			char Sized = Header->Samples > 0 && Header->Samples <= INT32_MAX;
+
+			for(int d = 0; d < 3; ++d)
+			{
+				Sized = Sized && Header->Dims[d] > 0 && Header->Dims[d] <= INT32_MAX && !__builtin_mul_overflow(Values, (uint64_t) Header->Dims[d], &Values);
+			}
+
+			char Valid = memcmp(Header->Magic, DataCacheMagic, sizeof(Header->Magic)) == 0
+						 && Header->Version == DataCacheVersion && Header->DType == DTypeUInt8
+						 && Sized && Header->Classes > 0 && Header->Classes <= 255
+						 && Header->ImageOffset % 64 == 0 && Header->ImageOffset >= sizeof(DataCacheHeader)
+						 && Header->ImageOffset <= Header->LabelOffset && Values <= Header->LabelOffset - Header->ImageOffset
+						 && Header->LabelOffset <= (uint64_t) Info.st_size && Header->Samples <= (uint64_t) Info.st_size - Header->LabelOffset
+						 && (!Found || (Header->SourceSize == SourceSize && Header->SourceTime == SourceTime));
+
+			if(!Valid)
+			{
+				munmap(Map, Info.st_size);
+				return 1;
+			}
+
+		// --- Labels as ints. Every one has to be a Class, like in the Source Files --- //
+
+			int* Labels = malloc(sizeof(int) * Header->Samples);
+
+			if(Labels == NULL)
+			{
+				printf("Memory Allocation Error.\n");
+				exit(MemoryError);
+			}
+
+			unsigned char* Stored = (unsigned char*) Map + Header->LabelOffset;
+
+			for(uint32_t i = 0; i < Header->Samples && Valid; ++i)
+			{
+				Labels[i] = Stored[i];
+				Valid = Stored[i] < Header->Classes;
+			}
+
+			if(!Valid)
+			{
+				free(Labels);
+				munmap(Map, Info.st_size);
+				return 1;
+			}
+
+			if(Source != NULL && !Found)
+			{
+				printf("Warning: %s is missing, DataSet Cache %s may be out of date\n", Source, Path);
+			}
+
+		// --- Pixels from the Mapping --- //
+
+			Data->Samples = Header->Samples;
+			Data->Classes = Header->Classes;
+
+			for(int d = 0; d < 3; ++d)
+			{
+				Data->Dims[d] = Header->Dims[d];
+			}
+
+			Data->Pixels = (unsigned char*) Map + Header->ImageOffset;
+			Data->Labels = Labels;
+
+			Data->Scale = 1;
+			Data->Shift = 0;
+
+			Data->Map = Map;
+			Data->MapSize = Info.st_size;
+			Data->Owner = 1;
+
+		return 0;
+	}
+
+// 3 --- Write --- //
+
+	/*
+		Write a DataSet to a Cache File.
+		The File is written under a temporary name and then renamed, so a Load never maps a Cache that is only partly written.
+		Failing to write it is not an Error, the next Load reads the Source again
+
+		Path - Cache File
+		Source - File the DataSet was read from. Its Size and Modification Time are stored, so later Loads can tell if it changed
+		Data - DataSet. Labels are stored as bytes, so it can have at most 255 Classes
+
+		Return Value - Nothing
+	*/
+
+	void WriteDataCache(char* Path, char* Source, DataBuffer* Data)
+	{
+		if(Data->Classes > 255)
+		{
+			return;
+		}
+
+		size_t Values = (size_t) Data->Samples * Data->Dims[0] * Data->Dims[1] * Data->Dims[2];
+
+		// --- Header --- //
+
+			DataCacheHeader Header;
+			memset(&Header, 0, sizeof(Header));
+
+			memcpy(Header.Magic, DataCacheMagic, sizeof(Header.Magic));
+			Header.Version = DataCacheVersion;
+			Header.DType = DTypeUInt8;
+
+			Header.Samples = Data->Samples;
+			Header.Classes = Data->Classes;
+
+			for(int d = 0; d < 3; ++d)
+			{
+				Header.Dims[d] = Data->Dims[d];
+			}
+
+			SourceStamp(Source, &Header.SourceSize, &Header.SourceTime);
+
+			Header.ImageOffset = (sizeof(Header) + 63) / 64 * 64;
+			Header.LabelOffset = Header.ImageOffset + Values;
+
+		// --- Write --- //
+
+			char Temp[strlen(Path) + 5];
+			sprintf(Temp, "%s.tmp", Path);
+
+			FILE* File = fopen(Temp, "wb");
+
+			if(File == NULL)
+			{
+				printf("Could not write DataSet Cache %s\n", Path);
+				return;
+			}
+
+			char Padding[64] = {0};
+			size_t Pad = Header.ImageOffset - sizeof(Header);
+
+			char Written = fwrite(&Header, sizeof(Header), 1, File) == 1 && fwrite(Padding, 1, Pad, File) == Pad
+						   && fwrite(Data->Pixels, 1, Values, File) == Values;
+
+			// One byte per Label. 255 marks a Label outside the Classes
+			for(int i = 0; i < Data->Samples && Written; ++i)
+			{
+				unsigned char Class = Data->Labels[i] >= 0 && Data->Labels[i] < Data->Classes ? Data->Labels[i] : 255;
+
+				Written = fputc(Class, File) != EOF;
+			}
+
+			Written = fclose(File) == 0 && Written;
+
+			if(!Written || rename(Temp, Path) != 0)
+			{
+				remove(Temp);
+				printf("Could not write DataSet Cache %s\n", Path);
+			}
+	}
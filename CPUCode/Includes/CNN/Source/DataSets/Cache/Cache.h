@@ -0,0 +1,36 @@
+#ifndef CACHE_DEFINED
+#define CACHE_DEFINED
+
+	// 1 --- Cache Format --- //
+
+		#define DataCacheMagic "CNNDATA"		// First 8 Bytes of a Cache File, with the terminator
+		#define DataCacheVersion 1				// Caches of any other Version are not read
+
+		#define DTypeUInt8 1					// Image Values stored as unsigned char, the only Type written
+
+		// Header at the start of a Cache File. Images start at ImageOffset, then one Class index byte per Sample at LabelOffset
+		typedef struct
+		{
+			char Magic[8];						// DataCacheMagic
+			uint32_t Version;					// DataCacheVersion of the Writer
+			uint32_t DType;						// Type of the Image Values
+
+			uint32_t Samples;					// Amount of Samples
+			uint32_t Dims[3];					// Dimensions of an Image {Channels, Height, Width}
+			uint32_t Classes;					// Values of a Label
+			uint32_t Reserved;					// Always 0. Keeps the 64 bit fields aligned
+
+			uint64_t SourceSize;				// Size of the File the DataSet was read from
+			int64_t SourceTime;					// Modification Time of that File
+
+			uint64_t ImageOffset;				// Byte the Images start at, a multiple of 64
+			uint64_t LabelOffset;				// Byte the Labels start at
+
+		} DataCacheHeader;
+
+	// 2 --- Function Prototypes --- //
+
+		int ReadDataCache(char* Path, char* Source, DataBuffer* Data);
+		void WriteDataCache(char* Path, char* Source, DataBuffer* Data);
+
+#endif
@@ -5,20 +5,59 @@
 
 		#include <stdio.h>
 		#include <stdlib.h>
+		#include <stdint.h>
 		#include <math.h>
+		#include <string.h>
+		#include <unistd.h>
+		#include <fcntl.h>
+		#include <sys/mman.h>
+		#include <sys/stat.h>
 		#include "../../Libs/CNNLibs.h"
 
-	// 2 --- DataSets --- //
+	// 2 --- Structures --- //
 
+		// Every Sample of a DataSet as it is stored, one byte per Pixel and the Class of every Label.
+		// Samples are converted to doubles only as Batches are gathered, so the DataSet takes an eighth of the memory of doubles
+		typedef struct
+		{
+			int Samples;				// Amount of Samples
+			int Dims[3];				// Dimensions of an Image {Channels, Height, Width}
+			int Classes;				// Amount of Classes
+
+			unsigned char* Pixels;		// {Samples, Dims}
+			int* Labels;				// Class of every Sample
+
+			double Scale;				// A Pixel is converted to Pixel * Scale + Shift. 1 and 0 keep the stored Values
+			double Shift;
+
+			void* Map;					// Mapped Cache File Pixels point into. NULL if they are allocated
+			size_t MapSize;				// Size of Map
+			char Owner;					// 1 if the Buffers are freed with the DataBuffer, 0 for a View of another one
+
+		} DataBuffer;
+
+	// 3 --- DataSets --- //
+
+		#include "Cache/Cache.h"
+		#include "IDX/IDX.h"
 		#include "MNIST/MNIST.h"
 
-	// 3 --- DataSet Indexes --- //
+	// 4 --- DataSet Indexes --- //
 
 		#define MNIST 1
 
-	// 4 --- Function Prototypes --- //
+	// 5 --- Function Prototypes --- //
 
 		void LoadData(double***** XTrain, double*** YTrain, double***** XTest, double*** YTest, double Split, char DataSet);
 		void FreeData(double**** XTrain, double** YTrain, double**** XTest, double** YTest, char DataSet);
 
+		void LoadDataBuffer(DataBuffer* Data, char DataSet);
+
+		void InitDataBuffer(DataBuffer* Data, int Samples, int* Dims, int Classes);
+		DataBuffer ViewDataBuffer(DataBuffer* Data, int First, int Samples);
+		void FreeDataBuffer(DataBuffer* Data);
+
+		void ConvertSample(DataBuffer* Data, int Sample, double* Values);
+		void ConvertLabel(DataBuffer* Data, int Sample, double* Label);
+
 #endif
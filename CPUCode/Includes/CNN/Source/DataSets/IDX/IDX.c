@@ -0,0 +1,158 @@
+#include "../../../CNN.h"
+
+/*
+	Load DataSets in IDX Format According to
+	http://yann.lecun.com/exdb/mnist/
+
+			File Structure
+
+	1 - Header
+
+	2 - Load
+
+*/
+
+// 1 --- Header --- //
+
+	/*
+		Read the Header of an IDX File. It starts with 2 zero Bytes, the Type of the Values and the Amount of Dimensions,
+		then every Dimension as a big endian 32 bit integer
+
+		File - IDX File, at its start
+		Rank - Amount of Dimensions expected
+		Dims - Where to place the Dimensions
+
+		Return Value - 0, or 1 if the Header is not an IDX Header of unsigned chars with Rank Dimensions
+	*/
+
+	static int ReadIDXHeader(FILE* File, int Rank, int* Dims)
+	{
+		unsigned char Magic[4];
+
+		if(fread(Magic, 1, 4, File) != 4 || Magic[0] != 0 || Magic[1] != 0 || Magic[2] != IDXUInt8 || Magic[3] != Rank)
+		{
+			return 1;
+		}
+
+		for(int d = 0; d < Rank; ++d)
+		{
+			unsigned char Bytes[4];
+
+			if(fread(Bytes, 1, 4, File) != 4 || Bytes[0] > 0x7F)
+			{
+				return 1;
+			}
+
+			Dims[d] = (Bytes[0] << 24) | (Bytes[1] << 16) | (Bytes[2] << 8) | Bytes[3];
+		}
+
+		return 0;
+	}
+
+// 2 --- Load --- //
+
+	/*
+		Load Image and Label Files in IDX Format, one Sample after the other in the order of the Files.
+		Images are 3 Dimensional {Samples, Height, Width}, Labels 1 Dimensional {Samples}, both of unsigned chars
+
+		ImagePaths - Image Files
+		LabelPaths - Label Files, in the same order. Each must have as many Samples as its Image File
+		Files - Amount of Image Files
+		Classes - Amount of Classes
+		Data - Where to place the DataSet. Free it with FreeDataBuffer
+
+		Return Value - 0, or 1 if a File is missing or not valid, or a Label is not below Classes. Nothing is left allocated in Data then
+	*/
+
+	int LoadIDX(char** ImagePaths, char** LabelPaths, int Files, int Classes, DataBuffer* Data)
+	{
+		FILE* Images[Files];
+		FILE* Labels[Files];
+		int Counts[Files];
+
+		int Dims[3] = {1, 0, 0};
+		int Samples = 0;
+		char Valid = 1;
+
+		// --- Headers. Every Image File must have Images of the same Dimensions --- //
+
+			for(int f = 0; f < Files; ++f)
+			{
+				Images[f] = Valid ? fopen(ImagePaths[f], "rb") : NULL;
+				Labels[f] = Valid ? fopen(LabelPaths[f], "rb") : NULL;
+
+				int ImageDims[3];
+				int LabelCount;
+
+				Valid = Images[f] != NULL && Labels[f] != NULL
+						&& ReadIDXHeader(Images[f], 3, ImageDims) == 0 && ReadIDXHeader(Labels[f], 1, &LabelCount) == 0
+						&& ImageDims[0] == LabelCount && ImageDims[0] <= INT32_MAX - Samples
+						&& (f == 0 || (ImageDims[1] == Dims[1] && ImageDims[2] == Dims[2]));
+
+				if(Valid)
+				{
+					Counts[f] = ImageDims[0];
+					Samples += ImageDims[0];
+
+					Dims[1] = ImageDims[1];
+					Dims[2] = ImageDims[2];
+				}
+			}
+
+			Valid = Valid && Samples > 0;
+
+		// --- Values. Pixels are read straight into Data --- //
+
+			if(Valid)
+			{
+				InitDataBuffer(Data, Samples, Dims, Classes);
+
+				size_t Pixels = (size_t) Dims[1] * Dims[2];
+				size_t Sample = 0;
+
+				unsigned char Block[4096];
+
+				for(int f = 0; f < Files && Valid; ++f)
+				{
+					Valid = fread(Data->Pixels + Sample * Pixels, Pixels, Counts[f], Images[f]) == (size_t) Counts[f];
+
+					for(int i = 0; i < Counts[f] && Valid; i += sizeof(Block))
+					{
+						size_t Count = Counts[f] - i < (int) sizeof(Block) ? (size_t) (Counts[f] - i) : sizeof(Block);
+
+						Valid = fread(Block, 1, Count, Labels[f]) == Count;
+
+						// A Label that is not a Class makes the File not valid, like in ReadCSV
+						for(size_t k = 0; k < Count && Valid; ++k)
+						{
+							Data->Labels[Sample + i + k] = Block[k];
+							Valid = Block[k] < Classes;
+						}
+					}
+
+					Sample += Counts[f];
+				}
+
+				if(!Valid)
+				{
+					FreeDataBuffer(Data);
+				}
+			}
+
+		// --- Close --- //
+
+			for(int f = 0; f < Files; ++f)
+			{
+				if(Images[f] != NULL)
+				{
+					fclose(Images[f]);
+				}
+
+				if(Labels[f] != NULL)
+				{
+					fclose(Labels[f]);
+				}
+			}
+
+		return !Valid;
+	}
@@ -0,0 +1,12 @@
+#ifndef IDX_DEFINED
+#define IDX_DEFINED
+
+	// 1 --- IDX Format --- //
+
+		#define IDXUInt8 0x08					// Type Byte of unsigned char Values, the only Type read
+
+	// 2 --- Function Prototypes --- //
+
+		int LoadIDX(char** ImagePaths, char** LabelPaths, int Files, int Classes, DataBuffer* Data);
+
+#endif
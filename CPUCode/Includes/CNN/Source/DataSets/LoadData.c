@@ -1,23 +1,203 @@
 #include "../../CNN.h"
 
 /*
-	Load MNIST Dataset According to 
+	Load MNIST Dataset According to
 	https://pjreddie.com/projects/mnist-in-csv/
 
 			File Structure
 
-	1 - Data
-		1.1 - Load
-		1.2 - Free
+	1 - Buffers
+		1.1 - Init
+		1.2 - View
+		1.3 - Free
+		1.4 - Load
+
+	2 - Conversion
+		2.1 - Sample
+		2.2 - Label
+
+	3 - Data
+		3.1 - Load
+		3.2 - Free
 
 */
 
-// 1 --- Data --- //
+// 1 --- Buffers --- //
+
+	// 1.1 --- Init --- //
+
+		/*
+        	Allocate the Buffers of a DataSet, set to 0. Scale and Shift keep the stored Values
+
+        	Data - DataBuffer
+        	Samples - Amount of Samples
+        	Dims - Dimensions of an Image {Channels, Height, Width}
+        	Classes - Amount of Classes
+
+            Return Value - Nothing
+        */
+
+		void InitDataBuffer(DataBuffer* Data, int Samples, int* Dims, int Classes)
+		{
+			Data->Samples = Samples;
+			Data->Classes = Classes;
+			memcpy(Data->Dims, Dims, sizeof(Data->Dims));
+
+			Data->Pixels = calloc((size_t) Samples * Dims[0] * Dims[1] * Dims[2], sizeof(unsigned char));
+			Data->Labels = calloc(Samples, sizeof(int));
+
+			Data->Scale = 1;
+			Data->Shift = 0;
+
+			Data->Map = NULL;
+			Data->MapSize = 0;
+			Data->Owner = 1;
+
+			if(Data->Pixels == NULL || Data->Labels == NULL)
+			{
+				printf("Memory Allocation Error.\n");
+				exit(MemoryError);
+			}
+		}
+
+	// 1.2 --- View --- //
+
+		/*
+        	Get consecutive Samples of a DataSet, without copying them. Used to split it into Training and Test
+
+        	Data - DataBuffer
+        	First - First Sample of the View
+        	Samples - Amount of Samples
+
+            Return Value - View, with the Scale and Shift of Data. Freeing it does nothing
+        */
+
+		DataBuffer ViewDataBuffer(DataBuffer* Data, int First, int Samples)
+		{
+			DataBuffer View = *Data;
+
+			View.Samples = Samples;
+			View.Pixels = Data->Pixels + (size_t) First * Data->Dims[0] * Data->Dims[1] * Data->Dims[2];
+			View.Labels = Data->Labels + First;
+
+			View.Map = NULL;
+			View.MapSize = 0;
+			View.Owner = 0;
+
+			return View;
+		}
+
+	// 1.3 --- Free --- //
+
+		/*
+        	Free the Buffers of a DataSet, or unmap the Cache File its Pixels are in
+
+        	Data - DataBuffer
 
-	// 1.1 --- Load --- //
+            Return Value - Nothing
+        */
+
+		void FreeDataBuffer(DataBuffer* Data)
+		{
+			if(Data->Owner)
+			{
+				if(Data->Map != NULL)
+				{
+					munmap(Data->Map, Data->MapSize);
+				}
+				else
+				{
+					free(Data->Pixels);
+				}
+
+				free(Data->Labels);
+			}
+
+			memset(Data, 0, sizeof(DataBuffer));
+		}
+
+	// 1.4 --- Load --- //
 
 		/*
-        	Loads chosen DataSet
+        	Loads chosen DataSet as it is stored. Train with CNNTrainCPUData and Test with CalcDataAccuracy
+
+        	Data - Where to place the DataSet. Free it with FreeDataBuffer
+			DataSet - Which DataSet to Load
+
+            Return Value - Nothing
+        */
+
+		void LoadDataBuffer(DataBuffer* Data, char DataSet)
+		{
+			memset(Data, 0, sizeof(DataBuffer));
+
+			switch(DataSet)
+			{
+				case MNIST:
+							LoadDataMNIST(Data);
+							break;
+			}
+		}
+
+// 2 --- Conversion --- //
+
+	// 2.1 --- Sample --- //
+
+		/*
+        	Convert a Sample to doubles, normalized with the Scale and Shift of the DataSet
+
+        	Data - DataBuffer
+        	Sample - Index of the Sample
+        	Values - Where to place its Values
+
+            Return Value - Nothing
+        */
+
+		void ConvertSample(DataBuffer* Data, int Sample, double* Values)
+		{
+			int Count = Data->Dims[0] * Data->Dims[1] * Data->Dims[2];
+
+			unsigned char* Pixels = Data->Pixels + (size_t) Sample * Count;
+
+			double Scale = Data->Scale;
+			double Shift = Data->Shift;
+
+			for(int i = 0; i < Count; ++i)
+			{
+				Values[i] = Pixels[i] * Scale + Shift;
+			}
+		}
+
+	// 2.2 --- Label --- //
+
+		/*
+        	Convert the Class of a Sample to a one hot Label. Classes outside the DataSet give a Label of zeros
+
+        	Data - DataBuffer
+        	Sample - Index of the Sample
+        	Label - Where to place the Label, Data->Classes Values
+
+            Return Value - Nothing
+        */
+
+		void ConvertLabel(DataBuffer* Data, int Sample, double* Label)
+		{
+			int Class = Data->Labels[Sample];
+
+			for(int k = 0; k < Data->Classes; ++k)
+			{
+				Label[k] = k == Class;
+			}
+		}
+
+// 3 --- Data --- //
+
+	// 3.1 --- Load --- //
+
+		/*
+        	Loads chosen DataSet as doubles. Every Image is a double***, pointing into one Buffer holding every Image.
+        	The DataSet is loaded as it is stored and converted once, LoadDataBuffer keeps it as it is stored.
+        	Tables, Row Pointers, Images and Labels are one Block starting at XTrain, so every Load is freed on its own by FreeData
 
         	XTrain - Address of Training Data
         	YTrain - Address of Training Labels
@@ -28,21 +208,84 @@
 
             Return Value - Nothing
         */
-		
+
 		void LoadData(double***** XTrain, double*** YTrain, double***** XTest, double*** YTest, double Split, char DataSet)
 		{
-			switch(DataSet)
-			{
-				case MNIST:
-							LoadDataMNIST(XTrain, YTrain, XTest, YTest, Split);
-							break;
-			}
+			DataBuffer Data;
+			LoadDataBuffer(&Data, DataSet);
+
+			int DataSize = Data.Samples;
+			int Channels = Data.Dims[0];
+			int Height = Data.Dims[1];
+			int Width = Data.Dims[2];
+
+			int Pixels = Channels * Height * Width;
+
+			// --- One Block: Tables, then Row Pointers of every Image, then every Image and every Label --- //
+
+				int SplitSample = round(DataSize * Split);
+				int PerSample = Channels + Channels * Height;
+
+				// Images and Labels start on a double boundary, whatever the size of a pointer
+				size_t Tables = (size_t) 2 * DataSize + (size_t) DataSize * PerSample;
+				size_t TableBytes = (sizeof(void*) * Tables + sizeof(double) - 1) / sizeof(double) * sizeof(double);
+
+				char* Block = malloc(TableBytes + sizeof(double) * DataSize * (Pixels + Data.Classes));
+
+				if(Block == NULL)
+				{
+					printf("Memory Allocation Error.\n");
+					exit(MemoryError);
+				}
+
+				*XTrain = (double****) Block;
+				*XTest = *XTrain + (DataSize - SplitSample);
+				*YTrain = (double**) (*XTest + SplitSample);
+				*YTest = *YTrain + (DataSize - SplitSample);
+
+				void** TableStore = (void**) (*YTest + SplitSample);
+				double* ImageStore = (double*) (Block + TableBytes);
+				double* LabelStore = ImageStore + (size_t) DataSize * Pixels;
+
+				// Same Layout as Init3D, with the Values in ImageStore
+				for(int i = 0; i < DataSize; ++i)
+				{
+					ConvertSample(&Data, i, ImageStore + (size_t) i * Pixels);
+					ConvertLabel(&Data, i, LabelStore + (size_t) i * Data.Classes);
+
+					double*** Image = (double***) (TableStore + (size_t) i * PerSample);
+
+					for(int c = 0; c < Channels; ++c)
+					{
+						Image[c] = (double**) (Image + Channels) + c * Height;
+
+						for(int y = 0; y < Height; ++y)
+						{
+							Image[c][y] = ImageStore + (size_t) i * Pixels + (c * Height + y) * Width;
+						}
+					}
+
+					if(i < SplitSample)
+					{
+						(*XTest)[i] = Image;
+						(*YTest)[i] = LabelStore + (size_t) i * Data.Classes;
+					}
+					else
+					{
+						(*XTrain)[i - SplitSample] = Image;
+						(*YTrain)[i - SplitSample] = LabelStore + (size_t) i * Data.Classes;
+					}
+				}
+
+			FreeDataBuffer(&Data);
+
+			printf("Data Loaded!\n");
 		}
 
-	// 1.2 --- Free --- //
+	// 3.2 --- Free --- //
 
 		/*
-        	Frees chosen DataSet
+        	Frees chosen DataSet. Everything a Load allocated is in the Block starting at XTrain
 
         	XTrain - Training Data
         	YTrain - Training Labels
@@ -55,10 +298,10 @@
 
 		void FreeData(double**** XTrain, double** YTrain, double**** XTest, double** YTest, char DataSet)
 		{
-			switch(DataSet)
-			{
-				case MNIST:
-							FreeDataMNIST(XTrain, YTrain, XTest, YTest);
-							break;
-			}
+			(void) YTrain;
+			(void) XTest;
+			(void) YTest;
+			(void) DataSet;
+
+			free(XTrain);
 		}
@@ -1,210 +1,368 @@
 #include "../../../CNN.h"
 
 /*
-	Load MNIST Dataset According to 
+	Load MNIST Dataset According to
 	https://pjreddie.com/projects/mnist-in-csv/
 
 			File Structure
 
-	1 - Global Variables
+	1 - Parse
+		1.1 - Line
+		1.2 - Count
+		1.3 - Samples
 
 	2 - Data
-		2.1 - Load
-		2.2 - Free
+		2.1 - CSV
+		2.2 - Load
 
 */
 
-// 1 --- Global Variables --- //
+// 1 --- Parse --- //
 
-	static double SplitStore;	// Store the Split for Free Later
+	// Arguments of the Parse Tasks
+	typedef struct
+	{
+		char* Text;					// Mapped File
+		size_t* Bounds;				// First Byte of every Chunk, always the start of a Line. Chunks + 1 values
+		int* Lines;					// Lines in every Chunk. Turned into the Sample of the first Line of every Chunk
 
-// 2 --- Data --- //
+		int Samples;				// Samples to read. Lines after them are ignored
+		int Pixels;					// Values of an Image
+		int Classes;				// Labels must be below it
+
+		unsigned char* Images;		// {Samples, Pixels}
+		int* Labels;				// Class of every Sample
+
+		size_t* Malformed;			// First Byte of the first malformed Line of every Chunk, or SIZE_MAX
+		int* MalformedSample;		// Sample of that Line
 
-	// 2.1 --- Load --- //
+	} ParseArgs;
+
+	// 1.1 --- Line --- //
 
 		/*
-        	Loads MNIST Train Data
+			Parse a Line of the CSV. The Label comes first, then the Pixels, as unsigned integers separated by commas.
+			Spaces around a Value are allowed. Nothing is changed to make a Line fit, a Line that doesn't is malformed
 
-        	XTrain - Address of Training Data ( Dimensions {70000 * (1 - split), 1, 28, 28} )
-        	YTrain - Address of Training Labels ( Dimensions {70000 * (1 - split), 10} )
-        	XTest - Address of Test Data ( Dimensions {70000 * split, 1, 28, 28} )
-        	YTest - Address of Test Labels ( Dimensions {70000 * split, 10} )
-			Split - % of DataSet to be used for Testing. 0.4 means 40% will be for Test and 60% will be for Training
+			Next - First Character of the Line
+			End - Character after the last one of the Line
+			Image - Where to place the Pixels
+			Label - Where to place the Class
+			Pixels - Values of an Image
+			Classes - Amount of Classes
 
-            Return Value - Nothing
-        */
+			Return Value - 0, or 1 if a Value is not a number, is out of range, or the Line doesn't have 1 + Pixels Values
+		*/
 
-		void LoadDataMNIST(double***** XTrain, double*** YTrain, double***** XTest, double*** YTest, double Split)
+		static int ParseLine(char* Next, char* End, unsigned char* Image, int* Label, int Pixels, int Classes)
 		{
-			SplitStore = Split;
+			int Field = -1;				// -1 for the Label, then the Pixel
 
-			int DataSize = 70000;
-			int InputChannels = 1;
-			int InputSize = 28;
-			int OutputSize = 10;
+			while(1)
+			{
+				while(Next < End && (*Next == ' ' || *Next == '\t' || *Next == '\r'))
+				{
+					++Next;
+				}
+
+				if(Next == End || *Next < '0' || *Next > '9' || Field >= Pixels)
+				{
+					return 1;
+				}
 
-			int ImgDims[3];
-			ImgDims[0] = InputChannels;
-			ImgDims[1] = InputSize;
-			ImgDims[2] = InputSize;
+				int Number = 0;
+				int Limit = Field < 0 ? Classes - 1 : 255;
 
-			FILE * File = fopen("CPUCode/Includes/CNN/Source/DataSets/MNIST/MNIST.csv", "r");
+				for(; Next < End && *Next >= '0' && *Next <= '9'; ++Next)
+				{
+					Number = 10 * Number + (*Next - '0');
 
-			if(File == NULL)
-			{
-				char cwd[1000];
-				if(getcwd(cwd, sizeof(cwd)) != NULL)
+					if(Number > Limit)
+					{
+						return 1;
+					}
+				}
+
+				if(Field < 0)
+				{
+					*Label = Number;
+				}
+				else
+				{
+					Image[Field] = Number;
+				}
+
+				++Field;
+
+				while(Next < End && (*Next == ' ' || *Next == '\t' || *Next == '\r'))
+				{
+					++Next;
+				}
+
+				if(Next == End)
+				{
+					return Field != Pixels;
+				}
+
+				if(*Next != ',')
 				{
-				    printf("Current working dir: %s\n", cwd);
+					return 1;
 				}
-				printf("Error Opening File!\n");
-				exit(-1);
+
+				++Next;
 			}
+		}
 
-			int c;
-			int CurrentSample = 0;
-			char Flag = 1;
-			int y = 0, x = 0;
+	// 1.2 --- Count --- //
 
-			double Data = 0;
+		// Count the Lines of Chunks [Start, End). Empty Lines are not Samples
+		static void CountTask(void* Args, int Start, int End, int Thread)
+		{
+			(void) Thread;
 
-			int SplitSample = round(DataSize * Split);
+			ParseArgs* Task = Args;
 
-			*XTrain = malloc(sizeof(double***) * round(DataSize * (1 - Split)) );
-			*YTrain = malloc(sizeof(double*) * round(DataSize * (1 - Split)) );
+			for(int Chunk = Start; Chunk < End; ++Chunk)
+			{
+				char* Next = Task->Text + Task->Bounds[Chunk];
+				char* Last = Task->Text + Task->Bounds[Chunk + 1];
 
-			*XTest = malloc(sizeof(double***) * SplitSample);
-			*YTest = malloc(sizeof(double*) * SplitSample);
-			(*XTest)[CurrentSample] = Init3D(ImgDims);
-			(*YTest)[CurrentSample] = Init1D(OutputSize);
+				int Lines = 0;
 
-			while((c = fgetc(File)) != EOF)
+				while(Next < Last)
+				{
+					char* NewLine = memchr(Next, '\n', Last - Next);
+					char* LineEnd = NewLine == NULL ? Last : NewLine;
+
+					Lines += LineEnd > Next;
+					Next = LineEnd + 1;
+				}
+
+				Task->Lines[Chunk] = Lines;
+			}
+		}
+
+	// 1.3 --- Samples --- //
+
+		// Parse the Lines of Chunks [Start, End) into their Samples. Lines holds the Sample of the first Line of every Chunk.
+		// A Chunk stops at its first malformed Line
+		static void ParseTask(void* Args, int Start, int End, int Thread)
+		{
+			(void) Thread;
+
+			ParseArgs* Task = Args;
+
+			for(int Chunk = Start; Chunk < End; ++Chunk)
 			{
-				char test = (char) c;
+				char* Next = Task->Text + Task->Bounds[Chunk];
+				char* Last = Task->Text + Task->Bounds[Chunk + 1];
+
+				int Sample = Task->Lines[Chunk];
+
+				Task->Malformed[Chunk] = SIZE_MAX;
 
-				// Label
-				if(Flag == 1)
+				while(Next < Last && Sample < Task->Samples)
 				{
-					if(CurrentSample < SplitSample)
-					{
-						(*YTest)[CurrentSample][atoi(&test)] = 1;
-					}
-					else
+					char* NewLine = memchr(Next, '\n', Last - Next);
+					char* LineEnd = NewLine == NULL ? Last : NewLine;
+
+					if(LineEnd > Next)
 					{
-						(*YTrain)[CurrentSample - SplitSample][atoi(&test)] = 1;
+						if(ParseLine(Next, LineEnd, Task->Images + (size_t) Sample * Task->Pixels, Task->Labels + Sample, Task->Pixels, Task->Classes) != 0)
+						{
+							Task->Malformed[Chunk] = Next - Task->Text;
+							Task->MalformedSample[Chunk] = Sample;
+							break;
+						}
+
+						++Sample;
 					}
-					
-					Flag = 2;
-					continue;
-				}
-
-				// Comma Means Number is over
-		    	if(test == ',')
-		    	{
-		    		if(Flag == 2)
-		    		{
-		    			Flag = 0;
-		    			continue;
-		    		}
-
-		    		if(CurrentSample < SplitSample)
-		    		{
-		    			(*XTest)[CurrentSample][0][y][x] = Data;
-		    		}
-		    		else
-		    		{
-		    			(*XTrain)[CurrentSample - SplitSample][0][y][x] = Data;
-		    		}
-
-		    		++x;
-		    		if(x == InputSize)
-		    		{
-		    			x = 0;
-		    			++y;
-		    		}
-
-		    		Data = 0;
-		    		continue;
-		    	}
-
-				// New Sample
-		    	if(test == '\n')
-		    	{
-		    		if(CurrentSample < SplitSample)
-		    		{
-		    			(*XTest)[CurrentSample][0][y][x] = Data;
-		    		}
-		    		else
-		    		{
-		    			(*XTrain)[CurrentSample - SplitSample][0][y][x] = Data;
-		    		}
-
-		    		x = 0;
-		    		y = 0;
-		    		Data = 0;
-
-		    		printf("Loading Data, %d/%d\r", CurrentSample, DataSize);
-
-		    		Flag = 1;
-		    		++CurrentSample;
-		    		
-		    		if(CurrentSample < SplitSample)
+
+					Next = LineEnd + 1;
+				}
+			}
+		}
+
+// 2 --- Data --- //
+
+	// 2.1 --- CSV --- //
+
+		/*
+        	Read MNIST from the CSV.
+        	The File is mapped with mmap and split on Line boundaries, one Chunk per CPU Thread. Threads count the Lines of their Chunk,
+        	so each one knows the Sample its Chunk starts at, then parse their Chunk straight into the Buffers of Data.
+        	A malformed Line is reported with its Line number, and ends the Program like a File with too few Samples
+
+        	Path - CSV File
+        	Data - Where to place the DataSet
+
+            Return Value - Nothing
+        */
+
+		static void ReadCSV(char* Path, DataBuffer* Data)
+		{
+			int DataSize = Data->Samples;
+			int Pixels = Data->Dims[0] * Data->Dims[1] * Data->Dims[2];
+
+			// --- Map the File --- //
+
+				int File = open(Path, O_RDONLY);
+				struct stat Info;
+
+				char* Text = MAP_FAILED;
+
+				if(File >= 0 && fstat(File, &Info) == 0 && Info.st_size > 0)
+				{
+					Text = mmap(NULL, Info.st_size, PROT_READ, MAP_PRIVATE, File, 0);
+				}
+
+				if(File >= 0)
+				{
+					close(File);
+				}
+
+				if(Text == MAP_FAILED)
+				{
+					char cwd[1000];
+					if(getcwd(cwd, sizeof(cwd)) != NULL)
 					{
-						(*XTest)[CurrentSample] = Init3D(ImgDims);
-						(*YTest)[CurrentSample] = Init1D(OutputSize);
+					    printf("Current working dir: %s\n", cwd);
 					}
-					else
+					printf("Error Opening File!\n");
+					exit(-1);
+				}
+
+				size_t Size = Info.st_size;
+
+			// --- One Chunk per Thread, each starting at a Line --- //
+
+				long CPUs = sysconf(_SC_NPROCESSORS_ONLN);
+
+				ThreadPool* Workers = CreateThreadPool(CPUs > 1 ? CPUs : 1);
+				int Chunks = PoolThreads(Workers);
+
+				size_t Bounds[Chunks + 1];
+				int Lines[Chunks];
+
+				size_t Malformed[Chunks];
+				int MalformedSample[Chunks];
+
+				Bounds[0] = 0;
+				Bounds[Chunks] = Size;
+
+				for(int Chunk = 1; Chunk < Chunks; ++Chunk)
+				{
+					size_t At = Size / Chunks * Chunk;
+					At = At > Bounds[Chunk - 1] ? At : Bounds[Chunk - 1];
+
+					char* NewLine = memchr(Text + At, '\n', Size - At);
+
+					Bounds[Chunk] = NewLine == NULL ? Size : (size_t) (NewLine - Text) + 1;
+				}
+
+				ParseArgs Args = {Text, Bounds, Lines, DataSize, Pixels, Data->Classes, Data->Pixels, Data->Labels, Malformed, MalformedSample};
+
+			// --- Count Lines, so every Chunk knows its first Sample --- //
+
+				ParallelFor(Workers, Chunks, CountTask, &Args);
+
+				int Total = 0;
+
+				for(int Chunk = 0; Chunk < Chunks; ++Chunk)
+				{
+					int Count = Lines[Chunk];
+
+					Lines[Chunk] = Total;
+					Total += Count;
+				}
+
+				if(Total < DataSize)
+				{
+					printf("MNIST File has %d Samples, %d expected!\n", Total, DataSize);
+					exit(FileError);
+				}
+
+			// --- Parse --- //
+
+				ParallelFor(Workers, Chunks, ParseTask, &Args);
+
+				// The first malformed Line is reported with its Line number, counting empty Lines too
+				for(int Chunk = 0; Chunk < Chunks; ++Chunk)
+				{
+					if(Malformed[Chunk] != SIZE_MAX)
 					{
-						if(CurrentSample == DataSize)
+						size_t Line = 1;
+
+						for(char* Next = Text; (Next = memchr(Next, '\n', Text + Malformed[Chunk] - Next)) != NULL; ++Next)
 						{
-							continue;
+							++Line;
 						}
-						(*XTrain)[CurrentSample - SplitSample] = Init3D(ImgDims);
-						(*YTrain)[CurrentSample - SplitSample] = Init1D(OutputSize);
+
+						printf("MNIST File Line %zu ( Sample %d ) is malformed!\n", Line, MalformedSample[Chunk]);
+						exit(FileError);
 					}
-		    	}
-
-		    	// Data Numbers
-		    	else
-		    	{
-					Data *= 10;
-					Data += atoi(&test);
-		    	}
-			}
+				}
 
-			printf("\33[2KData Loaded!\n");
-			fclose(File);
+			// --- Free --- //
+
+				FreeThreadPool(Workers);
+				munmap(Text, Size);
 		}
 
-	// 1.1.2 --- Free --- //
+	// 2.2 --- Load --- //
 
 		/*
-        	Frees MNIST Data
+        	Loads MNIST, 70000 Samples of {1, 28, 28} Images and 10 Classes.
+        	A Cache written by an earlier Load is mapped if its Source did not change since. Otherwise the IDX Files are read
+        	if they are next to the CSV, Training Files first, or else the CSV. The Cache is then written for the next Load.
+        	If the IDX Files are there but can't be read, the CSV is read and no Cache is written, as it would be checked against the IDX Files
+
+        	Data - Where to place the DataSet. Free it with FreeDataBuffer
 
             Return Value - Nothing
         */
 
-		void FreeDataMNIST(double**** XTrain, double** YTrain, double**** XTest, double** YTest)
+		void LoadDataMNIST(DataBuffer* Data)
 		{
 			int DataSize = 70000;
-			int SplitSample = round(DataSize * SplitStore);
+			int Dims[3] = {1, 28, 28};
+			int OutputSize = 10;
+
+			char* CSV = "CPUCode/Includes/CNN/Source/DataSets/MNIST/MNIST.csv";
+			char* Cache = "CPUCode/Includes/CNN/Source/DataSets/MNIST/MNIST.cache";
+
+			char* ImagePaths[2] = {"CPUCode/Includes/CNN/Source/DataSets/MNIST/train-images-idx3-ubyte", "CPUCode/Includes/CNN/Source/DataSets/MNIST/t10k-images-idx3-ubyte"};
+			char* LabelPaths[2] = {"CPUCode/Includes/CNN/Source/DataSets/MNIST/train-labels-idx1-ubyte", "CPUCode/Includes/CNN/Source/DataSets/MNIST/t10k-labels-idx1-ubyte"};
+
+			char IDX = access(ImagePaths[0], R_OK) == 0;
+			char* Source = IDX ? ImagePaths[0] : CSV;
 
-			for(int i = 0; i < DataSize; ++i)
+			if(ReadDataCache(Cache, Source, Data) == 0)
 			{
-				if(i < SplitSample)
+				if(Data->Samples == DataSize && memcmp(Data->Dims, Dims, sizeof(Dims)) == 0 && Data->Classes == OutputSize)
 				{
-					Free3D(XTest[i]);
-					Free1D(YTest[i]);
+					return;
 				}
-				else
-				{
-					Free3D(XTrain[i - SplitSample]);
-					Free1D(YTrain[i - SplitSample]);
-				}					
+
+				FreeDataBuffer(Data);
+			}
+
+			if(IDX && LoadIDX(ImagePaths, LabelPaths, 2, OutputSize, Data) == 0)
+			{
+				WriteDataCache(Cache, Source, Data);
+				return;
+			}
+
+			if(IDX)
+			{
+				printf("MNIST IDX Files could not be read, reading the CSV without a Cache\n");
 			}
 
-			free(XTrain);
-			free(YTrain);
-			free(XTest);
-			free(YTest);
+			InitDataBuffer(Data, DataSize, Dims, OutputSize);
+			ReadCSV(CSV, Data);
+
+			if(!IDX)
+			{
+				WriteDataCache(Cache, Source, Data);
+			}
 		}
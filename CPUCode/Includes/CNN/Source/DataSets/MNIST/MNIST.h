@@ -3,7 +3,6 @@
 	
 	// 1 --- Function Prototypes --- //
 
-		void LoadDataMNIST(double***** XTrain, double*** YTrain, double***** XTest, double*** YTest, double Split);
-		void FreeDataMNIST(double**** XTrain, double** YTrain, double**** XTest, double** YTest);
+		void LoadDataMNIST(DataBuffer* Data);
 		
 #endif
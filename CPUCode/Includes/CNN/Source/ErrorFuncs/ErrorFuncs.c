@@ -8,6 +8,10 @@
         1.2 - Cross Entropy
 
     2 - API to link with other files
+
+    3 - Softmax Output
+        3.1 - Sample
+        3.2 - Batch
 */
 
 // 1 --- Error Functions --- //
@@ -38,7 +42,8 @@
 
 
         /* 
-            Calculate Derivative of (Real - Predicted)^2 = 2*(Real - Predicted), with respect to Input.
+            Calculate Derivative of (Real - Predicted)^2 with respect to the Inputs of a Softmax Layer.
+            With D = Real - Predicted and S = sum(D[k] * Predicted[k]), the Softmax Jacobian reduces it to 2 * Predicted[i] * (S - D[i])
             
             Prediction - Prediction ( YHat )
             Truth - Label ( Y)
@@ -49,19 +54,16 @@
         */
         static void MSEBackward(double* Prediction, double* Truth, double* Output, int Dim)
         {
+            double Sum = 0;
+
+            for(int k = 0; k < Dim; ++k)
+            {
+                Sum += (Truth[k] - Prediction[k]) * Prediction[k];
+            }
+
             for(int i = 0; i < Dim; ++i)
             {
-                for(int k = 0; k < Dim; ++k)
-                {
-                    if(i == k)
-                    {
-                        Output[i] += ( 2 * Prediction[i] * (Truth[i] - Prediction[i]) * (1 - Prediction[i]) );
-                    }
-                    else
-                    {
-                        Output[i] -= ( 2 * Prediction[i] * (Truth[k] - Prediction[k])  * Prediction[k]);
-                    }
-                }
+                Output[i] = 2 * Prediction[i] * (Sum - (Truth[i] - Prediction[i]));
             }
         }
 
@@ -152,20 +154,19 @@
 
      /* 
         // Calculate Error Derivative with respect to a given Input, 
-        for a given prediction and label, according to a certain Error Function
+        for a given prediction and label, according to a certain Error Function.
+        Nothing is allocated, so it can be called for every Sample while Training
 
         Prediction - Prediction ( YHat )
         Truth - Label ( Y)
-        Output - Where result is placed
+        Output - Where result is placed. Size Dim
         Dim - Size of Prediction and Truth
 
-        Return Value - Array of size Dim containing Derivative for every Input
+        Return Value - Nothing
     */
 
-    double* ErrorBackward(double* Prediction, double* Truth, int Dim, char EFunc)
+    void ErrorBackward(double* Prediction, double* Truth, double* Output, int Dim, char EFunc)
     {
-        double* Output = Init1D(Dim);
-        
         if(EFunc == CrossEnt)
         {
             CrossEntBackward(Prediction, Truth, Output, Dim);
@@ -174,8 +175,92 @@
         {
             MSEBackward(Prediction, Truth, Output, Dim);
         }
-
-        return Output;
     }
 
 // --- API Done --- //
+
+// 3 --- Softmax Output --- //
+
+    // 3.1 --- Sample --- //
+
+        /*
+            Softmax, Error and Error Derivative of one Sample in a single pass, from the Inputs of a Softmax Layer ( Logits ).
+            Cross Entropy is taken from the Logits with Log-Sum-Exp, instead of the log of the Prediction, so it never sees log(0)
+
+            Output - Logits. Replaced by the Prediction
+            Truth - Label ( Y)
+            Gradient - Where the Error Derivative with respect to the Logits is placed
+            Dim - Size of Output and Truth
+            EFunc - Error Function
+
+            Return Value - Error for the Prediction
+        */
+
+        static double SoftmaxErrorSample(double* Output, double* Truth, double* Gradient, int Dim, char EFunc)
+        {
+            double Error = 0;
+
+            // Error of the Cross Entropy is sum(Truth) * log(sum(exp(Shifted))) - sum(Truth * Shifted), with Shifted = Logits - Max
+            int Best = 0;
+            double TruthSum = 0;
+            double Shifted = 0;
+
+            for(int i = 1; i < Dim; ++i)
+            {
+                Best = Output[i] > Output[Best] ? i : Best;
+            }
+
+            for(int i = 0; i < Dim; ++i)
+            {
+                TruthSum += Truth[i];
+                Shifted += Truth[i] * (Output[i] - Output[Best]);
+            }
+
+            // Output[Best] becomes exp(0) / sum(exp(Shifted)), so the Log-Sum-Exp is -log(Output[Best])
+            SoftmaxRow(Output, Dim);
+
+            if(EFunc == CrossEnt)
+            {
+                Error = -TruthSum * log(Output[Best]) - Shifted;
+
+                for(int i = 0; i < Dim; ++i)
+                {
+                    Gradient[i] = TruthSum * Output[i] - Truth[i];
+                }
+            }
+            else if(EFunc == MSE)
+            {
+                Error = MSEForward(Output, Truth, Dim);
+                MSEBackward(Output, Truth, Gradient, Dim);
+            }
+
+            return Error;
+        }
+
+    // 3.2 --- Batch --- //
+
+        /*
+            Finish the Forward Propagation of a Softmax Layer and start its Backward Propagation, for every Sample of a Batch.
+            The Softmax Layer leaves its Logits in Output while Training, and this applies the Softmax, so Output is read once.
+            Nothing is allocated
+
+            Output - Logits from the last Fcon Layer. Replaced by the Predictions
+            Truth - Label of every Sample
+            Gradient - Where the Error Derivatives with respect to the Logits are placed. Same Dimensions as Output
+            EFunc - Error Function
+
+            Return Value - Error summed over the Batch
+        */
+
+        double SoftmaxError(Tensor* Output, double** Truth, Tensor* Gradient, char EFunc)
+        {
+            int Dim = SampleSize(Output);
+            double Error = 0;
+
+            for(int sample = 0; sample < Output->Dims[0]; ++sample)
+            {
+                Error += SoftmaxErrorSample(Output->Data + sample * Output->Strides[0], Truth[sample], Gradient->Data + sample * Gradient->Strides[0], Dim, EFunc);
+            }
+
+            return Error;
+        }
@@ -14,6 +14,8 @@
 	// 3 --- Function Prototypes --- //
 
 		double ErrorForward(double* Prediction, double* Truth, int Dim, char EFunc);
-		double* ErrorBackward(double* Prediction, double* Truth, int Dim, char EFunc);
+		void ErrorBackward(double* Prediction, double* Truth, double* Output, int Dim, char EFunc);
+
+		double SoftmaxError(Tensor* Output, double** Truth, Tensor* Gradient, char EFunc);
 
 #endif
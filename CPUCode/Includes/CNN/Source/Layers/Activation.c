@@ -0,0 +1,360 @@
+#include "../../CNN.h"
+
+/*
+                File Structure
+
+    1 - Math Operations
+        1.1 - Exponential
+        1.2 - Kernels
+        1.3 - Select Kernel
+
+    2 - Accuracy
+
+    3 - Activation
+        3.1 - Row
+        3.2 - Volume
+
+    4 - Softmax
+*/
+
+// 1 --- Math Operations --- //
+
+    // --- Global Variables --- //
+
+        // 4 doubles handled as a single value, loaded from any double. They map to 2 SSE2 or 1 AVX register
+        typedef double ActVector4 __attribute__ ((vector_size (32), aligned (8)));
+
+        // Comparison Results and Exponents of 4 doubles
+        typedef long long ActLanes4 __attribute__ ((vector_size (32)));
+
+        // Lanes of A where Mask is set, Lanes of B elsewhere
+        #define ActSelect(Mask, A, B) ((ActVector4) (((ActLanes4) (A) & (Mask)) | ((ActLanes4) (B) & ~(Mask))))
+
+        // 1 / k!, Coefficients of the Taylor Series of exp(r) - 1
+        static const double ExpCoefficients[14] = {1.0, 1.0, 1.0 / 2, 1.0 / 6, 1.0 / 24, 1.0 / 120, 1.0 / 720, 1.0 / 5040, 1.0 / 40320,
+                                                   1.0 / 362880, 1.0 / 3628800, 1.0 / 39916800, 1.0 / 479001600, 1.0 / 6227020800};
+
+        static int ExpDegree = 13;              // Terms of the Taylor Series used, set by SetActivationAccuracy
+
+    // 1.1 --- Exponential --- //
+
+        /*
+            Split exp(X) in Scale * (1 + Poly). X = n ln2 + r with |r| <= ln2 / 2, Scale = 2^n and Poly = exp(r) - 1 from its Taylor Series.
+            Keeping the 1 out of Poly lets exp(X) - 1 be calculated without cancellation, for Tanh near 0.
+            X is clamped to [-708, 709], so Scale is always a normal double
+
+            X - Values
+            Degree - Terms of the Taylor Series
+            Scale - Where to place 2^n
+            Poly - Where to place exp(r) - 1
+
+            Return Value - Nothing
+        */
+
+        static inline __attribute__ ((always_inline)) void ExpParts(ActVector4* X, int Degree, ActVector4* Scale, ActVector4* Poly)
+        {
+            const double Log2e = 1.44269504088896338700e+00;
+            const double Ln2Hi = 6.93147180369123816490e-01;           // ln2 split in 2, so n * Ln2Hi is exact
+            const double Ln2Lo = 1.90821492927058770002e-10;
+            const double Round = 0x1.8p52;                              // Adding it rounds to an integer, kept in the low bits
+
+            ActVector4 Low = {-708, -708, -708, -708};
+            ActVector4 High = {709, 709, 709, 709};
+            ActVector4 Shift = {Round, Round, Round, Round};
+
+            ActVector4 Value = ActSelect((ActLanes4) (*X < Low), Low, *X);
+            Value = ActSelect((ActLanes4) (Value > High), High, Value);
+
+            ActVector4 Rounded = Value * Log2e + Shift;
+            ActVector4 n = Rounded - Shift;
+            ActVector4 r = (Value - n * Ln2Hi) - n * Ln2Lo;
+
+            // Horner, from the highest Term down
+            ActVector4 Sum = r * ExpCoefficients[Degree] + ExpCoefficients[Degree - 1];
+
+            for(int k = Degree - 2; k >= 1; --k)
+            {
+                Sum = Sum * r + ExpCoefficients[k];
+            }
+
+            *Poly = Sum * r;
+            *Scale = (ActVector4) ((((ActLanes4) Rounded - (ActLanes4) Shift) + 1023) << 52);
+        }
+
+    // 1.2 --- Kernels --- //
+
+        /*
+            Apply Overflow Control and a Function to Values, in place. The Function is picked once, so the loops have no branches.
+            Every Value goes through the same vector code, so a Value gets the same Result wherever it is in a Row
+
+            Values - Values
+            Count - Amount of Values, a multiple of 4
+            Function - 0 - None, 1 - Relu, 2 - Sigmoid, 3 - Tanh, 4 (Soft) - exp, without Overflow Control
+            Degree - Terms of the Taylor Series of exp
+
+            Return Value - Nothing
+        */
+
+        static inline __attribute__ ((always_inline)) void ActivateValues(double* Values, int Count, int Function, int Degree)
+        {
+            ActVector4 Max = {MaxValue, MaxValue, MaxValue, MaxValue};
+            ActVector4 Zero = {0};
+
+            switch(Function)
+            {
+                case ReLu:
+
+                        for(int i = 0; i < Count; i += 4)
+                        {
+                            ActVector4 X = *((ActVector4*) (Values + i));
+                            X = ActSelect((ActLanes4) (X > Max), Max, X);
+
+                            *((ActVector4*) (Values + i)) = ActSelect((ActLanes4) (X > Zero), X, Zero);
+                        }
+
+                        break;
+
+                case Sigmoid:
+
+                        // 1 / (1 + exp(-x))
+                        for(int i = 0; i < Count; i += 4)
+                        {
+                            ActVector4 X = *((ActVector4*) (Values + i));
+                            X = -ActSelect((ActLanes4) (X > Max), Max, X);
+
+                            ActVector4 Scale, Poly;
+                            ExpParts(&X, Degree, &Scale, &Poly);
+
+                            *((ActVector4*) (Values + i)) = 1 / (1 + (Scale * Poly + Scale));
+                        }
+
+                        break;
+
+                case Tanh:
+
+                        // (exp(2x) - 1) / (exp(2x) + 1)
+                        for(int i = 0; i < Count; i += 4)
+                        {
+                            ActVector4 X = *((ActVector4*) (Values + i));
+                            X = 2 * ActSelect((ActLanes4) (X > Max), Max, X);
+
+                            ActVector4 Scale, Poly;
+                            ExpParts(&X, Degree, &Scale, &Poly);
+
+                            ActVector4 Minus1 = Scale * Poly + (Scale - 1);
+
+                            *((ActVector4*) (Values + i)) = Minus1 / (Minus1 + 2);
+                        }
+
+                        break;
+
+                case Soft:
+
+                        for(int i = 0; i < Count; i += 4)
+                        {
+                            ActVector4 Scale, Poly;
+                            ExpParts((ActVector4*) (Values + i), Degree, &Scale, &Poly);
+
+                            *((ActVector4*) (Values + i)) = Scale * Poly + Scale;
+                        }
+
+                        break;
+
+                default:
+
+                        for(int i = 0; i < Count; i += 4)
+                        {
+                            ActVector4 X = *((ActVector4*) (Values + i));
+
+                            *((ActVector4*) (Values + i)) = ActSelect((ActLanes4) (X > Max), Max, X);
+                        }
+
+                        break;
+            }
+        }
+
+        static void ActivateValuesSse(double* Values, int Count, int Function, int Degree)
+        {
+            ActivateValues(Values, Count, Function, Degree);
+        }
+
+    #if defined(__x86_64__) || defined(__i386__)
+
+        __attribute__ ((target ("avx2,fma")))
+        static void ActivateValuesAvx(double* Values, int Count, int Function, int Degree)
+        {
+            ActivateValues(Values, Count, Function, Degree);
+        }
+
+    #endif
+
+    // 1.3 --- Select Kernel --- //
+
+        // Kernel picked for this CPU on the first call to ActivateRow. ActivateOnce makes the pick once, even when the first calls run on a Thread Pool
+        static pthread_once_t ActivateOnce = PTHREAD_ONCE_INIT;
+        static void (*ActivateKernel)(double* Values, int Count, int Function, int Degree);
+
+        /*
+            Pick the widest Activation Kernel this CPU supports
+
+            Return Value - Nothing
+        */
+
+        static void SelectActivateKernel()
+        {
+            ActivateKernel = ActivateValuesSse;
+
+            #if defined(__x86_64__) || defined(__i386__)
+
+                __builtin_cpu_init();
+
+                if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+                {
+                    ActivateKernel = ActivateValuesAvx;
+                }
+
+            #endif
+        }
+
+        /*
+            Run the Kernel on any amount of Values. The last Values are padded to 4, so they take the same path as the others
+
+            Values - Values
+            Count - Amount of Values
+            Function - Kernel Function, as in ActivateValues
+
+            Return Value - Nothing
+        */
+
+        static void RunKernel(double* Values, int Count, int Function)
+        {
+            pthread_once(&ActivateOnce, SelectActivateKernel);
+
+            int Body = Count - Count % 4;
+
+            ActivateKernel(Values, Body, Function, ExpDegree);
+
+            if(Body < Count)
+            {
+                double Tail[4] = {0};
+
+                memcpy(Tail, Values + Body, (Count - Body) * sizeof(double));
+                ActivateKernel(Tail, 4, Function, ExpDegree);
+                memcpy(Values + Body, Tail, (Count - Body) * sizeof(double));
+            }
+        }
+
+// 2 --- Accuracy --- //
+
+    /*
+        Set how exp is approximated by Sigmoid, Tanh and Softmax
+
+        Accuracy - ActPrecise: within a few ulp of libm. ActFast: within 2e-8 relative error of libm ( Tanh near 0, 7e-9 for the others ), for Inference
+
+        Return Value - Nothing
+    */
+
+    void SetActivationAccuracy(char Accuracy)
+    {
+        ExpDegree = Accuracy == ActFast ? 7 : 13;
+    }
+
+// 3 --- Activation --- //
+
+    // 3.1 --- Row --- //
+
+        /*
+            Apply Overflow Control and Activation Function to consecutive Values, in place
+
+            Values - Values
+            Count - Amount of Values
+            Act - Activation Function. Soft only gets Overflow Control, as it needs the whole Layer ( See SoftmaxRow )
+
+            Return Value - Nothing
+        */
+
+        void ActivateRow(double* Values, int Count, double Act)
+        {
+            RunKernel(Values, Count, Act == ReLu || Act == Sigmoid || Act == Tanh ? (int) Act : 0);
+        }
+
+    // 3.2 --- Volume --- //
+
+        // Arguments of ActivateTask
+        typedef struct
+        {
+            Tensor* Values;
+            double Act;
+
+        } ActivateArgs;
+
+        // Activate Channels [Start, End) of every Sample. Item i is Channel i % Channels of Sample i / Channels
+        static void ActivateTask(void* Args, int Start, int End, int Thread)
+        {
+            (void) Thread;
+
+            Tensor* Values = ((ActivateArgs*) Args)->Values;
+            double Act = ((ActivateArgs*) Args)->Act;
+
+            for(int i = Start; i < End; ++i)
+            {
+                ActivateRow(TensorRow(Values, i / Values->Dims[1], i % Values->Dims[1], 0), Values->Dims[2] * Values->Dims[3], Act);
+            }
+        }
+
+        /*
+            Apply Overflow Control and Activation Function to every Value of a Tensor, in place
+
+            Values - Volumes
+            Act - Activation Function
+            Workers - Threads to split Channels among. Can be NULL
+
+            Return Value - Nothing
+        */
+
+        void ActivateTensor(Tensor* Values, double Act, ThreadPool* Workers)
+        {
+            ActivateArgs Args = {Values, Act};
+
+            ParallelFor(Workers, Values->Dims[0] * Values->Dims[1], ActivateTask, &Args);
+        }
+
+// 4 --- Softmax --- //
+
+    /*
+        Replace Values by their Softmax, in place. The Max is subtracted first, so no exp can overflow
+        and the largest one is exactly 1
+
+        Values - Values
+        Count - Amount of Values
+
+        Return Value - Nothing
+    */
+
+    void SoftmaxRow(double* Values, int Count)
+    {
+        double Max = -DBL_MAX;
+        double Sum = 0;
+
+        for(int i = 0; i < Count; ++i)
+        {
+            Max = Values[i] > Max ? Values[i] : Max;
+        }
+
+        for(int i = 0; i < Count; ++i)
+        {
+            Values[i] -= Max;
+        }
+
+        RunKernel(Values, Count, Soft);
+
+        for(int i = 0; i < Count; ++i)
+        {
+            Sum += Values[i];
+        }
+
+        for(int i = 0; i < Count; ++i)
+        {
+            Values[i] /= Sum;
+        }
+    }
@@ -2,364 +2,1954 @@
 
 /*
                 File Structure
-                
+
     1 - Math Operations
         1.1 - Convolution
+            1.1.1 - Window
+            1.1.2 - Borders
+        1.2 - Im2Col
+        1.3 - Col2Im
+
+    2 - Algorithm Selection
+        2.1 - Set Algorithm
+        2.2 - Cost Model
+            2.2.1 - Gemm
+            2.2.2 - Convolution
+        2.3 - Select Algorithm
+            2.3.1 - Cached
+            2.3.2 - Pick
+
+    3 - Conv Cache
+        3.1 - Invalidate
+        3.2 - Free
+        3.3 - Transformed Filters
+        3.4 - Transformed Convolution
+
+    4 - Layer Propagation
+        4.1 - Forward Propagation
+            4.1.1 - Direct
+            4.1.2 - Gemm
+            4.1.3 - Transformed
+            4.1.4 - Forward
+            4.1.5 - Fused Pool
+        4.2 - Backward Propagation
+            4.2.1 - Delta
+            4.2.2 - Gemm
+            4.2.3 - Direct
+            4.2.4 - Backward
 
-    2 - Layer Propagation
-        2.1 - Forward Propagation
-        2.2 - Backward Propagation
+    5 - Workspace
+        5.1 - Transforms
+        5.2 - Conv
+        5.3 - Fused Pool
 */
 
 
 // 1 --- Math operations Needed for this Layer --- //
 
     // 1.1 --- Convolution --- //
-    
+
+        // 1.1.1 --- Window --- //
+
+            /*
+                Calculate Convolution between Input and Filters.
+                On a Border only part of the Filter overlaps the Input, so Height and Width can be smaller than KernelSize
+
+                Input - First Pixel of the Input Window
+                InStride - Elements between consecutive Rows of Input
+                Filters - First Kernel Weight
+                FilterStride - Elements between consecutive Rows of Filters
+                Height - Rows of the Window
+                Width - Columns of the Window
+
+                Return Value - Convolution Result
+            */
+
+            static double Convolution(double* Input, int InStride, double* Filters, int FilterStride, int Height, int Width)
+            {
+            	double out = 0;
+
+                // Convolve Kernel with Pixels
+                for(int y = 0; y < Height; ++y)
+                {
+                    for(int x = 0 ; x < Width; ++x)
+                    {
+                        out += Input[y * InStride + x] * Filters[y * FilterStride + x];
+                    }
+                }
+
+            	return out;
+            }
+
+        // 1.1.2 --- Borders --- //
+
+            /*
+                Find the Indexes i in [0, Count) for which Offset + i * Step falls inside [0, Size).
+                With Step 1 and Count KernelSize these are the Taps of a Window starting at Offset that hit the Input,
+                so Padding pixels are skipped instead of read from a Padded copy.
+                With Step Stride and Count Output Size these are the Outputs whose Tap at Offset hits the Input
+
+                Offset - Position of Index 0. Negative inside the Padding
+                Step - Distance between consecutive Indexes
+                Size - Input Size
+                Count - Indexes to check
+                First - Where to place the first Index inside
+                Last - Where to place one past the last Index inside. Never below First
+
+                Return Value - Nothing
+            */
+
+            static inline void ValidRange(int Offset, int Step, int Size, int Count, int* First, int* Last)
+            {
+                *First = Offset < 0 ? (Step - 1 - Offset) / Step : 0;
+                *Last = Offset < Size ? (Size - 1 - Offset) / Step + 1 : 0;
+
+                if(*Last > Count)
+                {
+                    *Last = Count;
+                }
+                if(*Last < *First)
+                {
+                    *Last = *First;
+                }
+            }
+
+    // 1.2 --- Im2Col --- //
+
+        /*
+            Lower one Input Volume to a Matrix where each Column holds the Window seen by one Output Pixel.
+            Row (channel * KernelSize + ky) * KernelSize + kx holds pixel (ky, kx) of every Window of that channel.
+            Padding pixels are written as 0, so the Input never has to be padded.
+
+            Input - Input Volumes
+            Sample - Volume to Lower
+            FirstChannel - First Channel to Lower
+            LastChannel - Channel after the last one to Lower
+            Cols - Output Matrix {Channels * KernelSize * KernelSize, OutHeight * OutWidth}
+            LdCols - Elements between consecutive Rows of Cols. Above OutHeight * OutWidth when several Samples are lowered side by side
+            KernelSize - Kernel size
+            Stride - Stride
+            Padding - Padding
+            FirstRow - First Output Row to Lower
+            OutHeight - Output Rows to Lower
+            OutWidth - Output Width
+
+            Return Value - Nothing
+        */
+
+        static void Im2Col(Tensor* Input, int Sample, int FirstChannel, int LastChannel, double* Cols, int LdCols, int KernelSize, int Stride, int Padding, int FirstRow, int OutHeight, int OutWidth)
+        {
+            int InHeight = Input->Dims[2];
+            int InWidth = Input->Dims[3];
+
+            for(int channel = FirstChannel; channel < LastChannel; ++channel)
+            {
+                for(int ky = 0; ky < KernelSize; ++ky)
+                {
+                    for(int kx = 0; kx < KernelSize; ++kx)
+                    {
+                        double* Row = Cols + (size_t) ((channel * KernelSize + ky) * KernelSize + kx) * LdCols;
+
+                        // Output Columns whose Input X falls inside the Image
+                        int FirstX = 0;
+                        while(FirstX < OutWidth && FirstX * Stride + kx - Padding < 0)
+                        {
+                            ++FirstX;
+                        }
+                        int LastX = OutWidth;
+                        while(LastX > FirstX && (LastX - 1) * Stride + kx - Padding >= InWidth)
+                        {
+                            --LastX;
+                        }
+
+                        for(int outy = 0; outy < OutHeight; ++outy)
+                        {
+                            double* Out = Row + outy * OutWidth;
+                            int y = (FirstRow + outy) * Stride + ky - Padding;
+
+                            if(y < 0 || y >= InHeight)
+                            {
+                                memset(Out, 0, OutWidth * sizeof(double));
+                                continue;
+                            }
+
+                            double* In = TensorRow(Input, Sample, channel, y) + kx - Padding;
+
+                            for(int outx = 0; outx < FirstX; ++outx)
+                            {
+                                Out[outx] = 0;
+                            }
+
+                            if(Stride == 1)
+                            {
+                                memcpy(Out + FirstX, In + FirstX, (LastX - FirstX) * sizeof(double));
+                            }
+                            else
+                            {
+                                for(int outx = FirstX; outx < LastX; ++outx)
+                                {
+                                    Out[outx] = In[outx * Stride];
+                                }
+                            }
+
+                            for(int outx = LastX; outx < OutWidth; ++outx)
+                            {
+                                Out[outx] = 0;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+    // 1.3 --- Col2Im --- //
+
+        /*
+            Inverse of Im2Col. Every Column of Cols holds the Window of one Output Pixel, and is added back to the Input Pixels it was read from.
+            Windows that overlap add to the same Pixel. Values that Im2Col took from the Padding are dropped.
+            With Stride > 1 only the Pixels a Window reads are touched, so Delta never needs zeroes between the Strides
+
+            Cols - Lowered Matrix {Channels * KernelSize * KernelSize, OutHeight * OutWidth}, laid out like Im2Col's
+            LdCols - Elements between consecutive Rows of Cols
+            Output - Volumes to add to
+            Sample - Volume to add to
+            KernelSize - Kernel size
+            Stride - Stride
+            Padding - Padding
+            OutHeight - Output Height
+            OutWidth - Output Width
+
+            Return Value - Nothing
+        */
+
+        static void Col2Im(double* Cols, int LdCols, Tensor* Output, int Sample, int KernelSize, int Stride, int Padding, int OutHeight, int OutWidth)
+        {
+            for(int channel = 0; channel < Output->Dims[1]; ++channel)
+            {
+                for(int ky = 0; ky < KernelSize; ++ky)
+                {
+                    // Output Rows whose Input Y falls inside the Image
+                    int FirstY, LastY;
+                    ValidRange(ky - Padding, Stride, Output->Dims[2], OutHeight, &FirstY, &LastY);
+
+                    for(int kx = 0; kx < KernelSize; ++kx)
+                    {
+                        double* Row = Cols + (size_t) ((channel * KernelSize + ky) * KernelSize + kx) * LdCols;
+
+                        // Output Columns whose Input X falls inside the Image
+                        int FirstX, LastX;
+                        ValidRange(kx - Padding, Stride, Output->Dims[3], OutWidth, &FirstX, &LastX);
+
+                        for(int outy = FirstY; outy < LastY; ++outy)
+                        {
+                            double* In = TensorRow(Output, Sample, channel, outy * Stride + ky - Padding) + kx - Padding;
+                            double* Col = Row + outy * OutWidth;
+
+                            for(int outx = FirstX; outx < LastX; ++outx)
+                            {
+                                In[outx * Stride] += Col[outx];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+// 2 --- Algorithm Selection --- //
+
+    // --- Global Variables --- //
+
+        static char ConvAlgorithm = ConvAuto;              // Algorithm used by ConvForwCpu
+
+    // 2.1 --- Set Algorithm --- //
+
+        /*
+            Force an Algorithm for every Conv Layer. ConvAuto lets each Layer pick with the Cost Model
+
+            Algorithm - ConvAuto, ConvDirect, ConvGemm, ConvWinograd or ConvFFT. Layers the Algorithm can't handle use ConvGemm instead.
+                        ConvDirect also makes ConvBackCpu take the Weight Gradients with the Direct Loop
+
+            Return Value - Nothing
+        */
+
+        void SetConvAlgorithm(char Algorithm)
+        {
+            ConvAlgorithm = Algorithm;
+        }
+
+    // 2.2 --- Cost Model --- //
+
+        // 2.2.1 --- Gemm --- //
+
+            /*
+                Estimate the Cost of a Gemm call. B is packed once, A once per GemmNC Columns of B
+
+                M - Rows of A and C
+                N - Columns of B and C
+                K - Columns of A, Rows of B
+
+                Return Value - Cost in Gemm Multiply-Adds
+            */
+
+            static double GemmCost(double M, double N, double K)
+            {
+                return M * N * K + GemmPackCost * (M * K * ceil(N / GemmNC) + K * N);
+            }
+
+        // 2.2.2 --- Convolution --- //
+
+            /*
+                Estimate the Cost of a Convolution for one Sample
+
+                Algorithm - Algorithm to estimate
+                Tile - Winograd Output Tile or FFT size. Ignored by the others
+                Channels - Input Channels
+                NKernels - Output Channels
+                KernelSize - Kernel size
+                OutHeight - Output Height
+                OutWidth - Output Width
+                Cached - 1 if the transformed Filters are already in the Cache
+
+                Return Value - Cost in Gemm Multiply-Adds
+            */
+
+            static double ConvCost(char Algorithm, int Tile, double Channels, double NKernels, double KernelSize, int OutHeight, int OutWidth, char Cached)
+            {
+                double Pixels = (double) OutHeight * OutWidth;
+                double Cost = 0;
+
+                switch(Algorithm)
+                {
+                    case ConvDirect:
+                                Cost = ConvDirectCost * NKernels * Channels * KernelSize * KernelSize * Pixels;
+                                break;
+
+                    case ConvGemm:
+                                // Im2Col writes the Matrix Gemm packs again
+                                Cost = GemmCost(NKernels, Pixels, Channels * KernelSize * KernelSize) + GemmPackCost * Channels * KernelSize * KernelSize * Pixels;
+                                break;
+
+                    case ConvWinograd:
+                    {
+                                double T = Tile + 2;
+                                double Tiles = ceil(OutHeight / (double) Tile) * ceil(OutWidth / (double) Tile);
+
+                                // One Gemm per Tile position, BT d B for every Input Tile, AT M A for every Output Tile
+                                Cost = T * T * GemmCost(NKernels, Tiles, Channels)
+                                     + TransformCost * Tiles * (Channels * 2 * T * T * T + NKernels * (Tile * T * T + Tile * Tile * T));
+
+                                if(!Cached)
+                                {
+                                    Cost += TransformCost * NKernels * Channels * (3 * 3 * T + 3 * T * T);
+                                }
+                                break;
+                    }
+
+                    case ConvFFT:
+                    {
+                                double m = Tile - KernelSize + 1;
+                                double Tiles = ceil(OutHeight / m) * ceil(OutWidth / m);
+                                double Bins = Tile * (Tile / 2 + 1);
+
+                                // 2D FFT of two real Tiles at once, plus gathering and splitting the Spectra
+                                double FFT = 5.0 * Tile * Tile * log2(Tile) + 4.0 * Tile * Tile;
+
+                                // 4 real Gemms per Frequency, one FFT per pair of Input Channels and per pair of Kernels
+                                Cost = 4 * Bins * GemmCost(NKernels, Tiles, Channels)
+                                     + TransformCost * Tiles * (ceil(Channels / 2) + ceil(NKernels / 2)) * FFT;
+
+                                if(!Cached)
+                                {
+                                    Cost += TransformCost * NKernels * ceil(Channels / 2) * FFT;
+                                }
+                                break;
+                    }
+                }
+
+                return Cost;
+            }
+
+    // 2.3 --- Select Algorithm --- //
+
+        // 2.3.1 --- Cached --- //
+
+            /*
+                Check if the transformed Filters for an Algorithm are in the Cache
+
+                Cache - Cache of the Layer. Can be NULL
+                Algorithm - ConvWinograd or ConvFFT
+                Direction - ConvForward or ConvBackward
+                Tile - Winograd Output Tile or FFT size
+
+                Return Value - 1 if they are, 0 otherwise
+            */
+
+            static char IsCached(ConvCache* Cache, char Algorithm, int Direction, int Tile)
+            {
+                if(Cache == NULL)
+                {
+                    return 0;
+                }
+
+                if(Algorithm == ConvWinograd)
+                {
+                    return Cache->WinogradValid[Direction] && Cache->Winograd[Direction].Dims[0] == (Tile + 2) * (Tile + 2);
+                }
+
+                return Cache->SpectraValid[Direction] && Cache->Spectra[Direction].Dims[0] == Tile * (Tile / 2 + 1);
+            }
+
+        // 2.3.2 --- Pick --- //
+
+            /*
+                Pick the Algorithm for a Convolution.
+                The Input Gradient is a Stride 1 Convolution of Delta with NKernels Channels and Channels Kernels, with zeroes between the Strides.
+                Its Gemm path skips those zeroes, so it only does the Multiply-Adds of the Forward Propagation.
+
+                Direction - ConvForward or ConvBackward
+                Channels - Input Channels of the Convolution
+                NKernels - Output Channels of the Convolution
+                KernelSize - Kernel size
+                Stride - Stride of the Layer
+                OutHeight - Output Height
+                OutWidth - Output Width
+                Cache - Cache of the Layer. Can be NULL
+                Tile - Where to place the Winograd Output Tile or FFT size
+
+                Return Value - ConvDirect, ConvGemm, ConvWinograd or ConvFFT
+            */
+
+            static char PickConvAlgorithm(int Direction, int Channels, int NKernels, int KernelSize, int Stride, int OutHeight, int OutWidth, ConvCache* Cache, int* Tile)
+            {
+                char Base = ConvGemm;
+
+                char Winograd = KernelSize == 3 && Stride == 1;
+                char FFT = Stride == 1 || Direction == ConvBackward;
+
+                // --- Forced Algorithm --- //
+
+                    if(ConvAlgorithm != ConvAuto)
+                    {
+                        if((ConvAlgorithm == ConvWinograd && !Winograd) || (ConvAlgorithm == ConvFFT && !FFT))
+                        {
+                            return Base;
+                        }
+
+                        if(ConvAlgorithm == ConvGemm)
+                        {
+                            return Base;
+                        }
+
+                        if(ConvAlgorithm != ConvWinograd && ConvAlgorithm != ConvFFT)
+                        {
+                            return ConvAlgorithm;
+                        }
+                    }
+
+                // --- Small Layers --- //
+
+                    // Im2Col copies every Input pixel KernelSize^2 times. That only pays off when enough Kernels reuse it.
+                    // Transforms have the same fixed costs, so tiny Layers of either Direction stay Direct
+                    double Work = (double) NKernels * Channels * KernelSize * KernelSize * OutHeight * OutWidth;
+
+                    if(ConvAlgorithm == ConvAuto && (Work < ConvGemmMinWork || (Direction == ConvForward && NKernels < GemmMR)))
+                    {
+                        return ConvDirect;
+                    }
+
+                // --- Cheapest Algorithm --- //
+
+                    // The Input Gradient Gemm has one Column per Pixel of Delta, not per Pixel of the Zero Inserted one
+                    int GemmHeight = Direction == ConvForward ? OutHeight : (OutHeight + Stride - 1) / Stride;
+                    int GemmWidth = Direction == ConvForward ? OutWidth : (OutWidth + Stride - 1) / Stride;
+
+                    char Best = Base;
+                    double BestCost = ConvCost(Base, 0, Channels, NKernels, KernelSize, GemmHeight, GemmWidth, 0);
+
+                    if(ConvAlgorithm != ConvAuto)
+                    {
+                        BestCost = DBL_MAX;
+                    }
+
+                    if(Winograd && ConvAlgorithm != ConvFFT)
+                    {
+                        int OutTile = WinogradTile(OutHeight, OutWidth);
+                        double Cost = ConvCost(ConvWinograd, OutTile, Channels, NKernels, KernelSize, OutHeight, OutWidth, IsCached(Cache, ConvWinograd, Direction, OutTile));
+
+                        if(Cost < BestCost)
+                        {
+                            Best = ConvWinograd;
+                            BestCost = Cost;
+                            *Tile = OutTile;
+                        }
+                    }
+
+                    if(FFT && ConvAlgorithm != ConvWinograd)
+                    {
+                        for(int T = FFTMinTile; T <= FFTMaxTile; T *= 2)
+                        {
+                            // Tiles need to produce some Output, and Spectra have to fit
+                            if(T < KernelSize + 1 || 2.0 * T * (T / 2 + 1) * NKernels * Channels > FFTMaxSpectra)
+                            {
+                                continue;
+                            }
+
+                            double Cost = ConvCost(ConvFFT, T, Channels, NKernels, KernelSize, OutHeight, OutWidth, IsCached(Cache, ConvFFT, Direction, T));
+
+                            if(Cost < BestCost)
+                            {
+                                Best = ConvFFT;
+                                BestCost = Cost;
+                                *Tile = T;
+                            }
+
+                            // Tiles bigger than the Output only add work
+                            if(T - KernelSize + 1 >= OutHeight && T - KernelSize + 1 >= OutWidth)
+                            {
+                                break;
+                            }
+                        }
+                    }
+
+                return Best;
+            }
+
+// 3 --- Conv Cache --- //
+
+    // 3.1 --- Invalidate --- //
+
+        /*
+            Mark every Transform in a Cache as outdated. Has to be called whenever Weights change
+
+            Cache - Cache of the Layer. Can be NULL
+
+            Return Value - Nothing
+        */
+
+        void InvalidateConvCache(ConvCache* Cache)
+        {
+            if(Cache == NULL)
+            {
+                return;
+            }
+
+            for(int Direction = ConvForward; Direction <= ConvBackward; ++Direction)
+            {
+                Cache->WinogradValid[Direction] = 0;
+                Cache->SpectraValid[Direction] = 0;
+            }
+        }
+
+    // 3.2 --- Free --- //
+
         /*
-            Calculate Convolution between Input and Filters
+            Free every Transform in a Cache
+
+            Cache - Cache of the Layer. Can be NULL
+
+            Return Value - Nothing
+        */
+
+        void FreeConvCache(ConvCache* Cache)
+        {
+            if(Cache == NULL)
+            {
+                return;
+            }
+
+            for(int Direction = ConvForward; Direction <= ConvBackward; ++Direction)
+            {
+                FreeTensor(&(Cache->Winograd[Direction]));
+                FreeTensor(&(Cache->Spectra[Direction]));
+            }
+
+            InvalidateConvCache(Cache);
+        }
+
+    // 3.3 --- Transformed Filters --- //
+
+        /*
+            Get Winograd Filters or Filter Spectra for a Layer, transforming them only if the Cache is outdated
+
+            Filters - Weights {NKernels, Channels, KernelSize, KernelSize}
+            Cache - Cache of the Layer. If NULL, Filters are transformed into Temp
+            Algorithm - ConvWinograd or ConvFFT
+            Direction - ConvForward, or ConvBackward for the Rotated Filters used by the Input Gradient
+            Tile - Winograd Output Tile or FFT size
+            Temp - Used when there is no Cache. Has to be freed by the caller
+
+            Return Value - Transformed Filters, NULL if they could not be allocated
+        */
+
+        static Tensor* GetTransformedFilters(Tensor* Filters, ConvCache* Cache, char Algorithm, int Direction, int Tile, Tensor* Temp)
+        {
+            Tensor* Transformed = Temp;
+            char* Valid = NULL;
+
+            if(Cache != NULL)
+            {
+                if(IsCached(Cache, Algorithm, Direction, Tile))
+                {
+                    return Algorithm == ConvWinograd ? &(Cache->Winograd[Direction]) : &(Cache->Spectra[Direction]);
+                }
+
+                Transformed = Algorithm == ConvWinograd ? &(Cache->Winograd[Direction]) : &(Cache->Spectra[Direction]);
+                Valid = Algorithm == ConvWinograd ? &(Cache->WinogradValid[Direction]) : &(Cache->SpectraValid[Direction]);
+            }
+
+            // --- Source Filters --- //
+
+                Tensor Rotated = {0};
+                Tensor* Source = Filters;
+
+                if(Direction == ConvBackward)
+                {
+                    int RotatedDims[3] = {Filters->Dims[0], Filters->Dims[2], Filters->Dims[3]};
+                    Rotated = InitTensor(Filters->Dims[1], RotatedDims);
+
+                    if(Rotated.Data == NULL)
+                    {
+                        return NULL;
+                    }
+
+                    RotateFilters(Filters, &Rotated);
+                    Source = &Rotated;
+                }
+
+            // --- Transform --- //
+
+                if(Algorithm == ConvWinograd)
+                {
+                    WinogradFilters(Source, Transformed, Tile);
+                }
+                else
+                {
+                    FFTFilters(Source, Transformed, Tile);
+                }
+
+                FreeTensor(&Rotated);
+
+            if(Transformed->Data == NULL)
+            {
+                return NULL;
+            }
+
+            if(Valid != NULL)
+            {
+                *Valid = 1;
+            }
+
+            return Transformed;
+        }
+
+    // 3.4 --- Transformed Convolution --- //
+
+        /*
+            Calculate a Stride 1 Convolution with Winograd or FFT. No Activation is applied
+
+            Input - Input Volumes
+            Output - Where to place Output
+            Filters - Weights {NKernels, Channels, KernelSize, KernelSize}
+            Cache - Cache of the Layer. Can be NULL
+            Algorithm - ConvWinograd or ConvFFT
+            Direction - ConvForward, or ConvBackward to convolve with the Rotated Filters
+            Tile - Winograd Output Tile or FFT size
+            Padding - Padding
+            Workers - Threads to split Tiles among. Can be NULL
+
+            Return Value - 0 on Success, MemoryError if the Transforms could not be allocated
+        */
+
+        static int TransformedConv(Tensor* Input, Tensor* Output, Tensor* Filters, ConvCache* Cache, char Algorithm, int Direction, int Tile, int Padding, ThreadPool* Workers)
+        {
+            Tensor Temp = {0};
+            int Status = MemoryError;
+
+            Tensor* Transformed = GetTransformedFilters(Filters, Cache, Algorithm, Direction, Tile, &Temp);
+
+            if(Transformed != NULL)
+            {
+                if(Algorithm == ConvWinograd)
+                {
+                    Status = WinogradConv(Input, Output, Transformed, Padding, Workers);
+                }
+                else
+                {
+                    Status = FFTConv(Input, Output, Transformed, Filters->Dims[2], Padding, Workers);
+                }
+            }
+
+            FreeTensor(&Temp);
+
+            return Status;
+        }
+
+// 4 --- Layer Propagation --- //
+
+    // 4.1 --- Forward Propagation --- //
+
+        // --- Tasks --- //
+
+            // Arguments shared by the Forward Tasks
+            typedef struct
+            {
+                Tensor* Input;
+                Tensor* Output;             // Output of the Samples, or only the Rows of a Band when Pooled as they are computed
+                Tensor* Filters;
+                double* Params;
+
+                double* Cols;               // Lowered Input of Samples, side by side
+                double* Product;            // Gemm Result {NKernels, Samples * OutPixels}. The Output of Sample itself when Samples is 1
+                int Sample;                 // First Sample being Lowered / multiplied
+                int Samples;                // Samples Lowered together
+                int FirstRow;               // Output Row held by the first Row of Output
+
+                int RowBlocks;              // Gemm Tiles split Output Rows of all Samples in RowBlocks
+                int KernelBlock;            // and Kernels in groups of KernelBlock
+
+            } ConvForwArgs;
+
+        // 4.1.1 --- Direct --- //
+
+            // Calculate Output Rows [Start, End). Item i is Row i % OutHeight of Kernel (i / OutHeight) % NKernels of Sample i / (NKernels * OutHeight)
+            static void ConvDirectTask(void* Args, int Start, int End, int Thread)
+            {
+                (void) Thread;
+
+                ConvForwArgs* Task = Args;
+                Tensor* Input = Task->Input;
+                Tensor* Output = Task->Output;
+                Tensor* Filters = Task->Filters;
+
+                int KernelSize = Task->Params[2];
+                int Stride = Task->Params[3];
+                int Padding = Task->Params[4];
+
+                // Output Columns in [InteriorStart, InteriorEnd) have their whole Window inside the Input
+                int InteriorStart, InteriorEnd;
+                ValidRange(-Padding, Stride, Input->Dims[3] - KernelSize + 1, Output->Dims[3], &InteriorStart, &InteriorEnd);
+
+                for(int i = Start; i < End; ++i)
+                {
+                    int outy = i % Output->Dims[2];                                                 // Output img Y
+                    int kernel = (i / Output->Dims[2]) % Output->Dims[1];
+                    int sample = i / (Output->Dims[2] * Output->Dims[1]);
+
+                    // Rows of the Window inside the Input
+                    int iny = (Task->FirstRow + outy) * Stride - Padding;
+                    int FirstY, LastY;
+                    ValidRange(iny, 1, Input->Dims[2], KernelSize, &FirstY, &LastY);
+
+                    for(int outx = 0; outx < Output->Dims[3]; ++outx)                               // Output img X
+                    {
+                        double Value = 0;
+
+                        // Columns of the Window inside the Input. Only Border Columns need clipping
+                        int inx = outx * Stride - Padding;
+                        int FirstX = 0, LastX = KernelSize;
+
+                        if(outx < InteriorStart || outx >= InteriorEnd)
+                        {
+                            ValidRange(inx, 1, Input->Dims[3], KernelSize, &FirstX, &LastX);
+                        }
+
+                        for(int channel = 0; channel < Input->Dims[1]; ++channel)                   // Input img channels
+                        {
+                            // --- Calc Convolution --- //
+
+                                Value += Convolution(TensorRow(Input, Task->Sample + sample, channel, iny + FirstY) + inx + FirstX, Input->Strides[2],
+                                                     TensorRow(Filters, kernel, channel, FirstY) + FirstX, Filters->Strides[2], LastY - FirstY, LastX - FirstX);
+                        }
+
+                        TensorAt(Output, sample, kernel, outy, outx) = Value;
+                    }
+
+                    // --- Apply Act Func and Overflow Control to the whole Row --- //
+
+                        ActivateRow(TensorRow(Output, sample, kernel, outy), Output->Dims[3], Task->Params[0]);
+                }
+            }
+
+            /*
+                Calculate Conv Layer Forward Propagation one Window at a time. Reference for the other Algorithms.
+                Interior Windows are full KernelSize Convolutions, Border Windows only convolve the Taps inside the Input
+
+                Input - Input Volumes
+                Output - Where to place Output
+                Filters - Kernel Weights {NKernels, Channels, KernelSize, KernelSize}
+                Params - LayerParams
+                Workers - Threads to split Kernels and Output Rows among. Can be NULL
+
+                Return Value - Nothing
+            */
+
+            static void ConvForwDirect(Tensor* Input, Tensor* Output, Tensor* Filters, double* Params, ThreadPool* Workers)
+            {
+                // --- Convolution. Padding pixels are skipped on the Borders, so the Input is never Padded --- //
+
+                    ConvForwArgs Args = {Input, Output, Filters, Params, NULL, NULL, 0, 0, 0, 0, 0};
+
+                    ParallelFor(Workers, Output->Dims[0] * Output->Dims[1] * Output->Dims[2], ConvDirectTask, &Args);
+            }
+
+        // 4.1.2 --- Gemm --- //
+
+            // Lower Channels [Start, End) of the Samples. Item i is Channel i % Channels of Sample i / Channels of the group
+            static void Im2ColTask(void* Args, int Start, int End, int Thread)
+            {
+                (void) Thread;
+
+                ConvForwArgs* Task = Args;
+
+                int Channels = Task->Input->Dims[1];
+                int OutPixels = Task->Output->Dims[2] * Task->Output->Dims[3];
+
+                for(int i = Start; i < End; ++i)
+                {
+                    int sample = i / Channels;
+                    int channel = i % Channels;
+
+                    Im2Col(Task->Input, Task->Sample + sample, channel, channel + 1, Task->Cols + sample * OutPixels, Task->Samples * OutPixels,
+                           Task->Params[2], Task->Params[3], Task->Params[4], Task->FirstRow, Task->Output->Dims[2], Task->Output->Dims[3]);
+                }
+            }
+
+            // Multiply Output Tiles [Start, End). Tile i holds Row Block i % RowBlocks of Kernel Block i / RowBlocks. Rows of every Sample of the group count
+            static void GemmTask(void* Args, int Start, int End, int Thread)
+            {
+                (void) Thread;
+
+                ConvForwArgs* Task = Args;
+                Tensor* Output = Task->Output;
+
+                int NKernels = Output->Dims[1];
+                int OutWidth = Output->Dims[3];
+                int Rows = Task->Samples * Output->Dims[2];
+                int Columns = Task->Samples * Output->Dims[2] * OutWidth;
+                int Depth = Task->Filters->Strides[0];
+
+                for(int i = Start; i < End; ++i)
+                {
+                    int FirstKernel = (i / Task->RowBlocks) * Task->KernelBlock;
+                    int Kernels = NKernels - FirstKernel < Task->KernelBlock ? NKernels - FirstKernel : Task->KernelBlock;
+
+                    int FirstRow = (long long) Rows * (i % Task->RowBlocks) / Task->RowBlocks;
+                    int LastRow = (long long) Rows * (i % Task->RowBlocks + 1) / Task->RowBlocks;
+
+                    if(Kernels <= 0 || LastRow <= FirstRow)
+                    {
+                        continue;
+                    }
+
+                    Gemm(NoTrans, NoTrans, Kernels, (LastRow - FirstRow) * OutWidth, Depth,
+                         1, Task->Filters->Data + FirstKernel * Depth, Depth,
+                         Task->Cols + FirstRow * OutWidth, Columns,
+                         0, Task->Product + (size_t) FirstKernel * Columns + FirstRow * OutWidth, Columns);
+                }
+            }
+
+            // Move Kernels [Start, End) of the group from Product to Output, applying the Activation on the way. Item i is Kernel i % NKernels of Sample i / NKernels
+            static void ScatterTask(void* Args, int Start, int End, int Thread)
+            {
+                (void) Thread;
+
+                ConvForwArgs* Task = Args;
+                Tensor* Output = Task->Output;
+
+                int NKernels = Output->Dims[1];
+                int OutPixels = Output->Dims[2] * Output->Dims[3];
+                int Columns = Task->Samples * OutPixels;
+
+                for(int i = Start; i < End; ++i)
+                {
+                    int sample = i / NKernels;
+                    int kernel = i % NKernels;
+
+                    double* Product = Task->Product + (size_t) kernel * Columns + sample * OutPixels;
+                    double* Out = TensorRow(Output, Task->Sample + sample, kernel, 0);
+
+                    memcpy(Out, Product, OutPixels * sizeof(double));
+                    ActivateRow(Out, OutPixels, Task->Params[0]);
+                }
+            }
+
+            /*
+                Split the Gemm of a group in Tiles, one per Thread. Rows first, Kernels once there are fewer Rows than Threads.
+                Kernel Blocks are kept a multiple of GemmMR
+
+                Args - Arguments of the group. RowBlocks and KernelBlock are placed here
+                Workers - Threads. Can be NULL
+
+                Return Value - Tiles of the group
+            */
+
+            static int GemmTiles(ConvForwArgs* Args, ThreadPool* Workers)
+            {
+                int Threads = PoolThreads(Workers);
+                int Rows = Args->Samples * Args->Output->Dims[2];
+                int NKernels = Args->Output->Dims[1];
+
+                Args->RowBlocks = Rows < Threads ? Rows : Threads;
+                int KernelBlocks = (Threads + Args->RowBlocks - 1) / Args->RowBlocks;
+
+                Args->KernelBlock = (NKernels + KernelBlocks - 1) / KernelBlocks;
+                Args->KernelBlock = ((Args->KernelBlock + GemmMR - 1) / GemmMR) * GemmMR;
+                KernelBlocks = (NKernels + Args->KernelBlock - 1) / Args->KernelBlock;
+
+                return Args->RowBlocks * KernelBlocks;
+            }
+
+            /*
+                Samples lowered together by ConvForwGemm, so the Gemm is at least ConvGemmColumns wide.
+                Layers with big Outputs lower one Sample at a time, since a wider Lowered Input would no longer stay in cache
+
+                OutPixels - Output Pixels of one Sample
+                Samples - Samples in the Input
+
+                Return Value - Samples per group
+            */
+
+            static int GemmSampleBlock(int OutPixels, int Samples)
+            {
+                int Block = (ConvGemmColumns + OutPixels - 1) / OutPixels;
+
+                return Block < Samples ? Block : Samples;
+            }
+
+            /*
+                Calculate Conv Layer Forward Propagation as a Matrix Product.
+
+                Each Input Volume is lowered with Im2Col to {Channels * KernelSize^2, OutPixels}.
+                Filters already are {NKernels, Channels * KernelSize^2} in memory, so
+                Output = Filters x Cols gives every Output Channel at once.
+                Small Outputs are lowered for a group of Samples side by side, so one wide Gemm covers the whole group
+                and its Result is moved to Output while activating. Big Outputs are written straight into Output, one Sample at a time.
+                With Threads, the Product is split in Tiles of Output Rows and Kernels, each its own Gemm.
+                Every Value is still summed in the same order, so results don't depend on the Thread count or the grouping.
+
+                Input - Input Volumes
+                Output - Where to place Output
+                Filters - Kernel Weights {NKernels, Channels, KernelSize, KernelSize}
+                Params - LayerParams
+                Workers - Threads to split Kernels and Output Rows among. Can be NULL
+
+                Return Value - Nothing
+            */
+
+            static void ConvForwGemm(Tensor* Input, Tensor* Output, Tensor* Filters, double* Params, ThreadPool* Workers)
+            {
+                int KernelSize = Params[2];
+                int OutPixels = Output->Dims[2] * Output->Dims[3];
+                int Block = GemmSampleBlock(OutPixels, Input->Dims[0]);
+
+                // --- Lowered Input, and the Product of a group --- //
+
+                    int ColDims[3];
+                    ColDims[0] = 1;
+                    ColDims[1] = Input->Dims[1] * KernelSize * KernelSize;
+                    ColDims[2] = Block * OutPixels;
+
+                    int ProductDims[3] = {1, Output->Dims[1], Block * OutPixels};
+
+                    // Every Value is written by Im2Col and Gemm, so the Scratch Arena is used as is
+                    Arena* Space = ScratchArena();
+                    size_t Mark = Space->Used;
+
+                    Tensor Cols = ArenaTensor(Space, 1, ColDims);
+                    Tensor Product = {0};
+
+                    if(Block > 1)
+                    {
+                        Product = ArenaTensor(Space, 1, ProductDims);
+                    }
+
+                    // Not enough memory for the Lowered Input. The Direct Loop needs none
+                    if(Cols.Data == NULL || (Block > 1 && Product.Data == NULL))
+                    {
+                        FreeTensor(&Product);
+                        FreeTensor(&Cols);
+                        ReleaseArena(Space, Mark);
+
+                        ConvForwDirect(Input, Output, Filters, Params, Workers);
+                        return;
+                    }
+
+                // --- Convolution --- //
+
+                    ConvForwArgs Args = {Input, Output, Filters, Params, Cols.Data, Product.Data, 0, Block, 0, 0, 0};
+
+                    for(int sample = 0; sample < Input->Dims[0]; sample += Block)
+                    {
+                        Args.Sample = sample;
+                        Args.Samples = Input->Dims[0] - sample < Block ? Input->Dims[0] - sample : Block;
+
+                        // The last group can be smaller, and then has fewer Rows to split
+                        int Tiles = GemmTiles(&Args, Workers);
+
+                        if(Block == 1)
+                        {
+                            Args.Product = TensorRow(Output, sample, 0, 0);
+                        }
+
+                        ParallelFor(Workers, Args.Samples * Input->Dims[1], Im2ColTask, &Args);
+                        ParallelFor(Workers, Tiles, GemmTask, &Args);
+
+                        if(Block > 1)
+                        {
+                            ParallelFor(Workers, Args.Samples * Output->Dims[1], ScatterTask, &Args);
+                        }
+                    }
+
+                // --- Apply Act Func and Overflow Control. Groups were activated while Scattered --- //
+
+                    if(Block == 1)
+                    {
+                        ActivateTensor(Output, Params[0], Workers);
+                    }
+
+                // --- Free --- //
+
+                    FreeTensor(&Product);
+                    FreeTensor(&Cols);
+                    ReleaseArena(Space, Mark);
+            }
+
+        // 4.1.3 --- Transformed --- //
+
+            /*
+                Calculate Conv Layer Forward Propagation with Winograd F(2x2,3x3) / F(4x4,3x3), or with FFT.
+                Only valid for Stride 1. Transformed Filters are kept in Cache until the next Weight Update.
+
+                Input - Input Volumes
+                Output - Where to place Output
+                Filters - Kernel Weights {NKernels, Channels, KernelSize, KernelSize}
+                Params - LayerParams
+                Cache - Cache of the Layer. Can be NULL
+                Algorithm - ConvWinograd or ConvFFT
+                Tile - Winograd Output Tile or FFT size
+                Workers - Threads to split Tiles among. Can be NULL
+
+                Return Value - Nothing
+            */
+
+            static void ConvForwTransformed(Tensor* Input, Tensor* Output, Tensor* Filters, double* Params, ConvCache* Cache, char Algorithm, int Tile, ThreadPool* Workers)
+            {
+                // Not enough memory for the Transforms. Gemm needs less
+                if(TransformedConv(Input, Output, Filters, Cache, Algorithm, ConvForward, Tile, Params[4], Workers) != 0)
+                {
+                    ConvForwGemm(Input, Output, Filters, Params, Workers);
+                    return;
+                }
+
+                // --- Apply Act Func and Overflow Control--- //
+
+                    ActivateTensor(Output, Params[0], Workers);
+            }
+
+        // 4.1.4 --- Forward --- //
+
+            /*
+                Calculate Conv Layer Forward Propagation
+
+                Input - Input Volumes
+                Output - Where to place Output
+                Filters - Kernel Weights {NKernels, Channels, KernelSize, KernelSize}
+                Params - LayerParams
+                [0] = Act;                // 0 means no Act Function (changed if add_act is called)
+                [1] = NKernels;           // How many Kernels
+                [2] = KernelSize;         // Kernel size. 2 means 2x2, 3 means 3x3
+                [3] = Stride;             // How many pixels Kernel moves at a time
+                [4] = Padding;            // How many 0 pixels are added to input before computing
+                Cache - Transformed Weights of this Layer. Can be NULL
+                Workers - Threads to use. Can be NULL. Results are the same for any Thread count
+
+
+                Return Value - Nothing
+            */
+
+            void ConvForwCpu(Tensor* Input,                                  // Input
+                             Tensor* Output,                                 // Output
+                             Tensor* Filters, double* Params,                // Weights + Params
+                             ConvCache* Cache,                               // Transformed Weights
+                             ThreadPool* Workers)                               // Threads
+
+            {
+                int Tile = 0;
+
+                char Algorithm = PickConvAlgorithm(ConvForward, Input->Dims[1], Params[1], Params[2], Params[3], Output->Dims[2], Output->Dims[3], Cache, &Tile);
+
+                switch(Algorithm)
+                {
+                    case ConvWinograd:
+                    case ConvFFT:
+                                ConvForwTransformed(Input, Output, Filters, Params, Cache, Algorithm, Tile, Workers);
+                                break;
+
+                    case ConvGemm:
+                                ConvForwGemm(Input, Output, Filters, Params, Workers);
+                                break;
+
+                    default:
+                                ConvForwDirect(Input, Output, Filters, Params, Workers);
+                                break;
+                }
+            }
+
+        // 4.1.5 --- Fused Pool --- //
+
+            // Arguments of ConvPoolTask
+            typedef struct
+            {
+                ConvForwArgs Forward;       // Convolution of the Band. Forward.Output holds the Dimensions of the Band
+
+                Tensor* Pooled;             // Pool Output
+                double* PoolParams;
+                Tensor* Mask;               // Position of every Max in its Conv Output Channel, as PoolForwCpu places them. NULL if not needed
+
+                double* Band;               // Conv Output Rows of the Band, before the Act Func
+                size_t KernelStride;        // Elements between Kernels in Band
+                size_t SampleStride;        // Elements between Samples in Band
+                int FirstPool;              // First Pool Output Row of the Band
+
+            } ConvPoolArgs;
+
+            // Activate and Pool Kernels [Start, End) of the Band. Item i is Kernel i % NKernels of Sample i / NKernels of the group
+            static void ConvPoolTask(void* Args, int Start, int End, int Thread)
+            {
+                (void) Thread;
+
+                ConvPoolArgs* Task = Args;
+                Tensor* Pooled = Task->Pooled;
+
+                int ConvWidth = Task->Forward.Output->Dims[3];
+                int FirstRow = Task->Forward.FirstRow;
+                int PoolRows = (Task->Forward.Output->Dims[2] - (int) Task->PoolParams[1]) / (int) Task->PoolParams[3] + 1;
+
+                double Act = Task->Forward.Params[0];
+                int Window = Task->PoolParams[1];
+                int Stride = Task->PoolParams[3];
+
+                for(int i = Start; i < End; ++i)
+                {
+                    int sample = Task->Forward.Sample + i / Pooled->Dims[1];
+                    int kernel = i % Pooled->Dims[1];
+
+                    double* Band = Task->Band + (i / Pooled->Dims[1]) * Task->SampleStride + kernel * Task->KernelStride;
+
+                    // Activate the Rows the Pool Windows cover once, in place. Overlapping Windows share them
+                    int First = Task->FirstPool * Stride - FirstRow;
+                    int Last = (Task->FirstPool + PoolRows - 1) * Stride + Window - FirstRow;
+
+                    ActivateRow(Band + First * ConvWidth, (Last - First) * ConvWidth, Act);
+
+                    // Pool the Activated Rows the same way as PoolForwCpu, so the same Max is picked
+                    for(int outy = Task->FirstPool; outy < Task->FirstPool + PoolRows; ++outy)
+                    {
+                        double* Out = TensorRow(Pooled, sample, kernel, outy);
+                        int* Max = Task->Mask != NULL ? PoolArgmax(Task->Mask, sample) + (kernel * Pooled->Dims[2] + outy) * Pooled->Dims[3] : NULL;
+
+                        PoolRowCpu(Band + (outy * Stride - FirstRow) * ConvWidth, ConvWidth, outy * Stride * ConvWidth, Task->PoolParams, Pooled->Dims[3], Out, Max);
+
+                        // Pool Act Func. Values are already below MaxValue, so Overflow Control changes nothing
+                        ActivateRow(Out, Pooled->Dims[3], Task->PoolParams[0]);
+                    }
+                }
+            }
 
-            Input - Input Volume
-            Filters - Kernel Weights
-            StartX - X position of Input
-            StartY - Y position of Input
-            FilterSize - KernelSize ( 2 means 2x2, 3 means 3x3, etc...)
+            /*
+                Split the Conv Output of a fused Pool Layer in Bands. Small Outputs are done for a group of Samples at once, as in ConvForwGemm.
+                Big ones a few Pool Rows at a time, so the Band is at least ConvGemmColumns wide but still fits in cache
 
-            Return Value - Convolution Result
-        */
+                ConvWidth - Conv Output Width
+                ConvPixels - Conv Output Pixels of one Sample
+                PoolHeight - Pool Output Height
+                PoolParams - LayerParams of the Pool Layer
+                Samples - Samples in the Input
+                Whole - 1 to keep all Rows of a Sample in one Band, for Winograd and FFT
+                Block - Where to place the Samples of a Band
+                PoolRows - Where to place the Pool Output Rows of a Band
 
-        static double Convolution(double** Input, double** Filters, int StartX, int StartY, int FilterSize)
-        {
-        	double out = 0;
+                Return Value - Nothing
+            */
 
-            // Convolve Kernel with Pixels
-            for(int y = 0; y < FilterSize; ++y)
+            static void PoolBands(int ConvWidth, int ConvPixels, int PoolHeight, double* PoolParams, int Samples, char Whole, int* Block, int* PoolRows)
             {
-                for(int x = 0 ; x < FilterSize; ++x)
+                int Window = PoolParams[1];
+                int Stride = PoolParams[3];
+
+                *Block = GemmSampleBlock(ConvPixels, Samples);
+                *PoolRows = PoolHeight;
+
+                if(*Block > 1 || Whole)
+                {
+                    return;
+                }
+
+                *PoolRows = 1;
+                while(*PoolRows < PoolHeight && ((*PoolRows - 1) * Stride + Window) * ConvWidth < ConvGemmColumns)
                 {
-                    out += Input[StartY + y][StartX + x] * Filters[y][x];
+                    ++*PoolRows;
                 }
             }
 
-        	return out;
-        }
+            /*
+                Calculate a Conv Layer and the Pool Layer after it in one pass, so the full Conv Output is never stored.
+                The Conv Output is computed a Band at a time into the Scratch Arena, then Activated and Pooled while it is still in cache.
+                Bands are whole Samples with Winograd and FFT, which transform whole Images.
+                Results are the same as ConvForwCpu followed by PoolForwCpu
 
-// 2 --- Layer Propagation --- //
+                Input - Input Volumes
+                Output - Pool Output
+                Filters - Kernel Weights {NKernels, Channels, KernelSize, KernelSize}
+                ConvParams - LayerParams of the Conv Layer
+                PoolParams - LayerParams of the Pool Layer
+                Mask - Where to place the Position (y * ConvWidth + x) of every Max in its Conv Output Channel. Made with FitPoolMask, as for PoolForwCpu. Can be NULL
+                Cache - Transformed Weights of the Conv Layer. Can be NULL
+                Workers - Threads to use. Can be NULL. Results are the same for any Thread count
 
-    // 2.1 --- Forward Propagation --- //
+                Return Value - Nothing
+            */
 
-        /*
-            Calculate Conv Layer Forward Propagation 
+            void ConvPoolForwCpu(Tensor* Input,                                  // Input
+                                 Tensor* Output,                                 // Pool Output
+                                 Tensor* Filters, double* ConvParams,            // Conv Weights + Params
+                                 double* PoolParams,                             // Pool Params
+                                 Tensor* Mask,                                   // Max Positions
+                                 ConvCache* Cache,                               // Transformed Weights
+                                 ThreadPool* Workers)                            // Threads
+            {
+                int NKernels = ConvParams[1];
+                int KernelSize = ConvParams[2];
+                int Stride = ConvParams[3];
+                int Padding = ConvParams[4];
 
-            Input - Input Volume
-            InDims - Input Volume Dimensions
-            Output - Where to place Output
-            Filters - Kernel Weights
-            Params - LayerParams
-            [0] = Act;                // 0 means no Act Function (changed if add_act is called)
-            [1] = NKernels;           // How many Kernels
-            [2] = KernelSize;         // Kernel size. 2 means 2x2, 3 means 3x3
-            [3] = Stride;             // How many pixels Kernel moves at a time
-            [4] = Padding;            // How many 0 pixels are added to input before computing
+                int ConvHeight = (Input->Dims[2] - KernelSize + 2 * Padding) / Stride + 1;
+                int ConvWidth = (Input->Dims[3] - KernelSize + 2 * Padding) / Stride + 1;
 
+                int Tile = 0;
+                char Algorithm = PickConvAlgorithm(ConvForward, Input->Dims[1], NKernels, KernelSize, Stride, ConvHeight, ConvWidth, Cache, &Tile);
 
-            Return Value - Nothing
-        */
+                // --- Bands, and the Lowered Input of a Band --- //
 
-        void ConvForwCpu(double*** Input, int* InDims,                   // Input
-                         double*** Output,                               // Output
-                         double**** Filters, double* Params)             // Weights + Params
+                    int Block, PoolRows;
+                    PoolBands(ConvWidth, ConvHeight * ConvWidth, Output->Dims[2], PoolParams, Input->Dims[0], Algorithm == ConvWinograd || Algorithm == ConvFFT, &Block, &PoolRows);
 
-        {
-            // --- Pad Input --- //
+                    int BandDims[3] = {NKernels, (PoolRows - 1) * (int) PoolParams[3] + (int) PoolParams[1], ConvWidth};
+                    int ColDims[3] = {1, Input->Dims[1] * KernelSize * KernelSize, Block * BandDims[1] * ConvWidth};
 
-                // Input Dimensions
-                int PadDims[3];
-                PadDims[0] = InDims[0];
-                PadDims[1] = InDims[1] + 2 * Params[4];
-                PadDims[2] = PadDims[1];
+                    Arena* Space = ScratchArena();
+                    size_t Mark = Space->Used;
 
-                // Padding Operation
-                double*** Padded = Init3D(PadDims);
-                Pad(Input, Padded, InDims, Params[4]);
+                    Tensor Band = ArenaTensor(Space, Block, BandDims);
+                    Tensor Cols = {0};
 
-            // --- Convolution --- //
+                    if(Band.Data == NULL)
+                    {
+                        printf("Memory Allocation Error.\n");
+                        exit(MemoryError);
+                    }
 
-                for(int kernel = 0; kernel < Params[1]; ++kernel)
-                {
-                    // Output Counters
-                    int outy = 0;
-                    int outx = 0;
+                    // Not enough memory for the Lowered Input. The Direct Loop needs none
+                    if(Algorithm == ConvGemm)
+                    {
+                        Cols = ArenaTensor(Space, 1, ColDims);
+                        Algorithm = Cols.Data != NULL ? ConvGemm : ConvDirect;
+                    }
 
-                    for(int y = 0; y <= PadDims[1] - Params[2]; y += Params[3])             // Input img Y
+                    // The Direct Loop leaves the Act Func to ConvPoolTask. Overflow Control twice changes nothing
+                    double DirectParams[5] = {0, ConvParams[1], ConvParams[2], ConvParams[3], ConvParams[4]};
+
+                // --- Go Through every Band --- //
+
+                    ConvPoolArgs Args = {{Input, NULL, Filters, ConvParams, Cols.Data, Band.Data, 0, 0, 0, 0, 0}, Output, PoolParams, Mask, Band.Data, 0, 0, 0};
+
+                    for(int sample = 0; sample < Input->Dims[0]; sample += Block)
                     {
-                        for(int x = 0; x <= PadDims[1] - Params[2]; x += Params[3])         // Input img X
+                        int Samples = Input->Dims[0] - sample < Block ? Input->Dims[0] - sample : Block;
+
+                        for(int First = 0; First < Output->Dims[2]; First += PoolRows)
                         {
-                            for(int channel = 0; channel < InDims[0]; ++channel)            // Input img channels
-                            {
-                                // --- Calc Convolution --- //
+                            // Conv Output Rows the Pool Windows of the Band cover
+                            int Pools = Output->Dims[2] - First < PoolRows ? Output->Dims[2] - First : PoolRows;
+                            int Dims[3] = {NKernels, (Pools - 1) * (int) PoolParams[3] + (int) PoolParams[1], ConvWidth};
 
-                                    Output[kernel][outy][outx] += Convolution(Padded[channel], Filters[kernel][channel], x, y, Params[2]);
-                            }
+                            Tensor Rows = ViewTensor(Band.Data, Samples, Dims);
 
-                            // --- Apply Act Func and Overflow Control--- //
+                            Args.Forward.Output = &Rows;
+                            Args.Forward.Sample = sample;
+                            Args.Forward.Samples = Samples;
+                            Args.Forward.FirstRow = First * (int) PoolParams[3];
+                            Args.FirstPool = First;
 
-                            	if(Output[kernel][outy][outx] > MaxValue)
-                            	{
-                            		Output[kernel][outy][outx] = MaxValue;
-                            	}
+                            // Gemm leaves Kernels of the group side by side, the others write Volumes
+                            Args.KernelStride = Dims[1] * Dims[2];
+                            Args.SampleStride = Rows.Strides[0];
 
-                                if(Params[0] == ReLu)
+                            // --- Conv Output of the Band --- //
+
+                                if(Algorithm == ConvWinograd || Algorithm == ConvFFT)
                                 {
-                                    Output[kernel][outy][outx] = Output[kernel][outy][outx] > 0 ? Output[kernel][outy][outx] : 0;
+                                    Tensor Group = ViewTensor(TensorRow(Input, sample, 0, 0), Samples, &(Input->Dims[1]));
+
+                                    // Not enough memory for the Transforms. The Direct Loop needs none
+                                    if(TransformedConv(&Group, &Rows, Filters, Cache, Algorithm, ConvForward, Tile, Padding, Workers) != 0)
+                                    {
+                                        Algorithm = ConvDirect;
+                                    }
                                 }
-                                else if(Params[0] == Sigmoid)
+
+                                if(Algorithm == ConvGemm)
                                 {
-                                    Output[kernel][outy][outx] = 1/(double)(1 + exp(-Output[kernel][outy][outx]));
+                                    int Tiles = GemmTiles(&(Args.Forward), Workers);
+
+                                    Args.KernelStride = (size_t) Samples * Dims[1] * Dims[2];
+                                    Args.SampleStride = Dims[1] * Dims[2];
+
+                                    ParallelFor(Workers, Samples * Input->Dims[1], Im2ColTask, &(Args.Forward));
+                                    ParallelFor(Workers, Tiles, GemmTask, &(Args.Forward));
                                 }
-                                else if(Params[0] == Tanh)
+                                else if(Algorithm == ConvDirect)
                                 {
-                                    Output[kernel][outy][outx] = tanh(Output[kernel][outy][outx]);
+                                    Args.Forward.Params = DirectParams;
+                                    ParallelFor(Workers, Samples * NKernels * Dims[1], ConvDirectTask, &(Args.Forward));
+                                    Args.Forward.Params = ConvParams;
                                 }
 
-                            // Go Right
-                            ++outx;
-                        }
-                        
-                        // Come Back
-                        outx = 0;
+                            // --- Act Func and Pool --- //
 
-                        // Move Down
-                        ++outy;
+                                ParallelFor(Workers, Samples * NKernels, ConvPoolTask, &Args);
+                        }
                     }
-                }
 
-            // --- Free --- //
+                // --- Free --- //
 
-                Free3D(Padded);
-        }
+                    FreeTensor(&Cols);
+                    FreeTensor(&Band);
+                    ReleaseArena(Space, Mark);
+            }
 
-    // 2.2 --- Backward Propagation --- //
+    // 4.2 --- Backward Propagation --- //
 
-        /*
-            Calculate Conv Layer Backward Propagation
-
-            PrevInput - Input Volume from previous ForwardPropagation
-            InDims - PrevInput Dimensions
-            PrevOutput - Output Volume from previous ForwardPropagation
-            OutDims - Output  Dimensions
-            Error - Error from Next Layer
-            Output - Output ( Error to backprop onto previous Layer)
-            Filters - Weights
-            Params - LayerParams
-                [0] = Act;                // 0 means no Act Function (changed if add_act is called)
-                [1] = NKernels;           // How many Kernels
-                [2] = KernelSize;         // Kernel size. 2 means 2x2, 3 means 3x3
-                [3] = Stride;             // How many pixels Kernel moves at a time
-                [4] = Padding;            // How many 0 pixels are added to input before computing
-            LearningRate - LearningRate
+        // 4.2.1 --- Delta --- //
 
-            Return Value - Nothing
-        */
+            /*
+                Apply the Activation Derivative to the Error.
 
-        void ConvBackCpu(double*** PrevInput, int* InDims,                           // Varibles to Calculate Weight Updates
-                         double*** PrevOutput, int* OutDims, double*** Error,         // Variables to Calculate Delta
-                         double*** Output,                                           // Variable to Store Error from this layer
-                         double**** Filters, double* Params,                          // Weights + Params
-                         double LearningRate)                                        // Learning Rate
-        {
-            /* Params
-            [0] = Act;                 // 0 means no Act Function (changed if add_act is called)
-            [1] = NKernels;           // How many Kernels
-            [2] = KernelSize;         // Kernel size. 2 means 2x2, 3 means 3x3
-            [3] = Stride;             // How many pixels Kernel moves at a time
-            [4] = Padding;            // How many 0 pixels are added to input before computing
+                Activation Function is applied with a "Shortcut".
+                Sigmoid For example. Forward means Sigmoid(x)
+                Sigmoid Derivative = Sigmoid(x) * (1 - Sigmoid(x))
+                The "Shortcut" means we simply take x * (1 - x), since the x we get as Input Parameter
+                is the one after activation function, and not before.
+
+                Delta is kept Kernel major, {NKernels, Samples * OutPixels}, so the Deltas of a group of Samples are one Gemm Operand
+
+                PrevOutput - Output Volumes from previous ForwardPropagation
+                Error - Error from Next Layer
+                Params - LayerParams
+                Delta - Where to place Delta
+
+                Return Value - Nothing
             */
-            
-            // --- Apply Act Func and Setup Delta --- //
-    
-                // Activation Function is applied with a "Shortcut".
-                // Sigmoid For example. Forward means Sigmoid(x)
-                // Sigmoid Derivative = Sigmoid(x) * (1 - Sigmoid(x))
-                // The "Shortcut" means we simply take x * (1 - x), since the x we get as Input Parameter 
-                // is the one after activation function, and not before.
-
-
-                //  If Stride > 1 instead of a Full Convolution in step 2.1, 
-                //  a Fractionally Strided Convolution needs to be done instead.
-                //  A Fractionally Strided Convolution is the same as a Full Convolution,
-                //  aslong as Delta is setup Correctly.
-                //
-                //  If Stride is 2 for example, we need to pad Delta like so.
-                //
-                //  d1  0   d2  0   d3
-                //  0   0   0   0   0
-                //  d4  0   d5  0   d6
-                //  0   0   0   0   0
-                //  d7  0   d8  0   d9
-                //
-                //  One possible way to calculate Error dimensions is by the Equation
-                //  Size + (Size - 1) * (Stride - 1)
-                //  3 + ( 3 - 1 ) * (2 - 1) = 5
-
-                // Calculate DeltaDimensions
-                int DeltaDims[3];
-                DeltaDims[0] = OutDims[0];
-                DeltaDims[1] = OutDims[1] + ((OutDims[1] - 1) * (Params[3] - 1));
-                DeltaDims[2] = DeltaDims[1];
-
-                // Init array with zeroes
-                double*** Delta = Init3D(DeltaDims);
-
-                // Put the Value ( Depending on Activation Function ) in the Correct Spots
-                if(Params[0] == ReLu)
-                {
-                    for(int channel = 0; channel < OutDims[0]; ++channel)
-                    {  
-                        for(int y = 0; y < OutDims[1]; ++y)
+
+            static void ConvDelta(Tensor* PrevOutput, Tensor* Error, double* Params, double* Delta)
+            {
+                int Samples = PrevOutput->Dims[0];
+                int OutPixels = PrevOutput->Dims[2] * PrevOutput->Dims[3];
+
+                for(int sample = 0; sample < Samples; ++sample)
+                {
+                    for(int kernel = 0; kernel < PrevOutput->Dims[1]; ++kernel)
+                    {
+                        double* Out = TensorRow(PrevOutput, sample, kernel, 0);
+                        double* Err = TensorRow(Error, sample, kernel, 0);
+                        double* Del = Delta + ((size_t) kernel * Samples + sample) * OutPixels;
+
+                        if(Params[0] == ReLu)
                         {
-                            for(int x = 0; x < OutDims[1]; ++x)
+                            for(int p = 0; p < OutPixels; ++p)
                             {
-                                Delta[channel][(int) (y * Params[3])][(int) (x * Params[3])] =  PrevOutput[channel][x][y] > 0 ? Error[channel][y][x] : 0;
+                                Del[p] = Out[p] > 0 ? Err[p] : 0;
                             }
                         }
-                    }
-                }
-                else if(Params[0] == Sigmoid)
-                {
-                    for(int channel = 0; channel < OutDims[0]; ++channel)
-                    {
-                        for(int y = 0; y < OutDims[1]; ++y)
+                        else if(Params[0] == Sigmoid)
                         {
-                            for(int x = 0; x < OutDims[1]; ++x)
+                            for(int p = 0; p < OutPixels; ++p)
                             {
-                                Delta[channel][(int) (y * Params[3])][(int) (x * Params[3])] = PrevOutput[channel][y][x] * (1 - PrevOutput[channel][y][x]) * Error[channel][y][x];
+                                Del[p] = Out[p] * (1 - Out[p]) * Err[p];
                             }
                         }
-                    }
-                }
-                else if(Params[0] == Tanh)  
-                {   
-                    for(int channel = 0; channel < OutDims[0]; ++channel)
-                    {
-                        for(int y = 0; y < OutDims[1]; ++y)
+                        else if(Params[0] == Tanh)
                         {
-                            for(int x = 0; x < OutDims[1]; ++x)
+                            for(int p = 0; p < OutPixels; ++p)
                             {
-                                Delta[channel][(int) (y * Params[3])][(int) (x * Params[3])] = (1 - pow(PrevOutput[channel][y][x], 2)) * Error[channel][y][x];
+                                Del[p] = (1 - Out[p] * Out[p]) * Err[p];
                             }
                         }
+                        else            // No activation Function
+                        {
+                            memcpy(Del, Err, OutPixels * sizeof(double));
+                        }
                     }
                 }
-                else            // No activation Function
+            }
+
+            /*
+                Spread Delta over a Sample major Volume, for the Direct Loop, Winograd and FFT.
+
+                If Stride > 1 instead of a Full Convolution,
+                a Fractionally Strided Convolution needs to be done instead.
+                A Fractionally Strided Convolution is the same as a Full Convolution,
+                aslong as Delta is setup Correctly.
+
+                If Stride is 2 for example, we need to pad Delta like so.
+
+                d1  0   d2  0   d3
+                0   0   0   0   0
+                d4  0   d5  0   d6
+                0   0   0   0   0
+                d7  0   d8  0   d9
+
+                One possible way to calculate Error dimensions is by the Equation
+                Size + (Size - 1) * (Stride - 1)
+                3 + ( 3 - 1 ) * (2 - 1) = 5
+
+                Delta - Delta from ConvDelta
+                Dilated - Where to place Delta, {Samples, NKernels, Size + (Size - 1) * (Stride - 1)}
+                OutHeight - Output Height of the Layer
+                OutWidth - Output Width of the Layer
+                Stride - Stride of the Layer
+
+                Return Value - Nothing
+            */
+
+            static void DilateDelta(double* Delta, Tensor* Dilated, int OutHeight, int OutWidth, int Stride)
+            {
+                int Samples = Dilated->Dims[0];
+
+                // Only the Spots between Strides stay zero
+                if(Stride > 1)
+                {
+                    ZeroTensor(Dilated);
+                }
+
+                for(int sample = 0; sample < Samples; ++sample)
                 {
-                    for(int channel = 0; channel < OutDims[0]; ++channel)
+                    for(int kernel = 0; kernel < Dilated->Dims[1]; ++kernel)
                     {
-                        for(int y = 0; y < OutDims[1]; ++y)
+                        double* Del = Delta + ((size_t) kernel * Samples + sample) * OutHeight * OutWidth;
+
+                        for(int y = 0; y < OutHeight; ++y)
                         {
-                            for(int x = 0; x < OutDims[1]; ++x)
+                            double* Row = TensorRow(Dilated, sample, kernel, y * Stride);
+
+                            for(int x = 0; x < OutWidth; ++x)
                             {
-                                Delta[channel][(int) (y * Params[3])][(int) (x * Params[3])] =  Error[channel][y][x];
+                                Row[x * Stride] = Del[y * OutWidth + x];
                             }
                         }
                     }
                 }
+            }
+
+        // 4.2.2 --- Gemm --- //
+
+            /*
+                Calculate the Weight Gradients, and the Input Gradient if asked, as Matrix Products, a group of Samples at a time.
 
-        	// 2 --- Calculate Output and Update Weights--- //
+                The Input of a group is lowered with Im2Col to Cols {Channels * KernelSize^2, Samples * OutPixels}, as in ConvForwGemm. Then
+                    Gradients += Delta x Cols'          sums the Gradients of the whole group in one Gemm
+                    Cols = Filters' x Delta             gives the Error of every Window, which Col2Im adds back to the Input Pixels
+                Only real Deltas are multiplied. The zeroes a Strided Layer puts between them are never seen.
 
-                // Full Convolution between Delta and Weights.
-                // To Calculate this, we first need to Pad Delta by KernelSize - 1, so the Full Convolution can be done like a regular convolution
+                PrevInput - Input Volumes from previous ForwardPropagation
+                Delta - Delta from ConvDelta
+                OutHeight - Output Height of the Layer
+                OutWidth - Output Width of the Layer
+                Output - Where to place the Input Gradient. NULL for Weight Gradients only
+                Filters - Weights {NKernels, Channels, KernelSize, KernelSize}
+                Params - LayerParams
+                Gradients - Weight Gradients. This Layer's Gradients are added to it. NULL for the Input Gradient only
 
-                // Calculate Dimensions
-                int DeltaPadDims[3];
-                DeltaPadDims[0] = DeltaDims[0];
-                DeltaPadDims[1] = DeltaDims[1] + 2 * (Params[2] - 1);
-                DeltaPadDims[2] = DeltaPadDims[1];
+                Return Value - 0, or 1 if there isn't enough memory for the Lowered Input. Nothing is calculated then
+            */
+
+            static int ConvBackGemm(Tensor* PrevInput, double* Delta, int OutHeight, int OutWidth, Tensor* Output, Tensor* Filters, double* Params, Tensor* Gradients)
+            {
+                int KernelSize = Params[2];
+                int Stride = Params[3];
+                int Padding = Params[4];
+
+                int Samples = PrevInput->Dims[0];
+                int NKernels = Filters->Dims[0];
+                int Depth = Filters->Strides[0];
+                int OutPixels = OutHeight * OutWidth;
+                int Block = GemmSampleBlock(OutPixels, Samples);
 
-                // Apply Padding
-                double*** DeltaPadded = Init3D(DeltaPadDims);
-                Pad(Delta, DeltaPadded, DeltaDims, Params[2] - 1);
+                // --- Lowered Input of a group. Every Value is written by Im2Col or Gemm --- //
 
-                // Now that Delta is padded, we can Calculate the Full Convolution by doing a Normal Convolution with DeltaPadded instead of Delta
+                    int ColDims[3] = {1, Depth, Block * OutPixels};
+
+                    Arena* Space = ScratchArena();
+                    size_t Mark = Space->Used;
+
+                    Tensor Cols = ArenaTensor(Space, 1, ColDims);
+                    if(Cols.Data == NULL)
+                    {
+                        ReleaseArena(Space, Mark);
+                        return 1;
+                    }
 
-                // Output has InDims[0] Channels. Delta has NKernels Channels. Weights have Nkernels size and InDims[0] Channels.
-                // In forward propagation, In[InChannel] connects to Out[OutChannel] via Filters[OutChannel][InChannel]. 
-                // To do this Backwards, to Calculate Out[InChannel] need to sum Delta[OutChannel]*Filter[OutChannel][InChannel] for all OutChannels(NKernels).
+                // --- Gradients --- //
 
-                // Each iteration Calculates 1 Output Channel
-            	for (int channel = 0; channel < InDims[0]; ++channel)          
-                {   
-                    // Counters to place Output values in correct spots
-                    int outy = 0;                               
-                    int outx = 0;
+                    // Col2Im adds every Window to Output
+                    if(Output != NULL)
+                    {
+                        ZeroTensor(Output);
+                    }
 
-                    // Go through Y and X. Since after this operation we would need to remove padding(if > 1),
-                    // we can start the FullConv at (Y,X) = (Padding, Padding) and end at (Y, X) = (OutDims - KernelSize - Pad, OutDims - KernelSize - Pad)
-                    // so the padding points which would be removed aren't calculated.
-                    for(int y = Params[4]; y <= DeltaPadDims[1] - Params[2] - Params[4]; ++y)
+                    for(int sample = 0; sample < Samples; sample += Block)
                     {
-                        for(int x = Params[4]; x <= DeltaPadDims[1] - Params[2] - Params[4]; ++x)
+                        int Group = Samples - sample < Block ? Samples - sample : Block;
+                        int Columns = Group * OutPixels;
+
+                        double* GroupDelta = Delta + (size_t) sample * OutPixels;
+
+                        if(Gradients != NULL)
                         {
-                            // We go Through all the Kernels for this Output Channel, and sum the output of respective convolution results
-                            for(int kernel = 0; kernel < Params[1]; ++kernel)       
+                            for(int i = 0; i < Group; ++i)
                             {
-                                // Convolution
-                                Output[channel][outy][outx] += Convolution(DeltaPadded[kernel], Filters[kernel][channel], x, y, Params[2]);
+                                Im2Col(PrevInput, sample + i, 0, PrevInput->Dims[1], Cols.Data + i * OutPixels, Columns, KernelSize, Stride, Padding, 0, OutHeight, OutWidth);
                             }
 
-                            // Go right
-                            ++outx;
+                            Gemm(NoTrans, Trans, NKernels, Depth, Columns,
+                                 1, GroupDelta, Samples * OutPixels,
+                                 Cols.Data, Columns,
+                                 1, Gradients->Data, Depth);
+                        }
+
+                        // The Lowered Input is no longer needed, so Cols takes the Error of every Window
+                        if(Output != NULL)
+                        {
+                            Gemm(Trans, NoTrans, Depth, Columns, NKernels,
+                                 1, Filters->Data, Depth,
+                                 GroupDelta, Samples * OutPixels,
+                                 0, Cols.Data, Columns);
+
+                            for(int i = 0; i < Group; ++i)
+                            {
+                                Col2Im(Cols.Data + i * OutPixels, Columns, Output, sample + i, KernelSize, Stride, Padding, OutHeight, OutWidth);
+                            }
                         }
+                    }
+
+                // --- Free --- //
+
+                    FreeTensor(&Cols);
+                    ReleaseArena(Space, Mark);
+
+                return 0;
+            }
+
+        // 4.2.3 --- Direct --- //
+
+            /*
+                Calculate the Input Gradient with the Reference Loop.
+
+                Full Convolution between Delta and Weights.
+                Output has InDims[0] Channels. Delta has NKernels Channels. Weights have Nkernels size and InDims[0] Channels.
+                In forward propagation, In[InChannel] connects to Out[OutChannel] via Filters[OutChannel][InChannel].
+                To do this Backwards, to Calculate Out[InChannel] need to sum Delta[OutChannel]*Filter[OutChannel][InChannel] for all OutChannels(NKernels).
+                A Full Convolution slides the Filter rotated by 180 degrees, so Rotated[InChannel][OutChannel] holds Filter[OutChannel][InChannel] flipped in Y and X.
+
+                Dilated - Delta from DilateDelta
+                Output - Where to place the Input Gradient
+                Filters - Weights {NKernels, Channels, KernelSize, KernelSize}
+                Params - LayerParams
+
+                Return Value - Nothing
+            */
+
+            static void ConvBackDirect(Tensor* Dilated, Tensor* Output, Tensor* Filters, double* Params)
+            {
+                int KernelSize = Params[2];
+                int Padding = Params[4];
+
+                int* DeltaDims = Dilated->Dims + 1;
+
+                Arena* Space = ScratchArena();
+                size_t Mark = Space->Used;
+
+                int RotatedDims[3] = {Filters->Dims[0], KernelSize, KernelSize};
+
+                Tensor Rotated = ArenaTensor(Space, Filters->Dims[1], RotatedDims);
+                if(Rotated.Data == NULL)
+                {
+                    printf("Memory Allocation Error.\n");
+                    exit(MemoryError);
+                }
+
+                RotateFilters(Filters, &Rotated);
+
+                // A Full Convolution reads Delta as if Padded by KernelSize - 1. Since after this operation we would need to remove padding(if > 1),
+                // the FullConv starts at (Y,X) = (Padding, Padding), so Window (outy, outx) starts at Delta pixel (outy, outx) + Padding - (KernelSize - 1).
+                // Taps outside Delta would read the Padding zeroes, so they are skipped instead of Padding Delta.
+                int Offset = Padding - (KernelSize - 1);
+
+                // Output Columns in [InteriorStart, InteriorEnd) have their whole Window inside Delta
+                int InteriorStart, InteriorEnd;
+                ValidRange(Offset, 1, DeltaDims[2] - KernelSize + 1, Output->Dims[3], &InteriorStart, &InteriorEnd);
 
-                        // Come Back
-                        outx = 0;
+                for(int sample = 0; sample < Output->Dims[0]; ++sample)
+                {
+                    // Each iteration Calculates 1 Output Channel
+                	for (int channel = 0; channel < Output->Dims[1]; ++channel)
+                    {
+                        for(int outy = 0; outy < Output->Dims[2]; ++outy)
+                        {
+                            // Rows of the Window inside Delta
+                            int dy = outy + Offset;
+                            int FirstY, LastY;
+                            ValidRange(dy, 1, DeltaDims[1], KernelSize, &FirstY, &LastY);
+
+                            for(int outx = 0; outx < Output->Dims[3]; ++outx)
+                            {
+                                double Value = 0;
+
+                                // Columns of the Window inside Delta. Only Border Columns need clipping
+                                int dx = outx + Offset;
+                                int FirstX = 0, LastX = KernelSize;
+
+                                if(outx < InteriorStart || outx >= InteriorEnd)
+                                {
+                                    ValidRange(dx, 1, DeltaDims[2], KernelSize, &FirstX, &LastX);
+                                }
+
+                                // We go Through all the Kernels for this Output Channel, and sum the output of respective convolution results
+                                for(int kernel = 0; kernel < Params[1]; ++kernel)
+                                {
+                                    // Convolution
+                                    Value += Convolution(TensorRow(Dilated, sample, kernel, dy + FirstY) + dx + FirstX, Dilated->Strides[2],
+                                                         TensorRow(&Rotated, channel, kernel, FirstY) + FirstX, Rotated.Strides[2], LastY - FirstY, LastX - FirstX);
+                                }
 
-                        // Go Down
-                        ++outy;
+                                TensorAt(Output, sample, channel, outy, outx) = Value;
+                            }
+                        }
                     }
                 }
 
-            // --- Update Weights --- //
+                FreeTensor(&Rotated);
+                ReleaseArena(Space, Mark);
+            }
+
+            /*
+                Calculate the Weight Gradients with the Reference Loop.
 
-                // Convolution between PrevInput with Delta ( Padded according to Stride, as mentioned in the Apply Act Section ) as the Filter
+                Convolution between PrevInput and Delta as the Filter, with Delta spread by the Stride.
+                Delta is as big as the Padded Input minus KernelSize - 1, so the Valid Convolution gives one value for every Weight.
+                Weight (y, x) reads Input pixel (y + outy * Stride, x + outx * Stride) - Padding, so the Outputs whose pixel falls in the Padding
+                add nothing, and are skipped instead of Padding PrevInput.
 
-                // Before computing, we need to Pad PrevInput, so Dimensions are correct
+                PrevInput - Input Volumes from previous ForwardPropagation
+                Delta - Delta from ConvDelta
+                OutHeight - Output Height of the Layer
+                OutWidth - Output Width of the Layer
+                Params - LayerParams
+                Gradients - Weight Gradients. This Layer's Gradients are added to it
 
-                int InPadDims[3];
-                InPadDims[0] = InDims[0];
-                InPadDims[1] = InDims[1] + 2*Params[4];
-                InPadDims[2] = InPadDims[1];
+                Return Value - Nothing
+            */
+
+            static void ConvBackDirectWeights(Tensor* PrevInput, double* Delta, int OutHeight, int OutWidth, double* Params, Tensor* Gradients)
+            {
+                int KernelSize = Params[2];
+                int Stride = Params[3];
+                int Padding = Params[4];
 
-                double*** PrevInputPadded = Init3D(InPadDims);
-                Pad(PrevInput, PrevInputPadded, InDims, Params[4]);
+                int Samples = PrevInput->Dims[0];
 
                 // Delta[i] corresponds to Kernel i
                 // Channel j of Kernel i is linked to Delta[i] via Input[j]
-                // For each Output Channel, go through all the Channels and update Filters[i][j] using convolution between Input[j] and Delta[i]
+                // For each Output Channel, go through all the Channels and add the convolution between Input[j] and Delta[i] to Gradients[i][j]
 
-                // Each iteration Calculates the Update to 1 Kernel
-                for(int kernel = 0; kernel < Params[1]; ++kernel)
+                for(int sample = 0; sample < Samples; ++sample)
                 {
-                    // Update Each Channel of the Kernel with the Output
-                    for(int channel = 0; channel < InDims[0]; ++channel)
+                    // Each iteration Calculates the Gradient of 1 Kernel
+                    for(int kernel = 0; kernel < Params[1]; ++kernel)
                     {
-                        // Go Through X and Y as a Normal Convolution
-                        for(int y = 0; y <= InPadDims[1] - DeltaPadDims[1]; ++y)
+                        double* KernelDelta = Delta + ((size_t) kernel * Samples + sample) * OutHeight * OutWidth;
+
+                        // Gradient of Each Channel of the Kernel
+                        for(int channel = 0; channel < PrevInput->Dims[1]; ++channel)
                         {
-                            for(int x = 0; x < InPadDims[1] - DeltaPadDims[1]; ++x)
+                            // Go Through X and Y as a Normal Convolution
+                            for(int y = 0; y < KernelSize; ++y)
                             {
-                                // Convolution
-                                Filters[kernel][channel][y][x] -= (LearningRate * Convolution(PrevInputPadded[channel], DeltaPadded[kernel], x, y, DeltaPadDims[1])); 
+                                // Outputs whose Input Row is inside PrevInput
+                                int FirstY, LastY;
+                                ValidRange(y - Padding, Stride, PrevInput->Dims[2], OutHeight, &FirstY, &LastY);
+
+                                for(int x = 0; x < KernelSize; ++x)
+                                {
+                                    double Value = 0;
+
+                                    // Outputs whose Input Column is inside PrevInput
+                                    int FirstX, LastX;
+                                    ValidRange(x - Padding, Stride, PrevInput->Dims[3], OutWidth, &FirstX, &LastX);
+
+                                    for(int outy = FirstY; outy < LastY; ++outy)
+                                    {
+                                        double* In = TensorRow(PrevInput, sample, channel, y - Padding + outy * Stride) + x - Padding + FirstX * Stride;
+                                        double* Del = KernelDelta + outy * OutWidth + FirstX;
+
+                                        for(int outx = 0; outx < LastX - FirstX; ++outx)
+                                        {
+                                            Value += In[outx * Stride] * Del[outx];
+                                        }
+                                    }
+
+                                    TensorAt(Gradients, kernel, channel, y, x) += Value;
+                                }
                             }
                         }
                     }
                 }
+            }
+
+        // 4.2.4 --- Backward --- //
+
+            /*
+                Calculate Conv Layer Backward Propagation. Filters are not changed, their Gradients are accumulated instead.
+                Weight Gradients are a Gemm over the whole Batch. The Input Gradient shares its Lowered Input when it is a Gemm too,
+                or is a Convolution of the Delta spread by the Stride with Winograd, FFT or the Direct Loop
+
+                PrevInput - Input Volumes from previous ForwardPropagation
+                PrevOutput - Output Volumes from previous ForwardPropagation
+                Error - Error from Next Layer
+                Output - Output ( Error to backprop onto previous Layer). NULL when nothing reads it, then only Weight Gradients are calculated
+                Filters - Weights {NKernels, Channels, KernelSize, KernelSize}
+                Params - LayerParams
+                    [0] = Act;                // 0 means no Act Function (changed if add_act is called)
+                    [1] = NKernels;           // How many Kernels
+                    [2] = KernelSize;         // Kernel size. 2 means 2x2, 3 means 3x3
+                    [3] = Stride;             // How many pixels Kernel moves at a time
+                    [4] = Padding;            // How many 0 pixels are added to input before computing
+                Cache - Transformed Weights of this Layer. Can be NULL
+                Gradients - Weight Gradients, same Dimensions as Filters. This Layer's Gradients are added to it. NULL for a Frozen Layer
+
+                Return Value - Nothing
+            */
+
+            void ConvBackCpu(Tensor* PrevInput,                                          // Varibles to Calculate Weight Updates
+                             Tensor* PrevOutput, Tensor* Error,                          // Variables to Calculate Delta
+                             Tensor* Output,                                             // Variable to Store Error from this layer
+                             Tensor* Filters, double* Params,                            // Weights + Params
+                             ConvCache* Cache,                                           // Transformed Weights
+                             Tensor* Gradients)                                          // Weight Gradients
+            {
+                int KernelSize = Params[2];
+                int Stride = Params[3];
+                int Padding = Params[4];
+
+                int Samples = PrevOutput->Dims[0];
+                int OutHeight = PrevOutput->Dims[2];
+                int OutWidth = PrevOutput->Dims[3];
+
+                // --- Delta. Temporary Tensors come from the Scratch Arena of this Thread --- //
+
+                    Arena* Space = ScratchArena();
+                    size_t Mark = Space->Used;
+
+                    int DeltaDims[3] = {1, PrevOutput->Dims[1], Samples * OutHeight * OutWidth};
+
+                    Tensor Delta = ArenaTensor(Space, 1, DeltaDims);
+                    if(Delta.Data == NULL)
+                    {
+                        printf("Memory Allocation Error.\n");
+                        exit(MemoryError);
+                    }
+
+                    ConvDelta(PrevOutput, Error, Params, Delta.Data);
+
+                // --- Weight Gradients, and the Input Gradient when it is a Gemm too --- //
+
+                    int Tile = 0;
+
+                    // Without an Input Gradient only the Weight Gradients are left, which are a Gemm
+                    char Algorithm = Output == NULL ? ConvGemm : PickConvAlgorithm(ConvBackward, Params[1], Output->Dims[1], KernelSize, Stride, Output->Dims[2], Output->Dims[3], Cache, &Tile);
+
+                    char Lowered = ConvAlgorithm != ConvDirect && (Gradients != NULL || Algorithm == ConvGemm);
+
+                    if(!Lowered || ConvBackGemm(PrevInput, Delta.Data, OutHeight, OutWidth, Algorithm == ConvGemm ? Output : NULL, Filters, Params, Gradients) != 0)
+                    {
+                        if(Gradients != NULL)
+                        {
+                            ConvBackDirectWeights(PrevInput, Delta.Data, OutHeight, OutWidth, Params, Gradients);
+                        }
+
+                        if(Algorithm == ConvGemm)
+                        {
+                            Algorithm = ConvDirect;
+                        }
+                    }
+
+                // --- Input Gradient from the Delta spread by the Stride --- //
+
+                    // This is a regular Stride 1 Convolution of the Dilated Delta with the Rotated Filters and Padding KernelSize - 1 - Padding,
+                    // so Winograd (KernelSize 3, Stride 1) and FFT (any Stride, the Dilated Delta already holds the zeroes) work like in the Forward Propagation
+                    if(Output != NULL && Algorithm != ConvGemm)
+                    {
+                        int DilatedDims[3] = {PrevOutput->Dims[1], OutHeight + (OutHeight - 1) * (Stride - 1), OutWidth + (OutWidth - 1) * (Stride - 1)};
+
+                        Tensor Dilated = ArenaTensor(Space, Samples, DilatedDims);
+                        if(Dilated.Data == NULL)
+                        {
+                            printf("Memory Allocation Error.\n");
+                            exit(MemoryError);
+                        }
+
+                        DilateDelta(Delta.Data, &Dilated, OutHeight, OutWidth, Stride);
+
+                        // Not enough memory for the Transforms
+                        if(Algorithm != ConvDirect && TransformedConv(&Dilated, Output, Filters, Cache, Algorithm, ConvBackward, Tile, KernelSize - 1 - Padding, NULL) != 0)
+                        {
+                            Algorithm = ConvDirect;
+                        }
+
+                        if(Algorithm == ConvDirect)
+                        {
+                            ConvBackDirect(&Dilated, Output, Filters, Params);
+                        }
+
+                        FreeTensor(&Dilated);
+                    }
+
+                // --- Free --- //
+
+                    FreeTensor(&Delta);
+                    ReleaseArena(Space, Mark);
+            }
+
+// 5 --- Workspace --- //
+
+    // 5.1 --- Transforms --- //
+
+        // Doubles of Scratch Arena Winograd and FFT take on one Thread, with their Gemm
+        static size_t TransformedScratch()
+        {
+            int FFTScratchDims[3] = {1, 1, 2 * FFTMaxTile * FFTMaxTile + FFTMaxTile};
+
+            return (WinogradWorkspace > FFTWorkspace ? WinogradWorkspace : FFTWorkspace) + ArenaDoubles(1, FFTScratchDims) + GemmScratch;
+        }
+
+    // 5.2 --- Conv --- //
+
+        /*
+            Doubles of Scratch Arena a Conv Layer may take on one Thread, whatever Algorithm is picked.
+            Used to plan the Arenas once, when the Network is built
+
+            InDims - Input Volume Dimensions
+            OutDims - Output Volume Dimensions
+            Params - LayerParams
+            Samples - Volumes Forwarded at once
+            Training - 1 to include the Backward Propagation
+
+            Return Value - Doubles needed
+        */
+
+        size_t ConvScratch(int* InDims, int* OutDims, double* Params, int Samples, char Training)
+        {
+            int NKernels = Params[1];
+            int KernelSize = Params[2];
+            int Stride = Params[3];
+
+            size_t Transformed = TransformedScratch();
+
+            // --- Forward: Lowered Input of a group of Samples, its Product and Gemm, or the Transforms for Stride 1. The Direct Loop needs nothing --- //
+
+                int Block = GemmSampleBlock(OutDims[1] * OutDims[2], Samples);
+
+                int ColDims[3] = {1, InDims[0] * KernelSize * KernelSize, Block * OutDims[1] * OutDims[2]};
+                int ProductDims[3] = {1, NKernels, Block * OutDims[1] * OutDims[2]};
+
+                size_t Forward = ArenaDoubles(1, ColDims) + (Block > 1 ? ArenaDoubles(1, ProductDims) : 0) + GemmScratch;
+
+                if(Stride == 1 && Transformed > Forward)
+                {
+                    Forward = Transformed;
+                }
+
+                if(!Training)
+                {
+                    return Forward;
+                }
+
+            // --- Backward: Delta, then the Lowered Input of a group for the Gemms, or the Dilated Delta and Rotated Filters or the Transforms --- //
+
+                int DeltaDims[3] = {1, NKernels, Samples * OutDims[1] * OutDims[2]};
+                int DilatedDims[3] = {NKernels, OutDims[1] + (OutDims[1] - 1) * (Stride - 1), OutDims[2] + (OutDims[2] - 1) * (Stride - 1)};
+                int RotatedDims[3] = {NKernels, KernelSize, KernelSize};
+
+                int BackColDims[3] = {1, InDims[0] * KernelSize * KernelSize, Block * OutDims[1] * OutDims[2]};
+
+                size_t Spread = ArenaDoubles(InDims[0], RotatedDims);
+
+                if(Transformed > Spread)
+                {
+                    Spread = Transformed;
+                }
+
+                Spread += ArenaDoubles(Samples, DilatedDims);
+
+                size_t Lowered = ArenaDoubles(1, BackColDims) + GemmScratch;
+
+                size_t Backward = ArenaDoubles(1, DeltaDims) + (Spread > Lowered ? Spread : Lowered);
+
+            return Forward > Backward ? Forward : Backward;
+        }
 
-            // --- Weight Updates Calculated! --- //
+    // 5.3 --- Fused Pool --- //
 
-            // --- Free --- //
+        /*
+            Doubles of Scratch Arena ConvPoolForwCpu may take on one Thread, whatever Algorithm is picked
+
+            InDims - Input Volume Dimensions of the Conv Layer
+            OutDims - Output Volume Dimensions of the Pool Layer
+            ConvParams - LayerParams of the Conv Layer
+            PoolParams - LayerParams of the Pool Layer
+            Samples - Volumes Forwarded at once
+
+            Return Value - Doubles needed
+        */
+
+        size_t ConvPoolScratch(int* InDims, int* OutDims, double* ConvParams, double* PoolParams, int Samples)
+        {
+            int NKernels = ConvParams[1];
+            int KernelSize = ConvParams[2];
+            int Stride = ConvParams[3];
+            int Padding = ConvParams[4];
+
+            int ConvHeight = (InDims[1] - KernelSize + 2 * Padding) / Stride + 1;
+            int ConvWidth = (InDims[2] - KernelSize + 2 * Padding) / Stride + 1;
+
+            size_t Scratch = 0;
+
+            // Bands of Gemm and the Direct Loop, then whole Samples for the Transforms, only possible with Stride 1
+            for(char Whole = 0; Whole <= (Stride == 1); ++Whole)
+            {
+                int Block, PoolRows;
+                PoolBands(ConvWidth, ConvHeight * ConvWidth, OutDims[1], PoolParams, Samples, Whole, &Block, &PoolRows);
+
+                int BandDims[3] = {NKernels, (PoolRows - 1) * (int) PoolParams[3] + (int) PoolParams[1], ConvWidth};
+                int ColDims[3] = {1, InDims[0] * KernelSize * KernelSize, Block * BandDims[1] * ConvWidth};
+
+                size_t Band = ArenaDoubles(Block, BandDims) + (Whole ? TransformedScratch() : ArenaDoubles(1, ColDims) + GemmScratch);
+
+                if(Band > Scratch)
+                {
+                    Scratch = Band;
+                }
+            }
 
-                Free3D(Delta);
-                Free3D(DeltaPadded);
-                Free3D(PrevInputPadded);
+            return Scratch;
         }
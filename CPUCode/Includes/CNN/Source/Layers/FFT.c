@@ -0,0 +1,650 @@
+#include "../../CNN.h"
+
+/*
+                File Structure
+
+    1 - FFT
+        1.1 - Twiddles
+        1.2 - 1D
+        1.3 - 2D
+        1.4 - Tile Size
+
+    2 - Spectra
+        2.1 - Real Tiles
+        2.2 - Filter Spectra
+
+    3 - Convolution
+        3.1 - Input Spectra
+        3.2 - Output
+        3.3 - Convolution
+*/
+
+// 1 --- FFT --- //
+
+    //  A Convolution is a product in the Frequency domain. For a Tile of T x T Input pixels and a K x K Filter
+    //
+    //      Out = IFFT( FFT(d) * conj(FFT(g)) )
+    //
+    //  gives the circular correlation, whose first T - K + 1 Rows and Columns are the regular Convolution (Overlap-Save).
+    //  FFT(g) only depends on the Weights, so it is done once per Weight Update.
+    //  Summed over Channels, the product for each Frequency is a complex {NKernels, Channels} x {Channels, Tiles}
+    //  Matrix Product, done as 4 real Gemms.
+    //
+    //  Inputs are real, so only Columns 0 to T/2 of each Spectrum are kept (the rest are their conjugates),
+    //  and two real Tiles are transformed at once as the real and imaginary parts of one complex Tile.
+
+    // 1.1 --- Twiddles --- //
+
+        /*
+            Calculate the Twiddle Factors e^(-2*pi*i*j/N), j < N/2
+
+            N - FFT size
+            Re - Where to place the real parts
+            Im - Where to place the imaginary parts
+
+            Return Value - Nothing
+        */
+
+        static void Twiddles(int N, double* Re, double* Im)
+        {
+            for(int j = 0; j < N / 2; ++j)
+            {
+                Re[j] = cos(2 * M_PI * j / N);
+                Im[j] = -sin(2 * M_PI * j / N);
+            }
+        }
+
+    // 1.2 --- 1D --- //
+
+        /*
+            In place iterative radix-2 FFT
+
+            Re - Real parts
+            Im - Imaginary parts
+            N - Size. Has to be a power of 2
+            Stride - Elements between consecutive Values
+            TwRe - Twiddles from 1.1
+            TwIm - Twiddles from 1.1
+            Inverse - 1 for the Inverse FFT. The result is not divided by N
+
+            Return Value - Nothing
+        */
+
+        static void FFT1D(double* Re, double* Im, int N, int Stride, double* TwRe, double* TwIm, char Inverse)
+        {
+            // --- Bit Reversal --- //
+
+                for(int i = 1, j = 0; i < N; ++i)
+                {
+                    int Bit = N >> 1;
+
+                    for(; j & Bit; Bit >>= 1)
+                    {
+                        j ^= Bit;
+                    }
+                    j ^= Bit;
+
+                    if(i < j)
+                    {
+                        double Temp = Re[i * Stride];
+                        Re[i * Stride] = Re[j * Stride];
+                        Re[j * Stride] = Temp;
+
+                        Temp = Im[i * Stride];
+                        Im[i * Stride] = Im[j * Stride];
+                        Im[j * Stride] = Temp;
+                    }
+                }
+
+            // --- Butterflies --- //
+
+                for(int Length = 2; Length <= N; Length <<= 1)
+                {
+                    int Half = Length / 2;
+                    int Step = N / Length;
+
+                    for(int i = 0; i < N; i += Length)
+                    {
+                        for(int j = 0; j < Half; ++j)
+                        {
+                            double wr = TwRe[j * Step];
+                            double wi = Inverse ? -TwIm[j * Step] : TwIm[j * Step];
+
+                            int a = (i + j) * Stride;
+                            int b = (i + j + Half) * Stride;
+
+                            double xr = Re[b] * wr - Im[b] * wi;
+                            double xi = Re[b] * wi + Im[b] * wr;
+
+                            Re[b] = Re[a] - xr;
+                            Im[b] = Im[a] - xi;
+                            Re[a] += xr;
+                            Im[a] += xi;
+                        }
+                    }
+                }
+        }
+
+    // 1.3 --- 2D --- //
+
+        /*
+            In place 2D FFT of an N x N Tile, Rows then Columns
+
+            Re - Real parts, Row major
+            Im - Imaginary parts, Row major
+            N - Size. Has to be a power of 2
+            TwRe - Twiddles from 1.1
+            TwIm - Twiddles from 1.1
+            Inverse - 1 for the Inverse FFT. The result is not divided by N^2
+
+            Return Value - Nothing
+        */
+
+        static void FFT2D(double* Re, double* Im, int N, double* TwRe, double* TwIm, char Inverse)
+        {
+            for(int y = 0; y < N; ++y)
+            {
+                FFT1D(Re + y * N, Im + y * N, N, 1, TwRe, TwIm, Inverse);
+            }
+
+            for(int x = 0; x < N; ++x)
+            {
+                FFT1D(Re + x, Im + x, N, N, TwRe, TwIm, Inverse);
+            }
+        }
+
+    // 1.4 --- Tile Size --- //
+
+        /*
+            Get the Tile size of a Spectra Tensor
+
+            Spectra - Spectra from FFTFilters {Bins, 2, NKernels, Channels}
+
+            Return Value - Tile size
+        */
+
+        static int SpectraTile(Tensor* Spectra)
+        {
+            int Tile = 2;
+
+            while(Tile * (Tile / 2 + 1) < Spectra->Dims[0])
+            {
+                Tile *= 2;
+            }
+
+            return Tile;
+        }
+
+// 2 --- Spectra --- //
+
+    // 2.1 --- Real Tiles --- //
+
+        /*
+            Split the Spectrum of two real Tiles transformed together (as Re + i * Im)
+            and keep Columns 0 to T/2 of each
+
+            Re - Real parts of the joint Spectrum
+            Im - Imaginary parts of the joint Spectrum
+            T - Tile size
+            First - Where to place the first Spectrum. Bin b goes to First[b * BinStride], its imaginary part to First[b * BinStride + PartStride]
+            Second - Same for the second Spectrum. Can be NULL
+            BinStride - Elements between consecutive Bins
+            PartStride - Elements between the real and imaginary part of a Bin
+
+            Return Value - Nothing
+        */
+
+        static void SplitSpectra(double* Re, double* Im, int T, double* First, double* Second, int BinStride, int PartStride)
+        {
+            int Columns = T / 2 + 1;
+
+            for(int ky = 0; ky < T; ++ky)
+            {
+                for(int kx = 0; kx < Columns; ++kx)
+                {
+                    int Bin = (ky * Columns + kx) * BinStride;
+
+                    // Z[k] and conj(Z[-k])
+                    int Mirror = ((T - ky) % T) * T + (T - kx) % T;
+
+                    double zr = Re[ky * T + kx];
+                    double zi = Im[ky * T + kx];
+                    double nr = Re[Mirror];
+                    double ni = -Im[Mirror];
+
+                    // First = (Z[k] + conj(Z[-k])) / 2
+                    First[Bin] = 0.5 * (zr + nr);
+                    First[Bin + PartStride] = 0.5 * (zi + ni);
+
+                    // Second = (Z[k] - conj(Z[-k])) / 2i
+                    if(Second != NULL)
+                    {
+                        Second[Bin] = 0.5 * (zi - ni);
+                        Second[Bin + PartStride] = -0.5 * (zr - nr);
+                    }
+                }
+            }
+        }
+
+    // 2.2 --- Filter Spectra --- //
+
+        /*
+            Calculate the Spectrum of every Filter, zero padded to Tile x Tile.
+            Spectra is (re)allocated when it does not match the Filters.
+
+            Filters - Weights {NKernels, Channels, KernelSize, KernelSize}
+            Spectra - Where to place the Result {Tile * (Tile/2 + 1), 2, NKernels, Channels}. Index 0 of Dim 1 holds real parts, 1 imaginary parts
+            Tile - FFT size. Power of 2 greater or equal to KernelSize
+
+            Return Value - Nothing. Spectra->Data is NULL if it could not be allocated
+        */
+
+        void FFTFilters(Tensor* Filters, Tensor* Spectra, int Tile)
+        {
+            int T = Tile;
+            int Bins = T * (T / 2 + 1);
+
+            int NKernels = Filters->Dims[0];
+            int Channels = Filters->Dims[1];
+            int KernelSize = Filters->Dims[2];
+
+            // --- Allocate --- //
+
+                if(Spectra->Data == NULL || Spectra->Dims[0] != Bins || Spectra->Dims[2] != NKernels || Spectra->Dims[3] != Channels)
+                {
+                    FreeTensor(Spectra);
+
+                    int Dims[3] = {2, NKernels, Channels};
+                    *Spectra = InitTensor(Bins, Dims);
+
+                    if(Spectra->Data == NULL)
+                    {
+                        return;
+                    }
+                }
+
+            // --- Transform two Channels at a time --- //
+
+                int ScratchDims[3] = {1, 1, 2 * T * T + T};
+
+                Arena* Space = ScratchArena();
+                size_t Mark = Space->Used;
+
+                Tensor Scratch = ArenaTensor(Space, 1, ScratchDims);
+
+                if(Scratch.Data == NULL)
+                {
+                    ReleaseArena(Space, Mark);
+                    FreeTensor(Spectra);
+                    return;
+                }
+
+                double* Re = Scratch.Data;
+                double* Im = Re + T * T;
+                double* TwRe = Im + T * T;
+                double* TwIm = TwRe + T / 2;
+
+                Twiddles(T, TwRe, TwIm);
+
+                for(int kernel = 0; kernel < NKernels; ++kernel)
+                {
+                    for(int channel = 0; channel < Channels; channel += 2)
+                    {
+                        char Pair = channel + 1 < Channels;
+
+                        memset(Re, 0, 2 * T * T * sizeof(double));
+
+                        for(int y = 0; y < KernelSize; ++y)
+                        {
+                            for(int x = 0; x < KernelSize; ++x)
+                            {
+                                Re[y * T + x] = TensorAt(Filters, kernel, channel, y, x);
+
+                                if(Pair)
+                                {
+                                    Im[y * T + x] = TensorAt(Filters, kernel, channel + 1, y, x);
+                                }
+                            }
+                        }
+
+                        FFT2D(Re, Im, T, TwRe, TwIm, 0);
+
+                        SplitSpectra(Re, Im, T, &TensorAt(Spectra, 0, 0, kernel, channel), Pair ? &TensorAt(Spectra, 0, 0, kernel, channel + 1) : NULL,
+                                     Spectra->Strides[0], Spectra->Strides[1]);
+                    }
+                }
+
+                FreeTensor(&Scratch);
+                ReleaseArena(Space, Mark);
+        }
+
+// 3 --- Convolution --- //
+
+    // 3.1 --- Input Spectra --- //
+
+        /*
+            Calculate the Spectrum of every Channel of a group of Tiles
+
+            Input - Input Volumes
+            Sample - Volume to Transform
+            T - Tile size
+            m - Output pixels per Tile Row
+            Padding - Padding
+            TilesX - Tiles per Output Row
+            FirstTile - First Tile of the group
+            NTiles - Tiles in the group
+            V - Where to place the Result {Bins, 2, Channels, NTiles}
+            Re, Im - Scratch of T * T doubles each
+            TwRe, TwIm - Twiddles from 1.1
+
+            Return Value - Nothing
+        */
+
+        static void InputSpectra(Tensor* Input, int Sample, int T, int m, int Padding, int TilesX, int FirstTile, int NTiles, double* V,
+                                 double* Re, double* Im, double* TwRe, double* TwIm)
+        {
+            int Channels = Input->Dims[1];
+
+            for(int tile = 0; tile < NTiles; ++tile)
+            {
+                int y0 = ((FirstTile + tile) / TilesX) * m - Padding;
+                int x0 = ((FirstTile + tile) % TilesX) * m - Padding;
+
+                for(int channel = 0; channel < Channels; channel += 2)
+                {
+                    char Pair = channel + 1 < Channels;
+
+                    // --- Gather Tiles. Pixels outside the Input are Padding --- //
+
+                        for(int i = 0; i < T; ++i)
+                        {
+                            int y = y0 + i;
+
+                            if(y < 0 || y >= Input->Dims[2])
+                            {
+                                memset(Re + i * T, 0, T * sizeof(double));
+                                memset(Im + i * T, 0, T * sizeof(double));
+                                continue;
+                            }
+
+                            double* Row = TensorRow(Input, Sample, channel, y);
+                            double* NextRow = Pair ? TensorRow(Input, Sample, channel + 1, y) : NULL;
+
+                            for(int j = 0; j < T; ++j)
+                            {
+                                int x = x0 + j;
+                                char Inside = x >= 0 && x < Input->Dims[3];
+
+                                Re[i * T + j] = Inside ? Row[x] : 0;
+                                Im[i * T + j] = Inside && Pair ? NextRow[x] : 0;
+                            }
+                        }
+
+                    // --- Transform --- //
+
+                        FFT2D(Re, Im, T, TwRe, TwIm, 0);
+
+                        SplitSpectra(Re, Im, T, V + channel * NTiles + tile, Pair ? V + (channel + 1) * NTiles + tile : NULL,
+                                     2 * Channels * NTiles, Channels * NTiles);
+                }
+            }
+        }
+
+    // 3.2 --- Output --- //
+
+        /*
+            Rebuild the full Spectrum of every Kernel of a group of Tiles, transform it back and place the valid part in Output
+
+            M - Products {Bins, 2, NKernels, NTiles}
+            Output - Output Volumes
+            Sample - Volume to write
+            T - Tile size
+            m - Output pixels per Tile Row
+            TilesX - Tiles per Output Row
+            FirstTile - First Tile of the group
+            NTiles - Tiles in the group
+            Re, Im - Scratch of T * T doubles each
+            TwRe, TwIm - Twiddles from 1.1
+
+            Return Value - Nothing
+        */
+
+        static void OutputSpectra(double* M, Tensor* Output, int Sample, int T, int m, int TilesX, int FirstTile, int NTiles,
+                                  double* Re, double* Im, double* TwRe, double* TwIm)
+        {
+            int NKernels = Output->Dims[1];
+            int Columns = T / 2 + 1;
+
+            int BinStride = 2 * NKernels * NTiles;
+            int PartStride = NKernels * NTiles;
+
+            double Scale = 1.0 / (T * T);
+
+            for(int tile = 0; tile < NTiles; ++tile)
+            {
+                int y0 = ((FirstTile + tile) / TilesX) * m;
+                int x0 = ((FirstTile + tile) % TilesX) * m;
+
+                // Two Kernels at a time. Both are real, so Z = A + iB transforms back to a + ib
+                for(int kernel = 0; kernel < NKernels; kernel += 2)
+                {
+                    char Pair = kernel + 1 < NKernels;
+
+                    double* A = M + kernel * NTiles + tile;
+                    double* B = A + NTiles;
+
+                    for(int ky = 0; ky < T; ++ky)
+                    {
+                        for(int kx = 0; kx < T; ++kx)
+                        {
+                            // Columns past T/2 are the conjugate of their Mirror
+                            int Bin;
+                            double Sign = 1;
+
+                            if(kx < Columns)
+                            {
+                                Bin = (ky * Columns + kx) * BinStride;
+                            }
+                            else
+                            {
+                                Bin = (((T - ky) % T) * Columns + T - kx) * BinStride;
+                                Sign = -1;
+                            }
+
+                            double ar = A[Bin];
+                            double ai = Sign * A[Bin + PartStride];
+                            double br = Pair ? B[Bin] : 0;
+                            double bi = Pair ? Sign * B[Bin + PartStride] : 0;
+
+                            Re[ky * T + kx] = ar - bi;
+                            Im[ky * T + kx] = ai + br;
+                        }
+                    }
+
+                    FFT2D(Re, Im, T, TwRe, TwIm, 1);
+
+                    // --- Valid part. Tiles on the last Row / Column can stick out of the Output --- //
+
+                        for(int i = 0; i < m && y0 + i < Output->Dims[2]; ++i)
+                        {
+                            double* Out = TensorRow(Output, Sample, kernel, y0 + i);
+                            double* NextOut = Pair ? TensorRow(Output, Sample, kernel + 1, y0 + i) : NULL;
+
+                            for(int j = 0; j < m && x0 + j < Output->Dims[3]; ++j)
+                            {
+                                Out[x0 + j] = Scale * Re[i * T + j];
+
+                                if(Pair)
+                                {
+                                    NextOut[x0 + j] = Scale * Im[i * T + j];
+                                }
+                            }
+                        }
+                }
+            }
+        }
+
+    // 3.3 --- Convolution --- //
+
+        // Arguments of FFTTask
+        typedef struct
+        {
+            Tensor* Input;
+            Tensor* Output;
+            Tensor* Spectra;
+            int T;                      // FFT size
+            int m;                      // Output Tile
+            int Padding;
+
+            int TilesX;                 // Tiles per Output Row
+            int TotalTiles;             // Tiles per Sample
+            int GroupSize;              // Tiles per Group
+            int Groups;                 // Groups per Sample
+
+            int Status;                 // MemoryError if a Workspace could not be allocated
+
+        } FFTArgs;
+
+        // Convolve Groups [Start, End). Group i holds Tiles of Sample i / Groups. Each call has its own Workspace
+        static void FFTTask(void* Args, int Start, int End, int Thread)
+        {
+            (void) Thread;
+
+            FFTArgs* Task = Args;
+            Tensor* Spectra = Task->Spectra;
+
+            int T = Task->T;
+            int Bins = Spectra->Dims[0];
+            int NKernels = Spectra->Dims[2];
+            int Channels = Spectra->Dims[3];
+
+            // --- Workspace --- //
+
+                int VDims[3] = {1, 2 * Bins * Channels, Task->GroupSize};
+                int MDims[3] = {1, 2 * Bins * NKernels, Task->GroupSize};
+                int ScratchDims[3] = {1, 1, 2 * T * T + T};
+
+                // Every Value is written before it is read, so the Scratch Arena of this Thread is used as is
+                Arena* Space = ScratchArena();
+                size_t Mark = Space->Used;
+
+                Tensor V = ArenaTensor(Space, 1, VDims);
+                Tensor M = ArenaTensor(Space, 1, MDims);
+                Tensor Scratch = ArenaTensor(Space, 1, ScratchDims);
+
+                if(V.Data == NULL || M.Data == NULL || Scratch.Data == NULL)
+                {
+                    FreeTensor(&Scratch);
+                    FreeTensor(&M);
+                    FreeTensor(&V);
+                    ReleaseArena(Space, Mark);
+                    Task->Status = MemoryError;
+                    return;
+                }
+
+                double* Re = Scratch.Data;
+                double* Im = Re + T * T;
+                double* TwRe = Im + T * T;
+                double* TwIm = TwRe + T / 2;
+
+                Twiddles(T, TwRe, TwIm);
+
+            // --- Convolution --- //
+
+                for(int Group = Start; Group < End; ++Group)
+                {
+                    int sample = Group / Task->Groups;
+                    int FirstTile = (Group % Task->Groups) * Task->GroupSize;
+                    int NTiles = Task->TotalTiles - FirstTile < Task->GroupSize ? Task->TotalTiles - FirstTile : Task->GroupSize;
+
+                    InputSpectra(Task->Input, sample, T, Task->m, Task->Padding, Task->TilesX, FirstTile, NTiles, V.Data, Re, Im, TwRe, TwIm);
+
+                    // Out = conj(G) * V  ->  Re = Gr Vr + Gi Vi, Im = Gr Vi - Gi Vr
+                    for(int Bin = 0; Bin < Bins; ++Bin)
+                    {
+                        double* Gr = TensorRow(Spectra, Bin, 0, 0);
+                        double* Gi = TensorRow(Spectra, Bin, 1, 0);
+                        double* Vr = V.Data + 2 * Bin * Channels * NTiles;
+                        double* Vi = Vr + Channels * NTiles;
+                        double* Mr = M.Data + 2 * Bin * NKernels * NTiles;
+                        double* Mi = Mr + NKernels * NTiles;
+
+                        Gemm(NoTrans, NoTrans, NKernels, NTiles, Channels, 1, Gr, Channels, Vr, NTiles, 0, Mr, NTiles);
+                        Gemm(NoTrans, NoTrans, NKernels, NTiles, Channels, 1, Gi, Channels, Vi, NTiles, 1, Mr, NTiles);
+                        Gemm(NoTrans, NoTrans, NKernels, NTiles, Channels, 1, Gr, Channels, Vi, NTiles, 0, Mi, NTiles);
+                        Gemm(NoTrans, NoTrans, NKernels, NTiles, Channels, -1, Gi, Channels, Vr, NTiles, 1, Mi, NTiles);
+                    }
+
+                    OutputSpectra(M.Data, Task->Output, sample, T, Task->m, Task->TilesX, FirstTile, NTiles, Re, Im, TwRe, TwIm);
+                }
+
+            // --- Free --- //
+
+                FreeTensor(&Scratch);
+                FreeTensor(&M);
+                FreeTensor(&V);
+                ReleaseArena(Space, Mark);
+        }
+
+        /*
+            Calculate a Stride 1 Convolution with Filter Spectra. No Activation is applied.
+
+            Tiles are processed in groups sized so the Input Spectra and the Products fit in FFTWorkspace doubles.
+            With Threads, Groups are made small enough for every Thread to get one. Each Tile is computed the same way
+            whatever Group it is in, so results don't depend on the Thread count.
+
+            Input - Input Volumes
+            Output - Where to place Output
+            Spectra - Spectra from FFTFilters {Bins, 2, NKernels, Channels}
+            KernelSize - Kernel size
+            Padding - Padding. May be negative, in which case Input borders are skipped
+            Workers - Threads to split Groups among. Can be NULL
+
+            Return Value - 0 on Success, MemoryError if the Workspace could not be allocated
+        */
+
+        int FFTConv(Tensor* Input, Tensor* Output, Tensor* Spectra, int KernelSize, int Padding, ThreadPool* Workers)
+        {
+            int T = SpectraTile(Spectra);
+            int m = T - KernelSize + 1;
+            int Bins = Spectra->Dims[0];
+
+            int NKernels = Spectra->Dims[2];
+            int Channels = Spectra->Dims[3];
+
+            int TilesY = (Output->Dims[2] + m - 1) / m;
+            int TilesX = (Output->Dims[3] + m - 1) / m;
+            int TotalTiles = TilesY * TilesX;
+
+            // --- Groups --- //
+
+                int GroupSize = FFTWorkspace / (2 * Bins * (Channels + NKernels));
+
+                // Enough Groups per Sample for every Thread
+                int SplitsPerSample = (PoolThreads(Workers) + Input->Dims[0] - 1) / Input->Dims[0];
+                int ThreadShare = (TotalTiles + SplitsPerSample - 1) / SplitsPerSample;
+
+                if(GroupSize > ThreadShare)
+                {
+                    GroupSize = ThreadShare + GemmNR - 1;
+                }
+
+                GroupSize -= GroupSize % GemmNR;
+
+                if(GroupSize < GemmNR)
+                {
+                    GroupSize = GemmNR;
+                }
+                if(GroupSize > TotalTiles)
+                {
+                    GroupSize = TotalTiles;
+                }
+
+                FFTArgs Args = {Input, Output, Spectra, T, m, Padding, TilesX, TotalTiles, GroupSize, (TotalTiles + GroupSize - 1) / GroupSize, 0};
+
+            // --- Convolution --- //
+
+                ParallelFor(Workers, Input->Dims[0] * Args.Groups, FFTTask, &Args);
+
+            return Args.Status;
+        }
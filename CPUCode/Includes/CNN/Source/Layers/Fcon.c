@@ -6,118 +6,203 @@
     1 - Layer Propagation
         1.1 - Forward Propagation
         1.2 - Backward Propagation
+
+    2 - Workspace
+
+    3 - Dropout Seed
 */
 
 
 // 1 --- Layer Propagation --- //
 
+	// --- Global Variables --- //
+
+		// Dropout Seed of the calling Thread, set by SetDropoutSeed
+		static __thread uint64_t DropSeed;
+		static __thread int DropFirst = -1;			// Position in its Batch of the first Sample Forwarded. -1 draws Masks from ThreadRand
+		static __thread int DropLayer;				// Fcon Layers with Dropout Forwarded since the Seed was set
+
 	// 1.1 --- Forward Propagation --- //
+
+		// Arguments of FconTask
+		typedef struct
+		{
+			Tensor* Input;
+			Tensor* Output;
+			Tensor* Weights;
+			double* Params;
+
+			char* Dropped;					// 1 for Outputs that are Dropped out, for every Sample. NULL without Dropout
+
+		} FconArgs;
+
+		// Calculate Outputs [Start, End) of every Sample
+		static void FconTask(void* Args, int Start, int End, int Thread)
+		{
+			(void) Thread;
+
+			FconArgs* Task = Args;
+			double* Params = Task->Params;
+
+			int Samples = Task->Input->Dims[0];
+			int InDim = SampleSize(Task->Input);
+			int OutDim = SampleSize(Task->Output);
+
+			// --- Calculate Outputs --- //
+
+				// Row y of Weights holds the Weights of Output y, so Outputs [Start, End) read one contiguous block of Weights.
+				// A single Sample is a Gemv. A Batch is a Gemm, so each block of Weights is loaded once for every Sample
+				double* Weights = TensorRow(Task->Weights, 0, 0, Start);
+
+				if(Samples == 1)
+				{
+					Gemv(NoTrans, End - Start, InDim, 1, Weights, InDim, Task->Input->Data, 0, Task->Output->Data + Start);
+				}
+				else
+				{
+					Gemm(NoTrans, Trans, Samples, End - Start, InDim,
+						 1, Task->Input->Data, Task->Input->Strides[0],
+						 Weights, InDim,
+						 0, Task->Output->Data + Start, Task->Output->Strides[0]);
+				}
+
+			// --- Apply Act Func and overflow control, then clear the Outputs that are Dropped out --- //
+
+				for(int sample = 0; sample < Samples; ++sample)
+				{
+					double* Out = Task->Output->Data + sample * Task->Output->Strides[0];
+
+					ActivateRow(Out + Start, End - Start, Params[0]);
+
+					if(Task->Dropped != NULL)
+					{
+						char* Dropped = Task->Dropped + sample * OutDim;
+
+						for(int y = Start; y < End; ++y)
+						{
+							Out[y] = Dropped[y] ? 0 : Out[y];
+						}
+					}
+				}
+		}
 	
 	    /*
-			Calculate Fcon Layer Backpropagation
+			Calculate Fcon Layer Forward Propagation
 
-	        Input - Input Volume
-	        InDim - Input Dimensions
-	        Output - Output Volume
-	        OutDim - Output Dimensions
-	        Weights - Fcon Weights
+	        Input - Input Volumes. Each Volume is read as a single Vector
+	        Output - Output Volumes
+	        Weights - Fcon Weights {1, 1, OutputSize, InputSize}. Row y holds the Weights of Output y
 	        Params - LayerParams
 			Set Params - 
 				[0] = Act Func;					// 0 means no Act Function (changed if add_act is called)
 				[1] = DropP;					// Drop Probability
 				[2] = Outputs;					// How many Outputs Calculated at once in DFE
 			DropControl - Wether to Apply Dropout or not
+			Workers - Threads to split Outputs among. Can be NULL
 
 	        Return Value - nothing
 	    */
 
-		void FconForwCpu(double* Input, int InDim, 				// Input
-						 double* Output, int OutDim, 			// Output
-						 double** Weights, double* Params,		// Weights + Params
-						 char DropControl)						// Control Dropout
+		void FconForwCpu(Tensor* Input, 						// Input
+						 Tensor* Output, 						// Output
+						 Tensor* Weights, double* Params,		// Weights + Params
+						 char DropControl,						// Control Dropout
+						 ThreadPool* Workers)						// Threads
 		{
+			int OutDim = SampleSize(Output);
 
-			for(int y = 0; y < OutDim; ++y)
-			{
-				// If Output is meant to be Dropped out, don't calculate it
-				if(GenerateRand(0, 1) < Params[1] && DropControl == 1)
-				{
-					Output[y] = 0;
-					continue;
-				}
+			// --- Dropout --- //
+
+				// Drawn before splitting the Outputs, so the Random sequence is the same for any Thread count.
+				// With a Dropout Seed, every Sample gets its own Generator, seeded by its Position in the Batch and by the Layer,
+				// so Masks don't depend on how the Batch is split. Either way no Lock is taken.
+				// The Mask is taken from the Scratch Arena of this Thread, and only while Training
+				Arena* Space = ScratchArena();
+				size_t Mark = Space->Used;
 
-				// --- Calculate Output --- //
+				Tensor DroppedMask = {0};
+				char* Dropped = NULL;
 
-					for(int x = 0; x < InDim; ++x)
+				if(DropControl == 1)
+				{
+					int MaskDims[3] = {1, 1, (Input->Dims[0] * OutDim + sizeof(double) - 1) / sizeof(double)};
+
+					DroppedMask = ArenaTensor(Space, 1, MaskDims);
+					if(DroppedMask.Data == NULL)
 					{
-						Output[y] += Input[x] * Weights[x][y];
+						printf("Memory Allocation Error.\n");
+						exit(MemoryError);
 					}
 
-				// --- Apply Act Func and overflow control --- //
+					Dropped = (char*) DroppedMask.Data;
 
-					if(Output[y] > MaxValue)
+					for(int sample = 0; sample < Input->Dims[0]; ++sample)
 					{
-						Output[y] = MaxValue;
-					}
-			        if(Params[0] == ReLu)
-			        {
-			            Output[y] = Output[y] > 0 ? Output[y] : 0;
-			        }
-			        else if(Params[0] == Sigmoid)
-			        {
-			            Output[y] = 1/(double)(1 + exp(-Output[y]));
-			        }
-			        else if(Params[0] == Tanh)
-			        {
-			            Output[y] = tanh(Output[y]);
-			        }
-			}
+						RandState SampleRand;
+						RandState* Rand = ThreadRand();
 
-			// Soft Layer Computations
-			if(Params[0] == Soft)
-			{
-				double Sum = 0;
+						if(DropFirst >= 0)
+						{
+							SeedRand(&SampleRand, DropSeed + ((uint64_t) DropLayer << 32) + DropFirst + sample);
+							Rand = &SampleRand;
+						}
 
-				// Find Sum
-				for(int y = 0; y < OutDim; ++y)
-				{
-					Output[y] = exp(Output[y]);
-					Sum += Output[y];
+						for(int y = 0; y < OutDim; ++y)
+						{
+							Dropped[sample * OutDim + y] = UniformRand(Rand) < Params[1];
+						}
+					}
+
+					DropLayer += DropFirst >= 0;
 				}
-				for(int y = 0; y < OutDim; ++y)
+
+			// --- Calculate Outputs --- //
+
+				FconArgs Args = {Input, Output, Weights, Params, Dropped};
+
+				ParallelFor(Workers, OutDim, FconTask, &Args);
+
+			// --- Soft Layer Computations --- //
+
+				if(Params[0] == Soft)
 				{
-					Output[y] /= Sum;
+					for(int sample = 0; sample < Input->Dims[0]; ++sample)
+					{
+						SoftmaxRow(Output->Data + sample * Output->Strides[0], OutDim);
+					}
 				}
-			}
+
+			// --- Free --- //
+
+				FreeTensor(&DroppedMask);
+				ReleaseArena(Space, Mark);
 		}
 
 	// 1.2 --- Backward Propagation --- //
 	
 	    /*
-	        Calculate Fcon Layer Backward Propagation
+	        Calculate Fcon Layer Backward Propagation. Weights are not changed, their Gradients are accumulated instead
 
-	        PrevInput - Input Volume from forward propagation
-	        InDim - Input Dimensions
-	        PrevOutput - Output Volume from forward propagation
-	        OutDim - Output Dimensions
+	        PrevInput - Input Volumes from forward propagation
+	        PrevOutput - Output Volumes from forward propagation
 	        Error - Error from next Layer
-	        Output - Error to Backpropagate onto previous Layer
-	        Weights - Fcon Weights
+	        Output - Error to Backpropagate onto previous Layer. NULL when nothing reads it
+	        Weights - Fcon Weights {1, 1, OutputSize, InputSize}. Row y holds the Weights of Output y
 	        Params - LayerParams
 			Set Params - 
 				[0] = Act Func;					// 0 means no Act Function (changed if add_act is called)
 				[1] = DropP;					// Drop Probability
 				[2] = Outputs;					// How many Outputs Calculated at once in DFE
-			LearningRate - LearningRate
+			Gradients - Weight Gradients, same Dimensions as Weights. This Layer's Gradients are added to it. NULL for a Frozen Layer
 
 	        Return Value - nothing
 	    */
 
-		void FconBackCpu(double* PrevInput, int InDim,							// Variables to Calculate Weight Updates
-						 double* PrevOutput, int OutDim, double* Error, 			// Variables to Calculate Delta
-						 double* Output,											// Variable to Store this Layer Error
-						 double** Weights, double* Params, 						// Weights + Params
-						 double LearningRate)									// Learning Rate
+		void FconBackCpu(Tensor* PrevInput,										// Variables to Calculate Weight Updates
+						 Tensor* PrevOutput, Tensor* Error, 						// Variables to Calculate Delta
+						 Tensor* Output,											// Variable to Store this Layer Error
+						 Tensor* Weights, double* Params, 						// Weights + Params
+						 Tensor* Gradients)										// Weight Gradients
 		{
 			/* Set Params
 			[0] = Act Func;					// 0 means no Act Function (changed if add_act is called)
@@ -125,53 +210,144 @@
 			[2] = Outputs;					// How many Outputs Calculated at once in DFE
 			*/
 
-			// --- Apply Act Func and Setup Delta --- //
+			int Samples = PrevInput->Dims[0];
+			int InDim = SampleSize(PrevInput);
+			int OutDim = SampleSize(PrevOutput);
 
-				double* Delta = Init1D(OutDim);
+			// Delta of every Sample, from the Scratch Arena of this Thread
+			Arena* Space = ScratchArena();
+			size_t Mark = Space->Used;
 
-				if(Params[0] == ReLu)
-		        {
-		        	for(int i = 0; i < OutDim; ++i)
-					{
-		            	Delta[i] =  PrevOutput[i] > 0 ? Error[i] : 0;
-		           	}
-		        }
-		        else if(Params[0] == Sigmoid)
-		        {
-		        	for(int i = 0; i < OutDim; ++i)
-					{
-			            Delta[i] = PrevOutput[i] * (1 - PrevOutput[i]) * Error[i];
+			int DeltaDims[3] = {1, 1, OutDim};
+
+			Tensor DeltaTensor = ArenaTensor(Space, Samples, DeltaDims);
+			if(DeltaTensor.Data == NULL)
+			{
+				printf("Memory Allocation Error.\n");
+				exit(MemoryError);
+			}
+
+			for(int sample = 0; sample < Samples; ++sample)
+			{
+				double* Prev = PrevOutput->Data + sample * PrevOutput->Strides[0];
+				double* Err = Error->Data + sample * Error->Strides[0];
+				double* Delta = DeltaTensor.Data + sample * DeltaTensor.Strides[0];
+
+				// --- Apply Act Func and Setup Delta --- //
+
+					if(Params[0] == ReLu)
+			        {
+			        	for(int i = 0; i < OutDim; ++i)
+						{
+			            	Delta[i] =  Prev[i] > 0 ? Err[i] : 0;
+			           	}
 			        }
+			        else if(Params[0] == Sigmoid)
+			        {
+			        	for(int i = 0; i < OutDim; ++i)
+						{
+				            Delta[i] = Prev[i] * (1 - Prev[i]) * Err[i];
+				        }
+					}
+			        else if(Params[0] == Tanh)  
+			        {   
+			        	for(int i = 0; i < OutDim; ++i)
+						{
+				            Delta[i] = (1 - pow(Prev[i], 2)) * Err[i];
+			            }
+			        }
+			        else	// Either Soft or no activation func
+			        {   
+			        	Copy1D(Err, Delta, OutDim);
+					}
+			}
+
+			// --- Calculate Output --- //
+
+				// Output = Delta * Weights. Each Delta scales the contiguous Row of Weights of its Output
+				if(Output == NULL)
+				{
+					// Nothing reads it
 				}
-		        else if(Params[0] == Tanh)  
-		        {   
-		        	for(int i = 0; i < OutDim; ++i)
-					{
-			            Delta[i] = (1 - pow(PrevOutput[i], 2)) * Error[i];
-		            }
-		        }
-		        else	// Either Soft or no activation func
-		        {   
-		        	Copy1D(Error, Delta, OutDim);
+				else if(Samples == 1)
+				{
+					Gemv(Trans, InDim, OutDim, 1, Weights->Data, InDim, DeltaTensor.Data, 0, Output->Data);
+				}
+				else
+				{
+					Gemm(NoTrans, NoTrans, Samples, InDim, OutDim,
+						 1, DeltaTensor.Data, DeltaTensor.Strides[0],
+						 Weights->Data, InDim,
+						 0, Output->Data, Output->Strides[0]);
 				}
 
-			// --- Calculate Output and Update Weights --- //
+			// --- Weight Gradients --- //
 
-				for(int i = 0; i < InDim; ++i)
-			    {
-			        for(int j = 0; j < OutDim; ++j)
-			        {
-			        	// --- Calculate Output --- //
+				// Gradients += Delta' * PrevInput, summed over the Samples in one Gemm
+				if(Gradients != NULL)
+				{
+					Gemm(Trans, NoTrans, OutDim, InDim, Samples,
+						 1, DeltaTensor.Data, DeltaTensor.Strides[0],
+						 PrevInput->Data, PrevInput->Strides[0],
+						 1, Gradients->Data, InDim);
+				}
 
-			            	Output[i] += (Delta[j] * Weights[i][j]);
+		   	// --- Free --- //
 
-			            // ---  Update Weights --- //
-			            	
-			            	Weights[i][j] -= (LearningRate * (Delta[j] * PrevInput[i]));
-			        }
-			    }
+			    FreeTensor(&DeltaTensor);
+			    ReleaseArena(Space, Mark);
+		}
 
-		   	// --- Free --- //
+// 2 --- Workspace --- //
+
+	/*
+		Doubles of Scratch Arena a Fcon Layer may take on one Thread.
+		Used to plan the Arenas once, when the Network is built
+
+		OutDims - Output Volume Dimensions
+		Samples - Volumes Forwarded at once
+		Training - 1 to include the Dropout Mask and the Backward Propagation
 
-			    Free1D(Delta);
+		Return Value - Doubles needed
+	*/
+
+	size_t FconScratch(int* OutDims, int Samples, char Training)
+	{
+		// Batches go through Gemm, single Samples through Gemv which needs nothing
+		size_t Product = Samples > 1 ? GemmScratch : 0;
+
+		if(!Training)
+		{
+			return Product;
 		}
+
+		int OutDim = OutDims[0] * OutDims[1] * OutDims[2];
+
+		int MaskDims[3] = {1, 1, (Samples * OutDim + sizeof(double) - 1) / sizeof(double)};
+		int DeltaDims[3] = {1, 1, OutDim};
+
+		// The Mask lives through the Forward Gemm. Delta through both Backward ones, which always use Gemm for the Weight Gradients
+		size_t Forward = ArenaDoubles(1, MaskDims) + Product;
+		size_t Backward = ArenaDoubles(Samples, DeltaDims) + GemmScratch;
+
+		return Forward > Backward ? Forward : Backward;
+	}
+
+// 3 --- Dropout Seed --- //
+
+	/*
+		Seed the Dropout of the Fcon Layers Forwarded next by the calling Thread.
+		Sample n of a Forward gets its Mask from Seed, its Position First + n and the Fcon Layer, so a Batch gets the same Masks however it is split
+
+		Seed - Seed of the Batch
+		First - Position in the Batch of the first Sample of the next Forwards. -1 draws Masks from ThreadRand again
+
+		Return Value - Nothing
+	*/
+
+	void SetDropoutSeed(uint64_t Seed, int First)
+	{
+		DropSeed = Seed;
+		DropFirst = First;
+		DropLayer = 0;
+	}
@@ -27,47 +27,162 @@
 			#define MaxPool 1
 			#define MeanPool 2
 
+		// 2.4 --- Conv Algorithms --- //
+
+			#define ConvAuto 0				// Pick by Layer Shape
+			#define ConvDirect 1			// Reference Loop
+			#define ConvGemm 2				// Im2Col + Gemm
+			#define ConvWinograd 3			// Winograd F(2x2,3x3) / F(4x4,3x3). KernelSize 3 and Stride 1 only
+			#define ConvFFT 4				// Tiled FFT (Overlap-Save). Stride 1 Forward, any Stride for the Input Gradient
+
+		// 2.5 --- Conv Directions --- //
+
+			#define ConvForward 0			// ConvForwCpu
+			#define ConvBackward 1			// Input Gradient in ConvBackCpu
+
+		// 2.6 --- Activation Accuracy --- //
+
+			#define ActPrecise 0			// exp within a few ulp of libm
+			#define ActFast 1				// Sigmoid, Tanh and Softmax within 2e-8 relative error of libm
+
 	// 3 --- Overflow Control --- //
 
 			#define MaxValue 1000
 
-	// 4 --- Function Prototypes --- //
+	// 4 --- Algorithm Selection --- //
+
+		// 4.1 --- Cost Model --- //
+
+			// Costs are counted in Gemm Multiply-Adds
+
+			#define ConvGemmMinWork 8192	// Multiply-Adds per Sample below which Im2Col costs more than it saves
+			#define ConvDirectCost 10		// Cost of one Multiply-Add of the Direct Loop
+			#define GemmPackCost 4			// Cost of copying one element into a Gemm Panel or Im2Col Matrix
+			#define TransformCost 8			// Cost of one scalar Multiply-Add in the Winograd and FFT Tile Transforms
+
+		// 4.2 --- Gemm --- //
+
+			#define ConvGemmColumns 128		// Gemm Columns Im2Col lowers at once. Layers with fewer Output Pixels lower several Samples together
+
+		// 4.3 --- Winograd --- //
+
+			#define WinogradF4MinSize 8		// Output Height and Width from which F(4x4,3x3) is used instead of F(2x2,3x3)
+			#define WinogradWorkspace (1 << 20)	// Doubles of transformed Input + Products kept at a time
+
+		// 4.4 --- FFT --- //
+
+			#define FFTMinTile 8			// Smallest FFT size tried
+			#define FFTMaxTile 64			// Largest FFT size tried
+			#define FFTMaxSpectra (1 << 24)	// Doubles of Filter Spectra a Layer may keep per Direction
+			#define FFTWorkspace (1 << 20)	// Doubles of Input Spectra + Products kept at a time
+
+	// 5 --- Structures --- //
+
+		// 5.1 --- Conv Cache --- //
+
+			// Index 0 is used by ConvForwCpu (ConvForward), index 1 by the Input Gradient, from the Rotated Filters (ConvBackward)
+
+			typedef struct
+			{
+				Tensor Winograd[2];			// Winograd Filters {Tile^2, 1, NKernels, Channels}
+				Tensor Spectra[2];			// FFT Filter Spectra {Bins, 2, NKernels, Channels}. Dim 1 holds real and imaginary parts
+
+				char WinogradValid[2];		// 1 if Winograd matches the current Weights
+				char SpectraValid[2];		// 1 if Spectra matches the current Weights
 
-		// 4.1 --- Conv --- //
+			} ConvCache;
 
-			void ConvForwCpu(double*** Input, int* InDims,           // Input
-		                     double*** Output,                       // Output
-		                     double**** Filters, double* Params);     // Weights + Params
+	// 6 --- Function Prototypes --- //
 
-			void ConvBackCpu(double*** PrevInput, int* InDims,                           // Varibles to Calculate Weight Updates
-		                     double*** PrevOutput, int* OutDims, double*** Error,     	// Variables to Calculate Delta
-		                     double*** Output,                                       	// Variable to Store Error from this layer
-		                     double**** Filters, double* Params,                      	// Weights + Params
-		                     double LearningRate);                                    	// Learning Rate
+		// 6.1 --- Conv --- //
 
-		// 4.2 --- Fcon --- //
+			void SetConvAlgorithm(char Algorithm);
 
-			void FconForwCpu(double* Input, int InDim, 				// Input
-							 double* Output, int OutDim, 			// Output
-							 double** Weights, double* Params,		// Weights + Params
-							 char DropControl);						// Control Dropout
+			void InvalidateConvCache(ConvCache* Cache);
+			void FreeConvCache(ConvCache* Cache);
 
-			void FconBackCpu(double* PrevInput, int InDim,								// Variables to Calculate Weight Updates
-							 double* PrevOutput, int OutDim, double* Error, 				// Variables to Calculate Delta
-							 double* Output,												// Variable to Store this Layer Error
-							 double** Weights, double* Params, 							// Weights + Params
-							 double LearningRate);										// Learning Rate
+			void ConvForwCpu(Tensor* Input,                          // Input
+		                     Tensor* Output,                         // Output
+		                     Tensor* Filters, double* Params,        // Weights + Params
+		                     ConvCache* Cache,                       // Transformed Weights. Can be NULL
+		                     ThreadPool* Workers);                   // Threads. Can be NULL
 
-		// 4.3 --- Pool --- //
+			void ConvBackCpu(Tensor* PrevInput,                                          // Varibles to Calculate Weight Updates
+		                     Tensor* PrevOutput, Tensor* Error,                         	// Variables to Calculate Delta
+		                     Tensor* Output,                                           	// Variable to Store Error from this layer
+		                     Tensor* Filters, double* Params,                          	// Weights + Params
+		                     ConvCache* Cache,                                          // Transformed Weights. Can be NULL
+		                     Tensor* Gradients);                                       	// Weight Gradients, accumulated
 
-			void PoolForwCpu(double*** Input, int* InDims,           // Input
-	                         double*** Mask,                         // Mask to fill up
-	                         double*** Output,                       // Output
-	                         double* Params);                        // Params
+			void ConvPoolForwCpu(Tensor* Input,                          // Input
+		                         Tensor* Output,                         // Pool Output
+		                         Tensor* Filters, double* ConvParams,    // Conv Weights + Params
+		                         double* PoolParams,                     // Pool Params
+		                         Tensor* Mask,                           // Max Positions of the Pool Layer. Can be NULL
+		                         ConvCache* Cache,                       // Transformed Weights. Can be NULL
+		                         ThreadPool* Workers);                   // Threads. Can be NULL
 
-			void PoolBackCpu(double*** PrevOutput, int* OutDims, double*** Error,     	// Variable to Calculate Delta
-			                 double*** Mask,                                             // Variable to Calculate this layer Error
-			                 double*** Output,                                           // Variable to Store this layer Error
+			size_t ConvScratch(int* InDims, int* OutDims, double* Params, int Samples, char Training);
+			size_t ConvPoolScratch(int* InDims, int* OutDims, double* ConvParams, double* PoolParams, int Samples);
+
+		// 6.2 --- Winograd --- //
+
+			int WinogradTile(int OutHeight, int OutWidth);
+
+			void RotateFilters(Tensor* Filters, Tensor* Rotated);
+			void WinogradFilters(Tensor* Filters, Tensor* Transformed, int OutTile);
+
+			int WinogradConv(Tensor* Input, Tensor* Output, Tensor* Transformed, int Padding, ThreadPool* Workers);
+
+		// 6.3 --- FFT --- //
+
+			void FFTFilters(Tensor* Filters, Tensor* Spectra, int Tile);
+
+			int FFTConv(Tensor* Input, Tensor* Output, Tensor* Spectra, int KernelSize, int Padding, ThreadPool* Workers);
+
+		// 6.4 --- Fcon --- //
+
+			void FconForwCpu(Tensor* Input, 						// Input
+							 Tensor* Output, 						// Output
+							 Tensor* Weights, double* Params,		// Weights + Params
+							 char DropControl,						// Control Dropout
+							 ThreadPool* Workers);					// Threads. Can be NULL
+
+			void FconBackCpu(Tensor* PrevInput,											// Variables to Calculate Weight Updates
+							 Tensor* PrevOutput, Tensor* Error, 							// Variables to Calculate Delta
+							 Tensor* Output,												// Variable to Store this Layer Error
+							 Tensor* Weights, double* Params, 							// Weights + Params
+							 Tensor* Gradients);										// Weight Gradients, accumulated
+
+			size_t FconScratch(int* OutDims, int Samples, char Training);
+
+			void SetDropoutSeed(uint64_t Seed, int First);
+
+		// 6.5 --- Pool --- //
+
+			void PoolForwCpu(Tensor* Input,                          // Input
+	                         Tensor* Mask,                           // Max Positions to fill up
+	                         Tensor* Output,                         // Output
+	                         double* Params,                         // Params
+	                         ThreadPool* Workers);                   // Threads. Can be NULL
+
+			void PoolBackCpu(Tensor* PrevOutput, Tensor* Error,                        	// Variable to Calculate Delta
+			                 Tensor* Mask,                                               // Max Positions, to Calculate this layer Error
+			                 Tensor* Output,                                             // Variable to Store this layer Error
 			                 double* Params);                                            // Params
+
+			void PoolRowCpu(double* Input, int InStride, int Base, double* Params, int Outputs, double* Output, int* Argmax);
+
+			void PoolMaskDims(int* InDims, double* Params, int* MaskDims);
+			void FitPoolMask(Tensor* Mask, int Samples);
+			int* PoolArgmax(Tensor* Mask, int Sample);
+
+		// 6.6 --- Activation --- //
+
+			void SetActivationAccuracy(char Accuracy);
+
+			void ActivateRow(double* Values, int Count, double Act);
+			void ActivateTensor(Tensor* Values, double Act, ThreadPool* Workers);		// Workers can be NULL
+			void SoftmaxRow(double* Values, int Count);
 			
 #endif        
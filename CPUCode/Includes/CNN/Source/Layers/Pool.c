@@ -5,10 +5,17 @@
                 
     1 - Math Operations
         1.1 - PoolWindow
+        1.2 - Pool Rows
+        1.3 - Pool Row
 
     2 - Layer Propagation
         2.1 - Forward Propagation
         2.2 - Backward Propagation
+
+    3 - Mask
+        3.1 - Dimensions
+        3.2 - Fit
+        3.3 - Argmax
 */
 
 // 1 --- Math Operations --- //
@@ -18,19 +25,18 @@
         /*
             Calculate Pool value of a Window Size
 
-            Input - Input Volume
-            StartX - X position of Input
-            StartY - Y position of Input
+            Input - First Pixel of the Input Window
+            InStride - Elements between consecutive Rows of Input
             Type - Max/Mean Pool
             WindowSize - WindowSize ( 2 means 2x2, 3 means 3x3, etc...)
-            Mask - Mask for Backward Propagation
+            Offset - Where to place the Position of the Max Value, counted from Input in Elements. Not changed by Mean Pool
 
             Return Value - Pool Result
         */
 
-        static double PoolWindow(double** Input, int StartX, int StartY, char Type, char WindowSize, double** Mask)
+        static double PoolWindow(double* Input, int InStride, char Type, char WindowSize, int* Offset)
         {
-            double out;
+            double out = 0;
             switch(Type)
             {
                 case MaxPool:     // Max pooling
@@ -38,141 +44,336 @@
                         // Start out with minimum possible value for a double
                         out = -DBL_MAX;
 
-                        int MaxX = 0, MaxY = 0;
-
                         // Go Through Window and find highest Value
-                        for(int y = StartY; y < StartY + WindowSize; ++y)
+                        for(int y = 0; y < WindowSize; ++y)
                         {
-                            for(int x = StartX; x < StartX + WindowSize; ++x)
+                            for(int x = 0; x < WindowSize; ++x)
                             {
-                                if(Input[y][x] > out)
+                                if(Input[y * InStride + x] > out)
                                 {
-                                    out = Input[y][x];
+                                    out = Input[y * InStride + x];
 
                                     // Store Position of Maximum Value
-                                    MaxY = y;
-                                    MaxX = x;
+                                    *Offset = y * InStride + x;
                                 }
                             }
                         }
-                        // Set 1 in Position where the Max Value was found
-                        Mask[MaxY][MaxX] = 1;
                         
                         break;
 
                 case MeanPool:     // Mean pooling
 
-                        // Start out with 0
-                        out = 0;
-
                         // Sum all Values in Window
-                        for(int y = StartY; y < StartY + WindowSize; ++y)
+                        for(int y = 0; y < WindowSize; ++y)
                         {
-                            for(int x = StartX; x < StartX + WindowSize; ++x)
+                            for(int x = 0; x < WindowSize; ++x)
                             {
-                                out += Input[y][x];
+                                out += Input[y * InStride + x];
                             }
                         }
 
                         // Divide by WindowSize to Calculate Average
                         out /= (WindowSize * WindowSize);
 
-                        // Place Average Value of Window in all Values of Mask
-                        for(int y = StartY; y < StartY + WindowSize; ++y)
-                        {
-                            for(int x = StartX; x < StartX + WindowSize; ++x)
-                            {
-                                Mask[y][x] += out;
-                            }
-                        }
-
                         break;
             }
             
             return out;
         }
 
-// 2 --- Layer Propagation --- //
+    // 1.2 --- Pool Rows --- //
 
-    // 2.1 --- Forward Propagation --- //
+        // 4 doubles handled as a single value, loaded from any double. They map to 2 SSE2 or 1 AVX register
+        typedef double PoolVector4 __attribute__ ((vector_size (32), aligned (8)));
+
+        // Comparison Result of 2 PoolVector4, and the Positions of 4 Outputs
+        typedef long long PoolLanes4 __attribute__ ((vector_size (32)));
 
         /*
-            Calculate Pooling Layer Backprop
+            Load the first Pixel of 4 neighbouring Windows. Stride 2 takes every other Pixel of In[0..6],
+            so nothing after the last Window is read
 
-            Input - Input Volume
-            InDims - Input Dimensions
-            Mask - Mask for Backprop
-            Output - Output Volume
-            Params - LayerParams
-                [0] = ActFunc               // 0 - None, 1 - Relu, 2 - Sigmoid, 3 - Tanh
-                [1] = WindowSize            // Pool Size : 2 means 2x2, 3 means 3x3, etc
-                [2] = Type;                 // Type: 1 - Max Pooling, 2 - Mean Pooling
-                [3] = Stride;               // How many pixels Pooling Block moves at a time
-                
-            Return Value - Pool Result
+            In - First Pixel of the first Window
+            Stride - Pixels between Windows, 1 or 2
+
+            Pixels - Where to place the Pixels
+
+            Return Value - Nothing
         */
 
+        static inline __attribute__ ((always_inline)) void PoolLoad(double* In, int Stride, PoolVector4* Pixels)
+        {
+            if(Stride == 1)
+            {
+                *Pixels = *((PoolVector4*) In);
+            }
+            else
+            {
+                *Pixels = __builtin_shuffle(*((PoolVector4*) In), *((PoolVector4*) (In + 3)), (PoolLanes4) {0, 2, 5, 7});
+            }
+        }
 
-        void PoolForwCpu(double*** Input, int* InDims,           // Input
-                         double*** Mask,                         // Mask to fill up
-                         double*** Output,                       // Output
-                         double* Params)                         // Params
+        /*
+            Pool 4 Outputs of a Row at a time. The Window is walked in the same order as PoolWindow, so Max Pool keeps the first Max
+            and Mean Pool adds in the same order, and every Output is the same as PoolWindow's.
+            Only Strides 1 and 2 are done here, which covers 2x2 and 3x3 Windows with Stride 2 and the overlapping Stride 1 ones
+
+            Input - First Pixel of the Row
+            InStride - Elements between consecutive Rows of Input
+            Base - Position of Input, counted from the start of its Channel
+            Type - Max/Mean Pool
+            WindowSize - WindowSize
+            Stride - Pixels between Windows
+            Outputs - Outputs in the Row
+            Output - Where to place the Pool Results
+            Argmax - Where to place the Positions of the Max Values. Can be NULL
+
+            Return Value - Outputs done, a multiple of 4
+        */
+
+        static inline __attribute__ ((always_inline)) int PoolRows(double* Input, int InStride, int Base, char Type, int WindowSize, int Stride,
+                                                                   int Outputs, double* Output, int* Argmax)
         {
+            if(Stride != 1 && Stride != 2)
+            {
+                return 0;
+            }
 
-            // Processing cicle
-            for(int channel = 0; channel < InDims[0]; ++channel)
+            int outx = 0;
+
+            for(; outx + 4 <= Outputs; outx += 4)
             {
-                // Output Counters
-                int outx = 0;
-                int outy = 0;
-                
-                // Go Through entire Input
-                for(int y = 0; y <= InDims[1] - Params[1]; y += Params[3])
+                double* In = Input + outx * Stride;
+
+                if(Type == MaxPool)
                 {
-                    for(int x = 0; x <= InDims[1] - Params[1]; x += Params[3])
+                    PoolVector4 Best = {-DBL_MAX, -DBL_MAX, -DBL_MAX, -DBL_MAX};
+                    PoolLanes4 Where = {0};
+                    PoolLanes4 Lanes = (PoolLanes4) {0, Stride, 2 * Stride, 3 * Stride} + (Base + outx * Stride);
+
+                    for(int y = 0; y < WindowSize; ++y)
                     {
+                        for(int x = 0; x < WindowSize; ++x)
+                        {
+                            PoolVector4 Pixels;
+                            PoolLoad(In + y * InStride + x, Stride, &Pixels);
 
-                        // --- Pool --- //
+                            // Lanes where the Pixel is a new Max take it and its Position
+                            PoolLanes4 Greater = (PoolLanes4) (Pixels > Best);
 
-                            Output[channel][outy][outx] = PoolWindow(Input[channel], x, y, Params[2], Params[1], Mask[channel]);
+                            Best = (PoolVector4) (((PoolLanes4) Pixels & Greater) | ((PoolLanes4) Best & ~Greater));
+                            Where = ((Lanes + (y * InStride + x)) & Greater) | (Where & ~Greater);
+                        }
+                    }
 
-                        // --- Act Func --- //
+                    for(int i = 0; i < 4; ++i)
+                    {
+                        Output[outx + i] = Best[i];
+                    }
 
-                            if(Params[0] == ReLu)
-                            {
-                                Output[channel][outy][outx] = Output[channel][outy][outx] > 0 ? Output[channel][outy][outx] : 0;
-                            }
-                            else if(Params[0] == Sigmoid)
-                            {
-                                Output[channel][outy][outx] = 1/(double)(1 + exp(-Output[channel][outy][outx]));
-                            }
-                            else if(Params[0] == Tanh)
-                            {
-                                Output[channel][outy][outx] = tanh(Output[channel][outy][outx]);
-                            }
+                    if(Argmax != NULL)
+                    {
+                        for(int i = 0; i < 4; ++i)
+                        {
+                            Argmax[outx + i] = Where[i];
+                        }
+                    }
+                }
+                else
+                {
+                    PoolVector4 Sum = {0};
 
-                        // Go Right
-                        ++outx;
+                    for(int y = 0; y < WindowSize; ++y)
+                    {
+                        for(int x = 0; x < WindowSize; ++x)
+                        {
+                            PoolVector4 Pixels;
+                            PoolLoad(In + y * InStride + x, Stride, &Pixels);
+
+                            Sum += Pixels;
+                        }
                     }
 
-                    // Come Back
-                    outx = 0;
+                    Sum /= (double) (WindowSize * WindowSize);
+
+                    for(int i = 0; i < 4; ++i)
+                    {
+                        Output[outx + i] = Sum[i];
+                    }
+                }
+            }
+
+            return outx;
+        }
+
+        static int PoolRowsSse(double* Input, int InStride, int Base, char Type, int WindowSize, int Stride, int Outputs, double* Output, int* Argmax)
+        {
+            return PoolRows(Input, InStride, Base, Type, WindowSize, Stride, Outputs, Output, Argmax);
+        }
+
+    #if defined(__x86_64__) || defined(__i386__)
+
+        __attribute__ ((target ("avx2")))
+        static int PoolRowsAvx(double* Input, int InStride, int Base, char Type, int WindowSize, int Stride, int Outputs, double* Output, int* Argmax)
+        {
+            return PoolRows(Input, InStride, Base, Type, WindowSize, Stride, Outputs, Output, Argmax);
+        }
+
+    #endif
+
+        // Pool Rows Kernel picked for this CPU on the first call to PoolRowCpu
+        static int (*PoolRowsKernel)(double* Input, int InStride, int Base, char Type, int WindowSize, int Stride, int Outputs, double* Output, int* Argmax);
+
+        /*
+            Pick the widest Pool Rows Kernel this CPU supports
+
+            Return Value - Nothing
+        */
+
+        static void SelectPoolKernel()
+        {
+            PoolRowsKernel = PoolRowsSse;
+
+            #if defined(__x86_64__) || defined(__i386__)
+
+                __builtin_cpu_init();
+
+                if(__builtin_cpu_supports("avx2"))
+                {
+                    PoolRowsKernel = PoolRowsAvx;
+                }
+
+            #endif
+        }
+
+    // 1.3 --- Pool Row --- //
+
+        /*
+            Pool one Output Row, without Act Func. Strides the Kernels don't handle, and the Outputs left over, go through PoolWindow
+
+            Input - First Pixel of the Input Row
+            InStride - Elements between consecutive Rows of Input
+            Base - Position of Input, counted from the start of its Channel. Max Positions are counted from there too
+            Params - LayerParams of the Pool Layer
+            Outputs - Outputs in the Row
+            Output - Where to place the Pool Results
+            Argmax - Where to place the Positions of the Max Values. Can be NULL
+
+            Return Value - Nothing
+        */
+
+        void PoolRowCpu(double* Input, int InStride, int Base, double* Params, int Outputs, double* Output, int* Argmax)
+        {
+            int WindowSize = Params[1];
+            char Type = Params[2];
+            int Stride = Params[3];
+
+            if(PoolRowsKernel == NULL)
+            {
+                SelectPoolKernel();
+            }
+
+            int outx = PoolRowsKernel(Input, InStride, Base, Type, WindowSize, Stride, Outputs, Output, Argmax);
+
+            for(; outx < Outputs; ++outx)
+            {
+                int Offset = 0;
+
+                Output[outx] = PoolWindow(Input + outx * Stride, InStride, Type, WindowSize, &Offset);
+
+                if(Argmax != NULL)
+                {
+                    Argmax[outx] = Base + outx * Stride + Offset;
+                }
+            }
+        }
+
+// 2 --- Layer Propagation --- //
+
+    // 2.1 --- Forward Propagation --- //
+
+        // Arguments of PoolTask
+        typedef struct
+        {
+            Tensor* Input;
+            Tensor* Mask;
+            Tensor* Output;
+            double* Params;
+
+        } PoolArgs;
+
+        // Pool Channels [Start, End) of every Sample. Item i is Channel i % Channels of Sample i / Channels
+        static void PoolTask(void* Args, int Start, int End, int Thread)
+        {
+            (void) Thread;
+
+            Tensor* Input = ((PoolArgs*) Args)->Input;
+            Tensor* Mask = ((PoolArgs*) Args)->Mask;
+            Tensor* Output = ((PoolArgs*) Args)->Output;
+            double* Params = ((PoolArgs*) Args)->Params;
+
+            int Stride = Params[3];
 
-                    // Go Down
-                    ++outy;
+            for(int i = Start; i < End; ++i)
+            {
+                int sample = i / Input->Dims[1];
+                int channel = i % Input->Dims[1];
+
+                int* Argmax = PoolArgmax(Mask, sample) + channel * Output->Dims[2] * Output->Dims[3];
+
+                // Go Through entire Output. Max Positions are counted from the start of the Input Channel
+                for(int outy = 0; outy < Output->Dims[2]; ++outy)
+                {
+                    int Base = outy * Stride * Input->Strides[2];
+                    double* Out = TensorRow(Output, sample, channel, outy);
+
+                    PoolRowCpu(TensorRow(Input, sample, channel, 0) + Base, Input->Strides[2], Base, Params, Output->Dims[3], Out, Argmax + outy * Output->Dims[3]);
+
+                    // --- Act Func --- //
+
+                        ActivateRow(Out, Output->Dims[3], Params[0]);
                 }
             }
         }
 
+        /*
+            Calculate Pooling Layer Forward Propagation
+
+            Input - Input Volumes
+            Mask - Where to place the Position of the Max of every Output, for Backprop. Made with FitPoolMask
+            Output - Output Volumes
+            Params - LayerParams
+                [0] = ActFunc               // 0 - None, 1 - Relu, 2 - Sigmoid, 3 - Tanh
+                [1] = WindowSize            // Pool Size : 2 means 2x2, 3 means 3x3, etc
+                [2] = Type;                 // Type: 1 - Max Pooling, 2 - Mean Pooling
+                [3] = Stride;               // How many pixels Pooling Block moves at a time
+            Workers - Threads to split Channels among. Can be NULL
+                
+            Return Value - Pool Result
+        */
+
+
+        void PoolForwCpu(Tensor* Input,                          // Input
+                         Tensor* Mask,                           // Max Positions
+                         Tensor* Output,                         // Output
+                         double* Params,                         // Params
+                         ThreadPool* Workers)                       // Threads
+        {
+            PoolArgs Args = {Input, Mask, Output, Params};
+
+            // Channels only write their own part of Mask, so they can be Pooled in any order
+            ParallelFor(Workers, Input->Dims[0] * Input->Dims[1], PoolTask, &Args);
+        }
+
     // 2.2 --- Backward Propagation --- //
 
         /*
             Calculate Pool Layer Backprop
 
-            Input - Input Volume
-            InDims - Input Dimensions
-            Mask - Mask for Backprop
-            Output - Output Volume
+            PrevOutput - Output Volumes from previous ForwardPropagation
+            Error - Error from Next Layer
+            Mask - Max Positions filled by PoolForwCpu
+            Output - Output Volumes
             Params - LayerParams
                 [0] = ActFunc               // 0 - None, 1 - Relu, 2 - Sigmoid, 3 - Tanh
                 [1] = WindowSize            // Pool Size : 2 means 2x2, 3 means 3x3, etc
@@ -182,101 +383,140 @@
             Return Value - Pool Result
         */
 
-        void PoolBackCpu(double*** PrevOutput, int* OutDims, double*** Error,                        // Variable to Calculate Delta
-                         double*** Mask,                                                             // Variable to Calculate this layer Error
-                         double*** Output,                                                           // Variable to Store this layer Error
+        void PoolBackCpu(Tensor* PrevOutput, Tensor* Error,                                          // Variable to Calculate Delta
+                         Tensor* Mask,                                                               // Variable to Calculate this layer Error
+                         Tensor* Output,                                                             // Variable to Store this layer Error
                          double* Params)                                                             // Params
         {
+            int WindowSize = Params[1];
+            int Stride = Params[3];
 
-            // --- Apply Act Func and Prepare Delta --- //
+            // Errors are scattered into Output. It may come straight from a Scratch Arena, and Inputs no Window covers get no Error
+            ZeroTensor(Output);
 
-                double*** Delta = Init3D(OutDims);
+            for(int sample = 0; sample < PrevOutput->Dims[0]; ++sample)
+            {
+                for (int channel = 0; channel < PrevOutput->Dims[1]; ++channel) 
+                {
+                    int* Argmax = PoolArgmax(Mask, sample) + channel * PrevOutput->Dims[2] * PrevOutput->Dims[3];
+                    double* Plane = TensorRow(Output, sample, channel, 0);
 
-                    // Put the Value ( Depending on Activation Function ) in the Correct Spots 
-                    if(Params[0] == ReLu)
+                    for (int y = 0; y < PrevOutput->Dims[2]; ++y) 
                     {
-                        for(int channel = 0; channel < OutDims[0]; ++channel)
-                        {  
-                            for(int y = 0; y < OutDims[1]; ++y)
-                            {
-                                for(int x = 0; x < OutDims[1]; ++x)
+                        for (int x = 0; x < PrevOutput->Dims[3]; ++x) 
+                        {
+                            // --- Apply Act Func and Prepare Delta --- //
+
+                                double Out = TensorAt(PrevOutput, sample, channel, y, x);
+                                double Delta = TensorAt(Error, sample, channel, y, x);
+
+                                // Put the Value ( Depending on Activation Function ) in the Correct Spots 
+                                if(Params[0] == ReLu)
                                 {
-                                    Delta[channel][y][x] =  PrevOutput[channel][x][y] > 0 ? Error[channel][y][x] : 0;
+                                    Delta = Out > 0 ? Delta : 0;
                                 }
-                            }
-                        }
-                    }
-                    else if(Params[0] == Sigmoid)
-                    {
-                        for(int channel = 0; channel < OutDims[0]; ++channel)
-                        {
-                            for(int y = 0; y < OutDims[1]; ++y)
-                            {
-                                for(int x = 0; x < OutDims[1]; ++x)
+                                else if(Params[0] == Sigmoid)
                                 {
-                                    Delta[channel][y][x] = (PrevOutput[channel][y][x] * 1 - PrevOutput[channel][y][x]) * Error[channel][y][x];
+                                    Delta = Out * (1 - Out) * Delta;
                                 }
-                            }
-                        }
-                    }
-                    else if(Params[0] == Tanh)  
-                    {   
-                        for(int channel = 0; channel < OutDims[0]; ++channel)
-                        {
-                            for(int y = 0; y < OutDims[1]; ++y)
-                            {
-                                for(int x = 0; x < OutDims[1]; ++x)
+                                else if(Params[0] == Tanh)  
+                                {   
+                                    Delta = (1 - pow(Out, 2)) * Delta;
+                                }
+
+                            // --- Calculate Output --- //
+
+                                // Max Pool gives all the Error to the Max of the Window, Mean Pool shares it between every Pixel of the Window
+                                if(Params[2] == MaxPool)
                                 {
-                                    Delta[channel][y][x] = (1 - pow(PrevOutput[channel][y][x], 2)) * Error[channel][y][x];
+                                    Plane[Argmax[y * PrevOutput->Dims[3] + x]] += Delta;
                                 }
-                            }
-                        }
-                    }
-                    else            // No activation Function
-                    {
-                        for(int channel = 0; channel < OutDims[0]; ++channel)
-                        {
-                            for(int y = 0; y < OutDims[1]; ++y)
-                            {
-                                for(int x = 0; x < OutDims[1]; ++x)
+                                else
                                 {
-                                    Delta[channel][y][x] =  Error[channel][y][x];
+                                    double* Window = Plane + y * Stride * Output->Strides[2] + x * Stride;
+
+                                    for(int MaskY = 0; MaskY < WindowSize; ++MaskY)
+                                    {
+                                        for(int MaskX = 0; MaskX < WindowSize; ++MaskX)
+                                        {
+                                            Window[MaskY * Output->Strides[2] + MaskX] += Delta / (WindowSize * WindowSize);
+                                        }
+                                    }
                                 }
-                            }
                         }
                     }
+                }
+            }
+        }
 
-            // --- Calculate Output --- //
+// 3 --- Mask --- //
 
-                // Go Through Entire Output. Select Window from Mask. 
-                // Multiply the Value of the Output relative to that Window by the Values of Mask
-                // Mask Contains 1 for the spot where the value was selected and 0 otherwise (Max Pool), in all spots of the Window
-                // or the Average ( Mean Pool), in all spots of the Window
+    // 3.1 --- Dimensions --- //
 
-                // Go Through Output
-                for (int channel = 0; channel < OutDims[0]; ++channel) 
-                {
-                    for (int y = 0; y < OutDims[1]; ++y) 
-                    {
-                        for (int x = 0; x < OutDims[2]; ++x) 
-                        {
-                            // Select Window
-                            for(int MaskY = 0; MaskY < Params[1]; ++MaskY)
-                            {
-                                for(int MaskX = 0; MaskX < Params[1]; ++MaskX)
-                                {
-                                    int outy = (int)(y * Params[1]) + MaskY;
-                                    int outx = (int)(x * Params[1]) + MaskX;
+        /*
+            Dimensions of the Mask of a Pool Layer, for one Sample. The Mask holds one int per Output, the Position of its Max,
+            packed in Doubles so it can be kept in a Tensor
 
-                                    Output[channel][outy][outx] = Mask[channel][outy][outx] * Delta[channel][y][x];
-                                    Mask[channel][outy][outx] = 0;
-                                }
-                            }
-                        }
-                    }
+            InDims - Input Volume Dimensions
+            Params - LayerParams
+            MaskDims - Where to place the Mask Dimensions
+
+            Return Value - Nothing
+        */
+
+        void PoolMaskDims(int* InDims, double* Params, int* MaskDims)
+        {
+            int WindowSize = Params[1];
+            int Stride = Params[3];
+
+            size_t Outputs = (size_t) InDims[0] * ((InDims[1] - WindowSize) / Stride + 1) * ((InDims[2] - WindowSize) / Stride + 1);
+
+            MaskDims[0] = 1;
+            MaskDims[1] = 1;
+            MaskDims[2] = (Outputs * sizeof(int) + sizeof(double) - 1) / sizeof(double);
+        }
+
+    // 3.2 --- Fit --- //
+
+        /*
+            Prepare a Pool Mask for a Forward Propagation of Samples Volumes. The Mask is grown if it holds fewer Volumes.
+            Every Position is written by the Forward Propagation, so the Mask never has to be cleared
+
+            Mask - Mask of a Pool Layer, with Dimensions from PoolMaskDims
+            Samples - Volumes the next Forward Propagation has
+
+            Return Value - Nothing
+        */
+
+        void FitPoolMask(Tensor* Mask, int Samples)
+        {
+            if(Mask->Dims[0] < Samples)
+            {
+                int Dims[3] = {Mask->Dims[1], Mask->Dims[2], Mask->Dims[3]};
+
+                FreeTensor(Mask);
+                *Mask = InitTensor(Samples, Dims);
+
+                if(Mask->Data == NULL)
+                {
+                    printf("Memory Allocation Error.\n");
+                    exit(MemoryError);
                 }
+            }
+        }
 
-            // --- Free --- //
+    // 3.3 --- Argmax --- //
 
-                Free3D(Delta);
+        /*
+            Max Positions of a Sample in a Pool Mask. Position of Output (channel, y, x) is at index (channel * OutHeight + y) * OutWidth + x
+
+            Mask - Mask of a Pool Layer
+            Sample - Sample
+
+            Return Value - Max Positions of Sample
+        */
+
+        int* PoolArgmax(Tensor* Mask, int Sample)
+        {
+            return (int*) (Mask->Data + (size_t) Sample * Mask->Strides[0]);
         }
@@ -0,0 +1,538 @@
+#include "../../CNN.h"
+
+/*
+                File Structure
+
+    1 - Transforms
+        1.1 - Matrices
+        1.2 - Select Transform
+        1.3 - Tile Size
+
+    2 - Filter Transform
+        2.1 - Rotate Filters
+        2.2 - Transform Filters
+
+    3 - Convolution
+        3.1 - Input Transform
+        3.2 - Output Transform
+        3.3 - Convolution
+*/
+
+// 1 --- Transforms --- //
+
+    // 1.1 --- Matrices --- //
+
+        //  Winograd F(m x m, 3x3) computes an m x m Output Tile from an (m + 2) x (m + 2) Input Tile as
+        //
+        //      Y = AT [ (G g GT) * (BT d B) ] A
+        //
+        //  where g is the 3x3 Filter, d the Input Tile and * the element wise product.
+        //  G g GT only depends on the Weights, so it is done once per Weight Update.
+        //  The element wise product summed over Channels is, for each of the (m + 2)^2 positions,
+        //  a {NKernels, Channels} x {Channels, Tiles} Matrix Product, which is handed to Gemm.
+        //
+        //  F(2x2, 3x3) needs 16 Multiplications per Output Tile instead of 36 (2.25x less),
+        //  F(4x4, 3x3) needs 36 instead of 144 (4x less), at the cost of a slightly larger rounding error.
+
+        typedef struct
+        {
+            int OutTile;                // m
+            int InTile;                 // m + 2
+
+            const double* BT;           // {InTile, InTile}
+            const double* G;            // {InTile, 3}
+            const double* AT;           // {OutTile, InTile}
+
+        } WinogradTransform;
+
+        static const double BT2[16] = { 1,  0, -1,  0,
+                                        0,  1,  1,  0,
+                                        0, -1,  1,  0,
+                                        0,  1,  0, -1};
+
+        static const double G2[12] = {  1,    0,    0,
+                                      0.5,  0.5,  0.5,
+                                      0.5, -0.5,  0.5,
+                                        0,    0,    1};
+
+        static const double AT2[8] = {  1,  1,  1,  0,
+                                        0,  1, -1, -1};
+
+        static const double BT4[36] = { 4,  0, -5,  0,  1,  0,
+                                        0, -4, -4,  1,  1,  0,
+                                        0,  4, -4, -1,  1,  0,
+                                        0, -2, -1,  2,  1,  0,
+                                        0,  2, -1, -2,  1,  0,
+                                        0,  4,  0, -5,  0,  1};
+
+        static const double G4[18] = {   1/4.0,       0,       0,
+                                        -1/6.0,  -1/6.0,  -1/6.0,
+                                        -1/6.0,   1/6.0,  -1/6.0,
+                                        1/24.0,  1/12.0,   1/6.0,
+                                        1/24.0, -1/12.0,   1/6.0,
+                                             0,       0,       1};
+
+        static const double AT4[24] = { 1,  1,  1,  1,  1,  0,
+                                        0,  1, -1,  2, -2,  0,
+                                        0,  1,  1,  4,  4,  0,
+                                        0,  1, -1,  8, -8,  1};
+
+        static const WinogradTransform F2x2 = {2, 4, BT2, G2, AT2};
+        static const WinogradTransform F4x4 = {4, 6, BT4, G4, AT4};
+
+    // 1.2 --- Select Transform --- //
+
+        /*
+            Get the Transform matching an Output Tile size
+
+            OutTile - 2 or 4
+
+            Return Value - Transform
+        */
+
+        static const WinogradTransform* GetTransform(int OutTile)
+        {
+            return OutTile == 4 ? &F4x4 : &F2x2;
+        }
+
+    // 1.3 --- Tile Size --- //
+
+        /*
+            Pick the Output Tile size for a Layer. F(4x4, 3x3) saves the most work,
+            but wastes most of its Tiles on small Outputs
+
+            OutHeight - Output Height
+            OutWidth - Output Width
+
+            Return Value - 2 or 4
+        */
+
+        int WinogradTile(int OutHeight, int OutWidth)
+        {
+            if(OutHeight >= WinogradF4MinSize && OutWidth >= WinogradF4MinSize)
+            {
+                return 4;
+            }
+
+            return 2;
+        }
+
+// 2 --- Filter Transform --- //
+
+    // 2.1 --- Rotate Filters --- //
+
+        /*
+            Rotate every Kernel by 180 degrees and swap Kernels with Channels.
+            The Input Gradient of a Conv Layer is the Convolution of Delta with these Filters
+
+            Filters - Weights {NKernels, Channels, KernelSize, KernelSize}
+            Rotated - Where to place the Result {Channels, NKernels, KernelSize, KernelSize}
+
+            Return Value - Nothing
+        */
+
+        void RotateFilters(Tensor* Filters, Tensor* Rotated)
+        {
+            int KernelSize = Filters->Dims[2];
+
+            for(int kernel = 0; kernel < Filters->Dims[0]; ++kernel)
+            {
+                for(int channel = 0; channel < Filters->Dims[1]; ++channel)
+                {
+                    for(int y = 0; y < KernelSize; ++y)
+                    {
+                        for(int x = 0; x < KernelSize; ++x)
+                        {
+                            TensorAt(Rotated, channel, kernel, KernelSize - 1 - y, KernelSize - 1 - x) = TensorAt(Filters, kernel, channel, y, x);
+                        }
+                    }
+                }
+            }
+        }
+
+    // 2.2 --- Transform Filters --- //
+
+        /*
+            Calculate G g GT for every 3x3 Filter.
+            Transformed is (re)allocated when it does not match the Filters.
+
+            Filters - Weights {NKernels, Channels, 3, 3}
+            Transformed - Where to place the Result {InTile^2, 1, NKernels, Channels}
+            OutTile - Output Tile size (2 or 4)
+
+            Return Value - Nothing. Transformed->Data is NULL if it could not be allocated
+        */
+
+        void WinogradFilters(Tensor* Filters, Tensor* Transformed, int OutTile)
+        {
+            const WinogradTransform* W = GetTransform(OutTile);
+            int T = W->InTile;
+
+            int NKernels = Filters->Dims[0];
+            int Channels = Filters->Dims[1];
+
+            // --- Allocate --- //
+
+                if(Transformed->Data == NULL || Transformed->Dims[0] != T * T || Transformed->Dims[2] != NKernels || Transformed->Dims[3] != Channels)
+                {
+                    FreeTensor(Transformed);
+
+                    int Dims[3] = {1, NKernels, Channels};
+                    *Transformed = InitTensor(T * T, Dims);
+
+                    if(Transformed->Data == NULL)
+                    {
+                        return;
+                    }
+                }
+
+            // --- Transform --- //
+
+                for(int kernel = 0; kernel < NKernels; ++kernel)
+                {
+                    for(int channel = 0; channel < Channels; ++channel)
+                    {
+                        double Temp[6][3];
+
+                        // Temp = G g
+                        for(int i = 0; i < T; ++i)
+                        {
+                            for(int j = 0; j < 3; ++j)
+                            {
+                                Temp[i][j] = 0;
+
+                                for(int k = 0; k < 3; ++k)
+                                {
+                                    Temp[i][j] += W->G[i * 3 + k] * TensorAt(Filters, kernel, channel, k, j);
+                                }
+                            }
+                        }
+
+                        // U = Temp GT. Position (i, j) goes to Matrix i * T + j
+                        for(int i = 0; i < T; ++i)
+                        {
+                            for(int j = 0; j < T; ++j)
+                            {
+                                double Value = 0;
+
+                                for(int k = 0; k < 3; ++k)
+                                {
+                                    Value += Temp[i][k] * W->G[j * 3 + k];
+                                }
+
+                                TensorAt(Transformed, i * T + j, 0, kernel, channel) = Value;
+                            }
+                        }
+                    }
+                }
+        }
+
+// 3 --- Convolution --- //
+
+    // 3.1 --- Input Transform --- //
+
+        /*
+            Calculate BT d B for every Channel of a group of Tiles
+
+            W - Transform
+            Input - Input Volumes
+            Sample - Volume to Transform
+            Padding - Padding
+            TilesX - Tiles per Output Row
+            FirstTile - First Tile of the group
+            NTiles - Tiles in the group
+            V - Where to place the Result {InTile^2, Channels, NTiles}
+
+            Return Value - Nothing
+        */
+
+        static void InputTransform(const WinogradTransform* W, Tensor* Input, int Sample, int Padding,
+                                   int TilesX, int FirstTile, int NTiles, double* V)
+        {
+            int T = W->InTile;
+            int Channels = Input->Dims[1];
+
+            for(int channel = 0; channel < Channels; ++channel)
+            {
+                for(int tile = 0; tile < NTiles; ++tile)
+                {
+                    int y0 = ((FirstTile + tile) / TilesX) * W->OutTile - Padding;
+                    int x0 = ((FirstTile + tile) % TilesX) * W->OutTile - Padding;
+
+                    double d[6][6];
+                    double Temp[6][6];
+
+                    // --- Gather Tile. Pixels outside the Input are Padding --- //
+
+                        for(int i = 0; i < T; ++i)
+                        {
+                            int y = y0 + i;
+
+                            if(y < 0 || y >= Input->Dims[2])
+                            {
+                                for(int j = 0; j < T; ++j)
+                                {
+                                    d[i][j] = 0;
+                                }
+                                continue;
+                            }
+
+                            double* Row = TensorRow(Input, Sample, channel, y);
+
+                            for(int j = 0; j < T; ++j)
+                            {
+                                int x = x0 + j;
+                                d[i][j] = (x < 0 || x >= Input->Dims[3]) ? 0 : Row[x];
+                            }
+                        }
+
+                    // --- Temp = BT d --- //
+
+                        for(int i = 0; i < T; ++i)
+                        {
+                            for(int j = 0; j < T; ++j)
+                            {
+                                double Value = 0;
+
+                                for(int k = 0; k < T; ++k)
+                                {
+                                    Value += W->BT[i * T + k] * d[k][j];
+                                }
+
+                                Temp[i][j] = Value;
+                            }
+                        }
+
+                    // --- V = Temp B --- //
+
+                        for(int i = 0; i < T; ++i)
+                        {
+                            for(int j = 0; j < T; ++j)
+                            {
+                                double Value = 0;
+
+                                for(int k = 0; k < T; ++k)
+                                {
+                                    Value += Temp[i][k] * W->BT[j * T + k];
+                                }
+
+                                V[((i * T + j) * Channels + channel) * NTiles + tile] = Value;
+                            }
+                        }
+                }
+            }
+        }
+
+    // 3.2 --- Output Transform --- //
+
+        /*
+            Calculate AT M A for every Kernel of a group of Tiles and place the valid part in Output
+
+            W - Transform
+            M - Products {InTile^2, NKernels, NTiles}
+            Output - Output Volumes
+            Sample - Volume to write
+            TilesX - Tiles per Output Row
+            FirstTile - First Tile of the group
+            NTiles - Tiles in the group
+
+            Return Value - Nothing
+        */
+
+        static void OutputTransform(const WinogradTransform* W, double* M, Tensor* Output, int Sample,
+                                    int TilesX, int FirstTile, int NTiles)
+        {
+            int T = W->InTile;
+            int m = W->OutTile;
+            int NKernels = Output->Dims[1];
+
+            for(int kernel = 0; kernel < NKernels; ++kernel)
+            {
+                for(int tile = 0; tile < NTiles; ++tile)
+                {
+                    int y0 = ((FirstTile + tile) / TilesX) * m;
+                    int x0 = ((FirstTile + tile) % TilesX) * m;
+
+                    double Temp[4][6];
+
+                    // --- Temp = AT M --- //
+
+                        for(int i = 0; i < m; ++i)
+                        {
+                            for(int j = 0; j < T; ++j)
+                            {
+                                double Value = 0;
+
+                                for(int k = 0; k < T; ++k)
+                                {
+                                    Value += W->AT[i * T + k] * M[((k * T + j) * NKernels + kernel) * NTiles + tile];
+                                }
+
+                                Temp[i][j] = Value;
+                            }
+                        }
+
+                    // --- Y = Temp A. Tiles on the last Row / Column can stick out of the Output --- //
+
+                        for(int i = 0; i < m && y0 + i < Output->Dims[2]; ++i)
+                        {
+                            double* Out = TensorRow(Output, Sample, kernel, y0 + i);
+
+                            for(int j = 0; j < m && x0 + j < Output->Dims[3]; ++j)
+                            {
+                                double Value = 0;
+
+                                for(int k = 0; k < T; ++k)
+                                {
+                                    Value += Temp[i][k] * W->AT[j * T + k];
+                                }
+
+                                Out[x0 + j] = Value;
+                            }
+                        }
+                }
+            }
+        }
+
+    // 3.3 --- Convolution --- //
+
+        // Arguments of WinogradTask
+        typedef struct
+        {
+            const WinogradTransform* W;
+            Tensor* Input;
+            Tensor* Output;
+            Tensor* Transformed;
+            int Padding;
+
+            int TilesX;                 // Tiles per Output Row
+            int TotalTiles;             // Tiles per Sample
+            int GroupSize;              // Tiles per Group
+            int Groups;                 // Groups per Sample
+
+            int Status;                 // MemoryError if a Workspace could not be allocated
+
+        } WinogradArgs;
+
+        // Convolve Groups [Start, End). Group i holds Tiles of Sample i / Groups. Each call has its own Workspace
+        static void WinogradTask(void* Args, int Start, int End, int Thread)
+        {
+            (void) Thread;
+
+            WinogradArgs* Task = Args;
+            Tensor* Transformed = Task->Transformed;
+
+            int T2 = Transformed->Dims[0];
+            int NKernels = Transformed->Dims[2];
+            int Channels = Transformed->Dims[3];
+
+            // --- Workspace --- //
+
+                int VDims[3] = {1, T2 * Channels, Task->GroupSize};
+                int MDims[3] = {1, T2 * NKernels, Task->GroupSize};
+
+                // Every Value is written before it is read, so the Scratch Arena of this Thread is used as is
+                Arena* Space = ScratchArena();
+                size_t Mark = Space->Used;
+
+                Tensor V = ArenaTensor(Space, 1, VDims);
+                Tensor M = ArenaTensor(Space, 1, MDims);
+
+                if(V.Data == NULL || M.Data == NULL)
+                {
+                    FreeTensor(&M);
+                    FreeTensor(&V);
+                    ReleaseArena(Space, Mark);
+                    Task->Status = MemoryError;
+                    return;
+                }
+
+            // --- Convolution --- //
+
+                for(int Group = Start; Group < End; ++Group)
+                {
+                    int sample = Group / Task->Groups;
+                    int FirstTile = (Group % Task->Groups) * Task->GroupSize;
+                    int NTiles = Task->TotalTiles - FirstTile < Task->GroupSize ? Task->TotalTiles - FirstTile : Task->GroupSize;
+
+                    InputTransform(Task->W, Task->Input, sample, Task->Padding, Task->TilesX, FirstTile, NTiles, V.Data);
+
+                    // One Matrix Product per Tile position
+                    for(int xi = 0; xi < T2; ++xi)
+                    {
+                        Gemm(NoTrans, NoTrans, NKernels, NTiles, Channels,
+                             1, TensorRow(Transformed, xi, 0, 0), Channels,
+                             V.Data + xi * Channels * NTiles, NTiles,
+                             0, M.Data + xi * NKernels * NTiles, NTiles);
+                    }
+
+                    OutputTransform(Task->W, M.Data, Task->Output, sample, Task->TilesX, FirstTile, NTiles);
+                }
+
+            // --- Free --- //
+
+                FreeTensor(&M);
+                FreeTensor(&V);
+                ReleaseArena(Space, Mark);
+        }
+
+        /*
+            Calculate a 3x3, Stride 1 Convolution with Winograd Transformed Filters. No Activation is applied.
+
+            Tiles are processed in groups sized so the transformed Input and the Products fit in WinogradWorkspace doubles.
+            With Threads, Groups are made small enough for every Thread to get one. Each Tile is computed the same way
+            whatever Group it is in, so results don't depend on the Thread count.
+
+            Input - Input Volumes
+            Output - Where to place Output
+            Transformed - Filters from WinogradFilters {InTile^2, 1, NKernels, Channels}
+            Padding - Padding. May be negative, in which case Input borders are skipped
+            Workers - Threads to split Groups among. Can be NULL
+
+            Return Value - 0 on Success, MemoryError if the Workspace could not be allocated
+        */
+
+        int WinogradConv(Tensor* Input, Tensor* Output, Tensor* Transformed, int Padding, ThreadPool* Workers)
+        {
+            int T2 = Transformed->Dims[0];
+            const WinogradTransform* W = GetTransform(T2 == 36 ? 4 : 2);
+
+            int NKernels = Transformed->Dims[2];
+            int Channels = Transformed->Dims[3];
+
+            int TilesY = (Output->Dims[2] + W->OutTile - 1) / W->OutTile;
+            int TilesX = (Output->Dims[3] + W->OutTile - 1) / W->OutTile;
+            int TotalTiles = TilesY * TilesX;
+
+            // --- Groups --- //
+
+                int GroupSize = WinogradWorkspace / (T2 * (Channels + NKernels));
+
+                // Enough Groups per Sample for every Thread
+                int SplitsPerSample = (PoolThreads(Workers) + Input->Dims[0] - 1) / Input->Dims[0];
+                int ThreadShare = (TotalTiles + SplitsPerSample - 1) / SplitsPerSample;
+
+                if(GroupSize > ThreadShare)
+                {
+                    GroupSize = ThreadShare + GemmNR - 1;
+                }
+
+                GroupSize -= GroupSize % GemmNR;
+
+                if(GroupSize < GemmNR)
+                {
+                    GroupSize = GemmNR;
+                }
+                if(GroupSize > TotalTiles)
+                {
+                    GroupSize = TotalTiles;
+                }
+
+                WinogradArgs Args = {W, Input, Output, Transformed, Padding, TilesX, TotalTiles, GroupSize, (TotalTiles + GroupSize - 1) / GroupSize, 0};
+
+            // --- Convolution --- //
+
+                ParallelFor(Workers, Input->Dims[0] * Args.Groups, WinogradTask, &Args);
+
+            return Args.Status;
+        }
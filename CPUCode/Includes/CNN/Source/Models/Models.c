@@ -13,6 +13,11 @@
 			2.3.2 - LearningRate
 			2.3.3 - Momentum
 			2.3.4 - Error Func
+			2.3.5 - Threads
+			2.3.6 - Hogwild
+			2.3.7 - Freeze
+			2.3.8 - Feature Cache
+			2.3.9 - Loaders
 		2.4 - AddBlock
 		2.5 - AddLayers
 			2.5.1 - Conv
@@ -64,6 +69,21 @@
 				Net->Momentum = DefMomentum;
 				Net->EFunc = DefEFunc;
 
+				// Single Threaded until SetNumThreads is called
+				Net->Workers = NULL;
+				Net->Hogwild = 0;
+				Net->Loaders = DefLoaders;
+
+				// Planned once the Network is built
+				Net->Scratch = 0;
+				memset(&(Net->Plan), 0, sizeof(MemoryPlan));
+				Net->StopBlock = 0;
+				Net->StopLayer = -1;
+
+				// Kept in memory until SetFeatureCache is called
+				Net->CacheFeatures = DefCacheFeatures;
+				Net->FeaturePath = NULL;
+
 			// --- Init first Block --- //
 
 				Net->TotalBlocks = -1;
@@ -115,38 +135,12 @@
 
 					for(int j = 0; j < Net->Blocks[i].BlockSize; ++j)
 					{
-						if(Net->Blocks[i].Layers[j] == Conv)
-						{
-							for(int k = 0; k < Net->Blocks[i].LayerParams[j][1]; ++k)
-							{
-								Free3D(Net->Blocks[i].Weights[j][k]);
-							}
-							free(Net->Blocks[i].Weights[j]);
-
-							Free1D(Net->Blocks[i].LayerParams[j]);
-						}
-						else if(Net->Blocks[i].Layers[j] == Pool)
-						{
-							Free3D(Net->Blocks[i].Weights[j][0]);
-							free(Net->Blocks[i].Weights[j]);
-
-							Free1D(Net->Blocks[i].LayerParams[j]);
-						}
-						else if(Net->Blocks[i].Layers[j] == Fcon)
-						{
-							int InputSize = Net->Blocks[i].Dims[j][0] * Net->Blocks[i].Dims[j][1] * Net->Blocks[i].Dims[j][2];
-							for(int k = 0; k < InputSize; ++k)
-							{
-								Free1D(Net->Blocks[i].Weights[j][0][0][k]);
-							}
-							free(Net->Blocks[i].Weights[j][0][0]);
-							free(Net->Blocks[i].Weights[j][0]);
-							free(Net->Blocks[i].Weights[j]);
-
-							Free1D(Net->Blocks[i].LayerParams[j]);
-						}
+						FreeTensor(&(Net->Blocks[i].Weights[j]));
+						FreeConvCache(&(Net->Blocks[i].Caches[j]));
+						Free1D(Net->Blocks[i].LayerParams[j]);
 					}
 					free(Net->Blocks[i].Weights);
+					free(Net->Blocks[i].Caches);
 
 				// --- Free Dims --- //
 
@@ -168,6 +162,20 @@
 			// --- Free Blocks --- //
 
 				free(Net->Blocks);
+
+			// --- Free Memory Plan --- //
+
+				FreeMemoryPlan(&(Net->Plan));
+
+			// --- Free Workers --- //
+
+				FreeThreadPool(Net->Workers);
+				Net->Workers = NULL;
+
+			// --- Free Feature Cache Path --- //
+
+				free(Net->FeaturePath);
+				Net->FeaturePath = NULL;
 		}
 
 	// 2.3 --- Edit Parameters --- //
@@ -236,6 +244,140 @@
 				Net->EFunc = Func;
 			}
 
+		// 2.3.5 --- Threads --- //
+
+			/*
+				Set how many Threads the CPU uses. Layers split their work between them, and training splits every Batch between them.
+				Workers are started here and kept until FreeCNN or the next call. Forward Propagation results don't depend on the Thread count
+
+				Net - Network to consider
+				NThreads - Threads, including the calling one. 1 or less means single Threaded
+
+				return value - nothing
+			*/
+
+			void SetNumThreads(Network* Net, int NThreads)
+			{
+				if(PoolThreads(Net->Workers) == (NThreads < 1 ? 1 : NThreads))
+				{
+					return;
+				}
+
+				FreeThreadPool(Net->Workers);
+				Net->Workers = CreateThreadPool(NThreads);
+
+				if(NThreads > 1 && Net->Workers == NULL)
+				{
+					printf("Could not start %d Threads. Running single Threaded.\n", NThreads);
+				}
+
+				// New Workers start with empty Scratch Arenas
+				if(Net->Scratch > 0)
+				{
+					PlanWorkspace(Net);
+				}
+			}
+
+		// 2.3.6 --- Hogwild --- //
+
+			/*
+				Set whether multi Threaded training applies Fcon Gradients Hogwild style.
+				Each Thread then updates the shared Fcon Weights after every Chunk it backpropagates, without Locks or Reduction.
+				Faster for big Fcon Layers, but results are no longer repeatable
+
+				Net - Network to consider
+				Enable - 1 to enable, 0 for one reduced update per Batch
+
+				return value - nothing
+			*/
+
+			void SetHogwild(Network* Net, char Enable)
+			{
+				Net->Hogwild = Enable;
+			}
+
+		// 2.3.7 --- Freeze --- //
+
+			/*
+				Set whether Training changes the Weights of a Block, to fine tune only some Blocks of a Network.
+				Backpropagation stops at the first Layer with Weights to Train, so Frozen Blocks at the start of the Network are only Forwarded
+
+				Net - Network to consider. It has to be built, up to its Softmax Layer
+				Block - Index of the Block
+				Frozen - 1 to keep the Weights of the Block, 0 to Train them
+
+				return value - nothing
+			*/
+
+			void FreezeBlock(Network* Net, int Block, char Frozen)
+			{
+				if(Block < 0 || Block >= Net->TotalBlocks)
+				{
+					printf("Block %d can not be Frozen, the Network has %d Blocks.\n", Block, Net->TotalBlocks > 0 ? Net->TotalBlocks : 0);
+					exit(DesignError);
+				}
+
+				Net->Blocks[Block].Frozen = Frozen;
+
+				// Where Backpropagation stops depends on the Frozen Blocks
+				if(Net->Scratch > 0)
+				{
+					PlanWorkspace(Net);
+				}
+			}
+
+		// 2.3.8 --- Feature Cache --- //
+
+			/*
+				Set how Training handles the Frozen Blocks at the start of the Network.
+				With the Cache, their Output for every Training Sample is calculated once, without Dropout, when Training starts,
+				and every Batch only runs the Blocks after them
+
+				Net - Network to consider
+				Enable - 1 to Cache the Outputs, 0 to Forward every Block for every Sample
+				Path - File the Cache is mapped to, for DataSets whose Outputs don't fit in memory. NULL keeps it in memory.
+					   It is copied, so it can be freed once this returns
+
+				return value - nothing
+			*/
+
+			void SetFeatureCache(Network* Net, char Enable, char* Path)
+			{
+				Net->CacheFeatures = Enable;
+
+				free(Net->FeaturePath);
+				Net->FeaturePath = NULL;
+
+				if(Path != NULL)
+				{
+					Net->FeaturePath = strdup(Path);
+
+					if(Net->FeaturePath == NULL)
+					{
+						printf("Memory Allocation Error.\n");
+						exit(MemoryError);
+					}
+				}
+			}
+
+		// 2.3.9 --- Loaders --- //
+
+			/*
+				Set how many background Threads assemble Training Batches.
+				They gather, convert and one hot encode the Samples of up to PrefetchBatches Batches while the Training Threads work on earlier ones.
+				The Samples of each Batch don't depend on the amount of Loaders
+
+				Net - Network to consider
+				Loaders - Amount of Loader Threads. 0 gathers every Batch in the Training Threads
+
+				return value - nothing
+			*/
+
+			void SetLoaders(Network* Net, int Loaders)
+			{
+				Net->Loaders = Loaders > 0 ? Loaders : 0;
+			}
+
 	// 2.4 --- Add Block --- //
 
 		/*
@@ -299,11 +441,19 @@
 
 			// --- Set Weights --- //
 
-				Net->Blocks[Net->TotalBlocks].Weights = malloc(sizeof(double****));
+				Net->Blocks[Net->TotalBlocks].Weights = malloc(sizeof(Tensor));
+
+			// --- Set Caches --- //
+
+				Net->Blocks[Net->TotalBlocks].Caches = malloc(sizeof(ConvCache));
 
 			// --- Set LayerParams --- //
 
 				Net->Blocks[Net->TotalBlocks].LayerParams = malloc(sizeof(double*));
+
+			// --- Trained until FreezeBlock is called --- //
+
+				Net->Blocks[Net->TotalBlocks].Frozen = 0;
 		}
 
 	// 2.5 --- Add Layers --- //
@@ -428,32 +578,33 @@
 					WeightDims[1] = KernelSize;																												// Kernel Size
 					WeightDims[2] = KernelSize;																												// Kernel Size
 
-					CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights = realloc(CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights, (CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize + 1) * sizeof(double****));
+					CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights = realloc(CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights, (CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize + 1) * sizeof(Tensor));
 					if(CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights == NULL)
 					{
 						printf("Memory Allocation Error.\n");
 						exit(MemoryError);
 					}
 
-					CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize] = malloc( (CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize + 1) * (sizeof(double***) * NKernels) );
-					if(CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize] == NULL)
+					CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize] = InitTensor(NKernels, WeightDims);
+					if(CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize].Data == NULL)
 					{
 						printf("Memory Allocation Error.\n");
 						exit(MemoryError);
 					}
 
-					for(int i = 0; i < NKernels; ++i)		
-					{
-						CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize][i] = Init3D(WeightDims);
-						if(CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize][i] == NULL)
-						{
-							printf("Memory Allocation Error.\n");
-							exit(MemoryError);
-						}
+					RandomizeTensor(&(CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize]), -0.05, 0.05);
 
-						RandomizeArray3D(CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize][i], WeightDims, -0.05, 0.05);
+				// --- Init Cache --- //
+
+					CurrentNet->Blocks[CurrentNet->TotalBlocks].Caches = realloc(CurrentNet->Blocks[CurrentNet->TotalBlocks].Caches, (CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize + 1) * sizeof(ConvCache));
+					if(CurrentNet->Blocks[CurrentNet->TotalBlocks].Caches == NULL)
+					{
+						printf("Memory Allocation Error.\n");
+						exit(MemoryError);
 					}
-				
+
+					memset(&(CurrentNet->Blocks[CurrentNet->TotalBlocks].Caches[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize]), 0, sizeof(ConvCache));
+
 				// --- Count number of Layers in this block --- //
 
 					++(CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize);
@@ -543,10 +694,11 @@
 						printf("Stride has to be greater than or equal to 1\n");
 						exit(CNNConstructionError);
 					}
-					if(Stride != FilterSize)
+					// Windows may overlap, but not skip Pixels
+					if(Stride > FilterSize)
 					{
 						printf("Layer %d in Block %d has invalid Params.\n", CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize + 1, CurrentNet->TotalBlocks + 1);
-						printf("Stride has to equal FilterSize.\n");
+						printf("Stride can't be greater than FilterSize.\n");
 						exit(CNNConstructionError);
 					}
 
@@ -590,29 +742,36 @@
 					CurrentNet->Blocks[CurrentNet->TotalBlocks].LayerParams[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize][2] = Type;				// Type: 1 - Max Pooling, 2 - Mean Pooling
 					CurrentNet->Blocks[CurrentNet->TotalBlocks].LayerParams[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize][3] = Stride;				// How many pixels Pooling Block moves at a time
 			
-				// --- Init Mask --- //
+				// --- Init Mask. One Max Position per Output --- //
 
-					CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights = realloc(CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights, (CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize + 1) * sizeof(double****));
+					CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights = realloc(CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights, (CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize + 1) * sizeof(Tensor));
 					if(CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights == NULL)
 					{
 						printf("Memory Allocation Error.\n");
 						exit(MemoryError);
 					}
 
-					CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize] = malloc(sizeof(double***));
-					if(CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize] == NULL)
+					int MaskDims[3];
+					PoolMaskDims(CurrentNet->Blocks[CurrentNet->TotalBlocks].Dims[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize], CurrentNet->Blocks[CurrentNet->TotalBlocks].LayerParams[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize], MaskDims);
+
+					CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize] = InitTensor(1, MaskDims);
+					if(CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize].Data == NULL)
 					{
 						printf("Memory Allocation Error.\n");
 						exit(CNNConstructionError);
 					}
 
-					CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize][0] = Init3D(CurrentNet->Blocks[CurrentNet->TotalBlocks].Dims[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize]);
-					if(CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize][0] == NULL)
+				// --- Init Cache --- //
+
+					CurrentNet->Blocks[CurrentNet->TotalBlocks].Caches = realloc(CurrentNet->Blocks[CurrentNet->TotalBlocks].Caches, (CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize + 1) * sizeof(ConvCache));
+					if(CurrentNet->Blocks[CurrentNet->TotalBlocks].Caches == NULL)
 					{
 						printf("Memory Allocation Error.\n");
-						exit(CNNConstructionError);
+						exit(MemoryError);
 					}
 
+					memset(&(CurrentNet->Blocks[CurrentNet->TotalBlocks].Caches[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize]), 0, sizeof(ConvCache));			// Only Conv Layers use it, but every Layer has one so it is indexed like Weights
+
 				// --- Count number of Layers in this block --- //
 
 					++(CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize);
@@ -713,7 +872,7 @@
 
 				// --- Init Weights --- //
 
-					CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights = realloc(CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights, (CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize + 1) * sizeof(double****));
+					CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights = realloc(CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights, (CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize + 1) * sizeof(Tensor));
 					if(CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights == NULL)
 					{
 						printf("Memory Allocation Error.\n");
@@ -722,16 +881,31 @@
 
 					int InputSize = CurrentNet->Blocks[CurrentNet->TotalBlocks].Dims[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize][0] * CurrentNet->Blocks[CurrentNet->TotalBlocks].Dims[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize][1] * CurrentNet->Blocks[CurrentNet->TotalBlocks].Dims[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize][2];
 
-					CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize] = malloc(sizeof(double***));
-					CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize][0] = malloc(sizeof(double**));
-					CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize][0][0] = malloc(sizeof(double*) * InputSize);
+					int WeightDims[3];
+					WeightDims[0] = 1;
+					WeightDims[1] = OutputSize;																												// Rows - Output Neurons, so each Output reads contiguous Weights
+					WeightDims[2] = InputSize;																												// Columns - Input Neurons
 
-					for(int i = 0; i < InputSize; ++i)		
+					CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize] = InitTensor(1, WeightDims);
+					if(CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize].Data == NULL)
 					{
-						CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize][0][0][i] = Init1D(OutputSize);
-						RandomizeArray1D(CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize][0][0][i], OutputSize, -0.05, 0.05);		// Assign Random Values to Weights
+						printf("Memory Allocation Error.\n");
+						exit(MemoryError);
 					}
 
+					RandomizeTensor(&(CurrentNet->Blocks[CurrentNet->TotalBlocks].Weights[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize]), -0.05, 0.05);		// Assign Random Values to Weights
+
+				// --- Init Cache --- //
+
+					CurrentNet->Blocks[CurrentNet->TotalBlocks].Caches = realloc(CurrentNet->Blocks[CurrentNet->TotalBlocks].Caches, (CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize + 1) * sizeof(ConvCache));
+					if(CurrentNet->Blocks[CurrentNet->TotalBlocks].Caches == NULL)
+					{
+						printf("Memory Allocation Error.\n");
+						exit(MemoryError);
+					}
+
+					memset(&(CurrentNet->Blocks[CurrentNet->TotalBlocks].Caches[CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize]), 0, sizeof(ConvCache));			// Only Conv Layers use it, but every Layer has one so it is indexed like Weights
+
 				// --- Count number of Layers in this block --- //
 
 					++(CurrentNet->Blocks[CurrentNet->TotalBlocks].BlockSize);
@@ -810,6 +984,9 @@
 					if(Func == Soft)
 					{
 						CurrentNet->TotalBlocks++;
+
+						// Network is complete, so every Layer Output can be sized
+						PlanWorkspace(CurrentNet);
 					}
 			}
 
@@ -976,7 +1153,7 @@
 		printf("Total Blocks = %d, InputDims = %dx%dx%d\n\n", Net->TotalBlocks, Net->Blocks[0].Dims[0][0], Net->Blocks[0].Dims[0][1], Net->Blocks[0].Dims[0][1]);
 		for(int i = 0; i < Net->TotalBlocks; ++i)
 		{
-			printf("Block %d : Layer\t  Parameters\t\t  OutputSize\n",i + 1);
+			printf("Block %d : Layer\t  Parameters\t\t  OutputSize\t  Buffer\n",i + 1);
 			for(int j = 0; j < Net->Blocks[i].BlockSize; ++j)
 			{
 				printf("\t  ");
@@ -1063,15 +1240,49 @@
 				}
 				if(flag == 0)
 				{
-					printf("\t\t  %dx%dx%d\n", Net->Blocks[i].Dims[j+1][0], Net->Blocks[i].Dims[j+1][1], Net->Blocks[i].Dims[j+1][1]);
+					printf("\t\t  %dx%dx%d", Net->Blocks[i].Dims[j+1][0], Net->Blocks[i].Dims[j+1][1], Net->Blocks[i].Dims[j+1][1]);
 				}
 				else
 				{
-					printf("\t\t  1x%d\n", Net->Blocks[i].Dims[j+1][2]);
+					printf("\t\t  1x%d", Net->Blocks[i].Dims[j+1][2]);
 				}
+
+				// --- Buffer from the Memory Plan --- //
+
+					if(i >= Net->Plan.Blocks)
+					{
+						printf("\t  -\n");
+					}
+					else if(Net->Plan.Fused[i][j])
+					{
+						printf("\t  Fused\n");
+					}
+					else if(Net->Plan.Slots[i][j] < 0)
+					{
+						printf("\t  Output\n");
+					}
+					else
+					{
+						printf("\t  %d\n", Net->Plan.Slots[i][j]);
+					}
 			}
 			printf("\n");
 		}
+
+		// --- Memory Plan --- //
+
+			if(Net->Plan.Blocks > 0)
+			{
+				printf("Classification Memory Plan: %d Buffers, Activations applied in place\n", Net->Plan.Buffers);
+
+				for(int b = 0; b < Net->Plan.Buffers; ++b)
+				{
+					printf("\t  Buffer %d : %zu Doubles\n", b, Net->Plan.Sizes[b]);
+				}
+
+				printf("\t  Peak %zu Doubles per Sample, %zu without Buffer Reuse\n", Net->Plan.Peak, Net->Plan.Total);
+			}
+
 		printf("\n\nNetwork Architecture Finished!\n");
 	}
 
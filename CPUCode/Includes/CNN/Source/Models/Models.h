@@ -21,6 +21,11 @@
 		void SetBatchSize(Network* Net, int Bs);
 		void SetLearningRate(Network* Net, double Lr);
 		void SetMomentum(Network* Net, double Mom);
+		void SetNumThreads(Network* Net, int NThreads);
+		void SetHogwild(Network* Net, char Enable);
+		void FreezeBlock(Network* Net, int Block, char Frozen);
+		void SetFeatureCache(Network* Net, char Enable, char* Path);
+		void SetLoaders(Network* Net, int Loaders);
 		void SetBurstMult(Network* Net, int Block, int BM);
 
 		void CreateVGG16(Network* Net);
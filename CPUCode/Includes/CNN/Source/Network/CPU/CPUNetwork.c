@@ -14,15 +14,50 @@
 			1.2.2 - Backward
 				1.2.2.1 - Block Backward
 				1.2.2.2 - CNN Backward
-
-	2 - Network Performance
-		2.1 - Classify
-		2.2 - Accuracy
-			2.2.1 - Accuracy
-			2.2.2 - TestAccuracy
+			1.2.3 - Workspaces
+				1.2.3.1 - Init
+				1.2.3.2 - Free
+			1.2.4 - Update Weights
+		1.3 - Workspace Plan
+			1.3.1 - Memory Plan
+				1.3.1.1 - Fusion
+				1.3.1.2 - Plan
+				1.3.1.3 - Free
+			1.3.2 - Backward Plan
+			1.3.3 - Size
+			1.3.4 - Reserve
+
+	2 - Samples
+		2.1 - Source
+		2.2 - Input
+		2.3 - Label
+
+	3 - Network Performance
+		3.1 - Classify
+			3.1.1 - Best Class
+			3.1.2 - Classify
+			3.1.3 - Classify Batch
+		3.2 - Accuracy
+			3.2.1 - Accuracy
+			3.2.2 - TestAccuracy
 	
-	3 - Training
-		3.1 - Train
+	4 - Training
+		4.1 - Feature Cache
+			4.1.1 - Init
+			4.1.2 - Free
+		4.2 - Sampler
+			4.2.1 - Init
+			4.2.2 - Draw
+			4.2.3 - Free
+		4.3 - Prefetch
+			4.3.1 - Gather
+			4.3.2 - Wait
+			4.3.3 - Loader
+			4.3.4 - Request
+			4.3.5 - Start
+			4.3.6 - Stop
+		4.4 - Worker
+		4.5 - Train
 
 */
 
@@ -30,142 +65,161 @@
 
 	// 1.1 ---  Not Training --- //
 
-		// 1.1.2 --- Block Forward --- //
+		// 1.1.1 --- Block Forward --- //
 
 			/*
-				Calculate Output of a Block
+				Calculate Output of a Block. Each Layer Output goes to the Buffer the Memory Plan gave it
 
 				Block - Block
-				Inputs - Input to the Block
-				Flag1D - Flag to Signal Dimension Switches
-
-				return value - Output to be used as Input to next Block
+				Input - Input to the Block
+				Slots - Buffer of every Layer Output, from the Memory Plan
+				Fused - 1 for every Conv Layer computed together with the Pool Layer after it, from the Memory Plan
+				Buffers - Buffers of the Memory Plan, big enough for Input->Dims[0] Samples
+				Output - Where the Network Output goes, for the Layer with Slot -1
+				Workers - Threads used by the Layers. Can be NULL
+
+				return value - Output to be used as Input to next Block. A View into Buffers or Output
 			*/
 
-			static double*** BlockForwardCpu(Block Block, double*** Input, char* Flag1D)
+			static Tensor BlockForwardCpu(Block Block, Tensor* Input, int* Slots, char* Fused, Tensor* Buffers, Tensor* Output, ThreadPool* Workers)
 			{
 				// --- Setup for Computation --- //
 
-					double**** LayerOutputs = malloc(sizeof(double***) * (Block.BlockSize + 1));
+					Tensor LayerOutputs[Block.BlockSize + 1];
 
-					LayerOutputs[0] = Init3D(Block.Dims[0]);
-					Copy3D(Input, LayerOutputs[0], Block.Dims[0]);
+					// First Layer reads the Input directly
+					LayerOutputs[0] = *Input;
+					LayerOutputs[0].Owner = 0;
 
 				// --- Go Through each Layer in Block and Compute Output--- //
 
 					for(int Layer = 0; Layer < Block.BlockSize; ++Layer)
 					{
-						// --- Init Output Volume --- //
+						// --- A fused Conv is computed by the Pool Layer after it --- //
+
+							if(Fused[Layer])
+							{
+								memset(&(LayerOutputs[Layer + 1]), 0, sizeof(Tensor));
+								continue;
+							}
+
+						// --- Output Volume --- //
 
-							LayerOutputs[Layer + 1] = Init3D(Block.Dims[Layer + 1]);
+							if(Slots[Layer] < 0)
+							{
+								LayerOutputs[Layer + 1] = *Output;
+								LayerOutputs[Layer + 1].Owner = 0;
+							}
+							else
+							{
+								LayerOutputs[Layer + 1] = ViewTensor(Buffers[Slots[Layer]].Data, Input->Dims[0], Block.Dims[Layer + 1]);
+							}
 
 						// --- Calculate Layer Output --- //
 
 							switch(Block.Layers[Layer])
 							{
 								case Conv:		// Conv
-											ConvForwCpu(LayerOutputs[Layer], Block.Dims[Layer], 
-														LayerOutputs[Layer + 1],
-														Block.Weights[Layer], Block.LayerParams[Layer]);	
+											ConvForwCpu(&(LayerOutputs[Layer]),
+														&(LayerOutputs[Layer + 1]),
+														&(Block.Weights[Layer]), Block.LayerParams[Layer],
+														&(Block.Caches[Layer]),
+														Workers);
 											break;
 
 								case Pool:		// Pool
-											PoolForwCpu(LayerOutputs[Layer], Block.Dims[Layer],
-														Block.Weights[Layer][0],
-														LayerOutputs[Layer + 1], 
-														Block.LayerParams[Layer]);
-											break;
-
-								case Fcon:		// Fcon
-
-											// Convert Size if Necessary
-											if((*Flag1D) == 0)
+											if(Layer > 0 && Fused[Layer - 1])
 											{
-												int InDim = Block.Dims[Layer][0] * Block.Dims[Layer][1] * Block.Dims[Layer][2];
-
-												double* Aux = Init1D(InDim);
-												ConvertTo1D(LayerOutputs[Layer], Aux, Block.Dims[Layer]);
-
-												FconForwCpu(Aux, Block.Dims[Layer][0] * Block.Dims[Layer][1] * Block.Dims[Layer][2],
-																LayerOutputs[Layer + 1][0][0], Block.Dims[Layer + 1][2],
-																Block.Weights[Layer][0][0], Block.LayerParams[Layer],
-																0);
-
-												Free1D(Aux);
+												ConvPoolForwCpu(&(LayerOutputs[Layer - 1]),
+																&(LayerOutputs[Layer + 1]),
+																&(Block.Weights[Layer - 1]), Block.LayerParams[Layer - 1],
+																Block.LayerParams[Layer],
+																NULL,
+																&(Block.Caches[Layer - 1]),
+																Workers);
+												break;
+											}
 
-												*Flag1D = 1;
+											FitPoolMask(&(Block.Weights[Layer]), Input->Dims[0]);
+											PoolForwCpu(&(LayerOutputs[Layer]),
+														&(Block.Weights[Layer]),
+														&(LayerOutputs[Layer + 1]), 
+														Block.LayerParams[Layer],
+														Workers);
+											break;
 
-											}
-											else
-											{
-												FconForwCpu(LayerOutputs[Layer][0][0], Block.Dims[Layer][0] * Block.Dims[Layer][1] * Block.Dims[Layer][2],
-															LayerOutputs[Layer + 1][0][0], Block.Dims[Layer + 1][2], 
-															Block.Weights[Layer][0][0], Block.LayerParams[Layer], 
-															0);
-											}
-											
+								case Fcon:		// Fcon
+											FconForwCpu(&(LayerOutputs[Layer]),
+														&(LayerOutputs[Layer + 1]),
+														&(Block.Weights[Layer]), Block.LayerParams[Layer], 
+														0, Workers);
 											break;
 							}
-
-							Free3D(LayerOutputs[Layer]);
 					}
 
-
-					double*** Output = Init3D(Block.Dims[Block.BlockSize]);
-
-					Copy3D(LayerOutputs[Block.BlockSize], Output, Block.Dims[Block.BlockSize]);
-
-				// --- Free --- //
-
-					Free3D(LayerOutputs[Block.BlockSize]);
-					free(LayerOutputs);
-
-				return Output;
+				return LayerOutputs[Block.BlockSize];
 			}
 
 		// 1.1.2 --- CNN Forward --- //
 
 			/*
-				Calculate Network Output
+				Calculate Network Output, or the Output of its first Blocks. Layer Outputs share the Buffers of the Memory Plan,
+				taken from the Scratch Arena of the calling Thread, so nothing is allocated once the Arena is planned
 
 				Net - Network to be used
+				Blocks - Blocks to Forward. Net.TotalBlocks for the whole Network
 				Input - Input to the Network
+				Output - Where to place the Output of the last Block Forwarded. Same amount of Samples as Input
 
-				return value - Network Output
+				return value - Nothing
 			*/
 
-			static double* CNNForwardCpu(Network Net, double*** Input)
+			static void CNNForwardCpu(Network Net, int Blocks, Tensor* Input, Tensor* Output)
 			{
 				// --- Setup for Computation --- //
 
-					char* Flag1D = malloc(sizeof(char));
-					*Flag1D = 0;
+					Arena* Space = ScratchArena();
+					size_t Mark = Space->Used;
+
+					// One extra, so a Network without Buffers still has a valid Array
+					Tensor Buffers[Net.Plan.Buffers + 1];
+
+					for(int Buffer = 0; Buffer < Net.Plan.Buffers; ++Buffer)
+					{
+						int BufferDims[3] = {1, 1, Input->Dims[0] * Net.Plan.Sizes[Buffer]};
 
-					double**** BlockOutputs = malloc((Net.TotalBlocks + 1) * sizeof(double***));
+						Buffers[Buffer] = ArenaTensor(Space, 1, BufferDims);
+						if(Buffers[Buffer].Data == NULL)
+						{
+							printf("Memory Allocation Error.\n");
+							exit(MemoryError);
+						}
+					}
 
-					BlockOutputs[0] = Init3D(Net.Blocks[0].Dims[0]);
-					Copy3D(Input, BlockOutputs[0], Net.Blocks[0].Dims[0]);
+					Tensor BlockOutput = *Input;
+					BlockOutput.Owner = 0;
 
 				// --- Go Through all Blocks and place value in Output --- //
 
-					for(int Block = 0; Block < Net.TotalBlocks; ++Block)
+					for(int Block = 0; Block < Blocks; ++Block)
 					{
-						BlockOutputs[Block + 1] = BlockForwardCpu(Net.Blocks[Block], BlockOutputs[Block], Flag1D);
-
-						Free3D(BlockOutputs[Block]);
+						BlockOutput = BlockForwardCpu(Net.Blocks[Block], &BlockOutput, Net.Plan.Slots[Block], Net.Plan.Fused[Block], Buffers, Output, Net.Workers);
 					}
 
-					double* Output = Init1D(Net.Blocks[Net.TotalBlocks - 1].Dims[Net.Blocks[Net.TotalBlocks - 1].BlockSize][2]);
-					Copy1D(BlockOutputs[Net.TotalBlocks][0][0], Output, Net.Blocks[Net.TotalBlocks - 1].Dims[Net.Blocks[Net.TotalBlocks - 1].BlockSize][2]);
+					// Only the Network Output is written straight to Output
+					if(Blocks < Net.TotalBlocks)
+					{
+						memcpy(Output->Data, BlockOutput.Data, TensorSize(&BlockOutput) * sizeof(double));
+					}
 
 				// --- Free --- //
 
-					Free3D(BlockOutputs[Net.TotalBlocks]);
-					free(BlockOutputs);
-
-					free(Flag1D);
+					for(int Buffer = Net.Plan.Buffers - 1; Buffer >= 0; --Buffer)
+					{
+						FreeTensor(&(Buffers[Buffer]));
+					}
 
-				return Output;
+					ReleaseArena(Space, Mark);
 			}
 
 	// 1.2 --- Training --- //
@@ -175,63 +229,66 @@
 			// 1.2.1.1 --- Block Forward --- //
 
 				/*
-					Same as 1.1.1 (Block Forward), but Stores Output of every layer, to be used later in training
+					Same as 1.1.1 (Block Forward), but Stores Output of every layer, to be used later in training.
+					Layers run on the calling Thread, since Training splits the Batch between Threads instead
 
 					Block - Block to Forward
 					Input - Input to the Block
-					Flag1D - Flag to signal Dimensional Switches
 					LayerOutputs - Variable to store Layer Outputs
+					Masks - Pool Masks, indexed like Block.Weights
+					Caches - Transformed Filters of the Conv Layers, indexed like Block.Weights
+					Space - Arena Layer Outputs are taken from
 
 					return value - nothing
 				*/
 
-				static void BlockForwardCpuTrain(Block Block, double*** Input, char* Flag1D, double**** LayerOutputs)
+				static void BlockForwardCpuTrain(Block Block, Tensor* Input, Tensor* LayerOutputs, Tensor* Masks, ConvCache* Caches, Arena* Space)
 				{
-					LayerOutputs[0] = Init3D(Block.Dims[0]);
-					Copy3D(Input, LayerOutputs[0], Block.Dims[0]);
+					// Params of a Softmax Fcon Layer without its Activation
+					double LogitParams[2] = {0, 0};
+
+					// Input belongs to the previous Block, so only a View is kept
+					LayerOutputs[0] = *Input;
+					LayerOutputs[0].Owner = 0;
 
 					// --- Go Through Every Layer in the Block --- //
 
 						for(int Layer = 0; Layer < Block.BlockSize; ++Layer)
 						{
-							LayerOutputs[Layer + 1] = Init3D(Block.Dims[Layer + 1]);
+							LayerOutputs[Layer + 1] = ArenaTensor(Space, Input->Dims[0], Block.Dims[Layer + 1]);
+							if(LayerOutputs[Layer + 1].Data == NULL)
+							{
+								printf("Memory Allocation Error.\n");
+								exit(MemoryError);
+							}
+
 							switch(Block.Layers[Layer])
 							{
 								case Conv:		// Conv
-											ConvForwCpu(LayerOutputs[Layer], Block.Dims[Layer], 
-														LayerOutputs[Layer + 1],
-														Block.Weights[Layer], Block.LayerParams[Layer]);	
+											ConvForwCpu(&(LayerOutputs[Layer]),
+														&(LayerOutputs[Layer + 1]),
+														&(Block.Weights[Layer]), Block.LayerParams[Layer],
+														&(Caches[Layer]),
+														NULL);
 											break;
 
 								case Pool:		// Pool
-											PoolForwCpu(LayerOutputs[Layer], Block.Dims[Layer], 
-														Block.Weights[Layer][0],
-														LayerOutputs[Layer + 1], 
-														Block.LayerParams[Layer]);
+											FitPoolMask(&(Masks[Layer]), Input->Dims[0]);
+											PoolForwCpu(&(LayerOutputs[Layer]),
+														&(Masks[Layer]),
+														&(LayerOutputs[Layer + 1]), 
+														Block.LayerParams[Layer],
+														NULL);
 											break;
 
 								case Fcon:		// Fcon
+											// A Softmax Layer is always the last one. Its Logits are kept, and SoftmaxError applies the Softmax with the Error
+											LogitParams[1] = Block.LayerParams[Layer][1];
 
-											// Convert Size if Necessary
-											if((*Flag1D) == 0)
-											{
-												int InDim = Block.Dims[Layer][0] * Block.Dims[Layer][1] * Block.Dims[Layer][2];
-
-												double* Aux = Init1D(InDim);
-												ConvertTo1D(LayerOutputs[Layer], Aux, Block.Dims[Layer]);
-
-												FconForwCpu(Aux, Block.Dims[Layer][0] * Block.Dims[Layer][1] * Block.Dims[Layer][2],
-																LayerOutputs[Layer + 1][0][0], Block.Dims[Layer + 1][2],
-																Block.Weights[Layer][0][0], Block.LayerParams[Layer],
-																1);
-												Free1D(Aux);
-
-												*Flag1D = 1;
-											}
-											FconForwCpu(LayerOutputs[Layer][0][0], Block.Dims[Layer][0] * Block.Dims[Layer][1] * Block.Dims[Layer][2], 
-															LayerOutputs[Layer + 1][0][0], Block.Dims[Layer + 1][2], 
-															Block.Weights[Layer][0][0], Block.LayerParams[Layer], 
-															1);
+											FconForwCpu(&(LayerOutputs[Layer]),
+														&(LayerOutputs[Layer + 1]),
+														&(Block.Weights[Layer]), Block.LayerParams[Layer][0] == Soft ? LogitParams : Block.LayerParams[Layer], 
+														1, NULL);
 											break;
 							}
 						}
@@ -243,33 +300,27 @@
 					Same as 1.1.2 (CNN Forward), but Stores Output of every layer, to be used later in training
 
 					Net - Network to be used
-					Input - Input to the Network
-					BlockLayerOutputs - Variable to store Layer Outputs
+					First - First Block to Forward. The Blocks before it were Forwarded into the Feature Cache
+					Input - Input to Block First
+					BlockLayerOutputs - Variable to store Layer Outputs. [Block] holds BlockSize + 1 Tensors
+					Masks - Pool Masks of every Block
+					Caches - Conv Caches of every Block
+					Space - Arena Layer Outputs are taken from
 
 					return value - nothing
 				*/
 
-				static void CNNForwardCpuTrain(Network Net, double*** Input, double***** BlockLayerOutputs)
+				static void CNNForwardCpuTrain(Network Net, int First, Tensor* Input, Tensor** BlockLayerOutputs, Tensor** Masks, ConvCache** Caches, Arena* Space)
 				{
-					char* Flag1D = malloc(sizeof(char));
-					*Flag1D = 0;
-
-					BlockLayerOutputs[0] = malloc(sizeof(double***) * (Net.Blocks[0].BlockSize + 1));
-
 					// --- Go Through Every Block and Save Layer Outputs --- //
 
 						// First Block Outside so we don't have to constantly check for it in the Cycle
-						BlockForwardCpuTrain(Net.Blocks[0], Input, Flag1D, BlockLayerOutputs[0]);
+						BlockForwardCpuTrain(Net.Blocks[First], Input, BlockLayerOutputs[First], Masks[First], Caches[First], Space);
 
-						for(int Block = 1; Block < Net.TotalBlocks; ++Block)
+						for(int Block = First + 1; Block < Net.TotalBlocks; ++Block)
 						{
-							BlockLayerOutputs[Block] = malloc(sizeof(double***) * (Net.Blocks[Block].BlockSize + 1));
-							BlockForwardCpuTrain(Net.Blocks[Block], BlockLayerOutputs[Block - 1][Net.Blocks[Block - 1].BlockSize], Flag1D, BlockLayerOutputs[Block]);
+							BlockForwardCpuTrain(Net.Blocks[Block], &(BlockLayerOutputs[Block - 1][Net.Blocks[Block - 1].BlockSize]), BlockLayerOutputs[Block], Masks[Block], Caches[Block], Space);
 						}
-
-					// --- Free --- //
-
-						free(Flag1D);
 				}
 
 		// 1.2.2 --- Backward --- //
@@ -277,434 +328,1954 @@
 			// 1.2.2.1 --- Block Backward --- //
 
 				/*
-					Calculate Backpropagation of a Block
+					Calculate Backpropagation of a Block. Weight Gradients are added to Gradients, unless the Block is Frozen
 
 					Block - Block to Forward
 					BlockError - Input to the Block
 					LayerOutputs - LayerOutputs from Previous Forward Propagation
+					Masks - Pool Masks filled by the Forward Propagation, indexed like Block.Weights
+					Caches - Transformed Filters of the Conv Layers, indexed like Block.Weights
+					Gradients - Weight Gradients, indexed like Block.Weights
+					Stop - Layer Backpropagation stops at. Its Input Error is not calculated and the Layers before it are skipped. -1 for the whole Block
+					Space - Arena Layer Errors are taken from
 
-					return value - Error to Backpropagate onto Next Block
+					return value - Error to Backpropagate onto Next Block. Empty if Backpropagation stopped in this Block
 				*/
 
-				static double*** BlockBackwardCpu(Block Block, double*** BlockError, double**** LayerOutputs, double LearningRate)
+				static Tensor BlockBackwardCpu(Block Block, Tensor* BlockError, Tensor* LayerOutputs, Tensor* Masks, ConvCache* Caches, Tensor* Gradients, int Stop, Arena* Space)
 				{
-					double**** Error = malloc(sizeof(double***) * (Block.BlockSize + 1));
-					Error[Block.BlockSize] = Init3D(Block.Dims[Block.BlockSize]);
+					Tensor Error[Block.BlockSize + 1];
 
-					Copy3D(BlockError, Error[Block.BlockSize], Block.Dims[Block.BlockSize]);
+					// Error from the next Block is only read
+					Error[Block.BlockSize] = *BlockError;
+					Error[Block.BlockSize].Owner = 0;
 
 					// 1 --- Go Through Every Layer in the Block, in Backwards Order --- //
 
-						for(int Layer = Block.BlockSize - 1; Layer >= 0; --Layer)
+						for(int Layer = Block.BlockSize - 1; Layer >= 0 && Layer >= Stop; --Layer)
 						{
-							Error[Layer] = Init3D(Block.Dims[Layer]);
+							// Input Error of the Layer Backpropagation stops at is never read
+							Error[Layer] = ViewTensor(NULL, BlockError->Dims[0], Block.Dims[Layer]);
+							Tensor* LayerError = NULL;
+
+							// Frozen Layers only pass the Error on
+							Tensor* LayerGradients = Block.Frozen ? NULL : &(Gradients[Layer]);
+
+							if(Layer != Stop)
+							{
+								Error[Layer] = ArenaTensor(Space, BlockError->Dims[0], Block.Dims[Layer]);
+								if(Error[Layer].Data == NULL)
+								{
+									printf("Memory Allocation Error.\n");
+									exit(MemoryError);
+								}
+
+								LayerError = &(Error[Layer]);
+							}
 
 							switch(Block.Layers[Layer])
 							{
 								case Conv:
-											ConvBackCpu(LayerOutputs[Layer], Block.Dims[Layer],
-				                 						LayerOutputs[Layer + 1], Block.Dims[Layer + 1], Error[Layer + 1],
-				                						Error[Layer],
-				                						Block.Weights[Layer], Block.LayerParams[Layer], 
-				                						LearningRate);
+											ConvBackCpu(&(LayerOutputs[Layer]),
+				                 						&(LayerOutputs[Layer + 1]), &(Error[Layer + 1]),
+				                						LayerError,
+				                						&(Block.Weights[Layer]), Block.LayerParams[Layer], 
+				                						&(Caches[Layer]),
+				                						LayerGradients);
 				                 			break;
 
 								case Pool:
-											PoolBackCpu(LayerOutputs[Layer + 1], Block.Dims[Layer + 1], Error[Layer + 1],
-										                 Block.Weights[Layer][0],
-										                 Error[Layer],
-										                 Block.LayerParams[Layer]);
+											PoolBackCpu(&(LayerOutputs[Layer + 1]), &(Error[Layer + 1]),
+										                &(Masks[Layer]),
+										                LayerError,
+										                Block.LayerParams[Layer]);
 											break;
 
 								case Fcon:
-											
-											// Switch Dims if Necessary
-											if(Block.Dims[Layer][0] != 1)
-											{
-												int InDim = Block.Dims[Layer][0] * Block.Dims[Layer][1] * Block.Dims[Layer][2];
-												int InDims[3] = {1, 1, InDim};
-
-												double* OutputErrorAux = Init1D(InDims[2]);
-
-												double* PrevInputAux = Init1D(InDims[2]);
-												ConvertTo1D(LayerOutputs[Layer], PrevInputAux, Block.Dims[Layer]);
-
-												FconBackCpu(PrevInputAux, InDims[2],
-															LayerOutputs[Layer + 1][0][0], Block.Dims[Layer + 1][2], Error[Layer + 1][0][0],
-															OutputErrorAux,
-															Block.Weights[Layer][0][0], Block.LayerParams[Layer], 
-															LearningRate);
-
-												ConvertTo3D(OutputErrorAux, Error[Layer], Block.Dims[Layer]);
-
-												Free1D(OutputErrorAux);
-												Free1D(PrevInputAux);
-											}
-											else
-											{
-												FconBackCpu(LayerOutputs[Layer][0][0], Block.Dims[Layer][2],
-															LayerOutputs[Layer + 1][0][0], Block.Dims[Layer + 1][2], Error[Layer + 1][0][0],
-															Error[Layer][0][0],
-															Block.Weights[Layer][0][0], Block.LayerParams[Layer], 
-															LearningRate);
-											}
+											FconBackCpu(&(LayerOutputs[Layer]),
+														&(LayerOutputs[Layer + 1]), &(Error[Layer + 1]),
+														LayerError,
+														&(Block.Weights[Layer]), Block.LayerParams[Layer], 
+														LayerGradients);
 											break;
 							}
 
 							// Do some Freeing Here so we don't have to cycle again
-							Free3D(Error[Layer + 1]);
+							FreeTensor(&(Error[Layer + 1]));
 						}
 
-					double*** Output = Init3D(Block.Dims[0]);
-
-					Copy3D(Error[0], Output, Block.Dims[0]);
-
-					// --- Free --- //
-
-						Free3D(Error[0]);
-						free(Error);
-
-					return Output;
+					return Error[Stop > 0 ? Stop : 0];
 				}
 
 			// 1.2.2.2 --- CNN Backward --- //
 
 				/*
-					Backpropagate Network on given Input
+					Backpropagate Network from the Layer Outputs of a previous CNNForwardCpuTrain, down to the Stop of the Backward Plan.
+					Weight Gradients are added to Gradients, Weights are not changed.
 					
-					Input - Input to Backpropagate on
-					Label - Label for Input
+					Net - Network to be used
+					First - First Block CNNForwardCpuTrain Forwarded
+					BlockLayerOutputs - Layer Outputs from CNNForwardCpuTrain. Freed here
+					Error - Error Derivative with respect to the Network Output
+					Masks - Pool Masks of every Block, filled by CNNForwardCpuTrain
+					Caches - Conv Caches of every Block
+					Gradients - Weight Gradients of every Block
+					Space - Arena Layer Errors are taken from
 
 					return value - Nothing
 				*/
 
-				static void CNNBackwardCpu(Network Net, double*** Input, double* Label)
+				static void CNNBackwardCpu(Network Net, int First, Tensor** BlockLayerOutputs, Tensor* Error, Tensor** Masks, ConvCache** Caches, Tensor** Gradients, Arena* Space)
 				{
-					// --- Run Forward Propagation and get All Needed Data --- //
-
-						// Store Layer Outputs
-						double***** BlockLayerOutputs = malloc(sizeof(double****) * Net.TotalBlocks);
-
-						// Forward Prop
-						CNNForwardCpuTrain(Net, Input, BlockLayerOutputs);
-						
-						// Get Error
-						double* Error;
-						Error = ErrorBackward(BlockLayerOutputs[Net.TotalBlocks - 1][Net.Blocks[Net.TotalBlocks - 1].BlockSize][0][0], Label, Net.Blocks[Net.TotalBlocks - 1].Dims[Net.Blocks[Net.TotalBlocks - 1].BlockSize][2], Net.EFunc);
+					// --- Setup for Computation --- //
 
 						// Store Layer Errors
-						double**** BlockErrors = malloc((Net.TotalBlocks + 1) * sizeof(double***));
+						Tensor BlockErrors[Net.TotalBlocks + 1];
 
 						// Init Layer Errors so we don't have to check for it in the cycle
-						BlockErrors[Net.TotalBlocks] = Init3D(Net.Blocks[Net.TotalBlocks - 1].Dims[Net.Blocks[Net.TotalBlocks - 1].BlockSize]);
-						Copy1D(Error, BlockErrors[Net.TotalBlocks][0][0], Net.Blocks[Net.TotalBlocks - 1].Dims[Net.Blocks[Net.TotalBlocks - 1].BlockSize][2]);
+						BlockErrors[Net.TotalBlocks] = *Error;
+						BlockErrors[Net.TotalBlocks].Owner = 0;
 
-					// --- Go Through All Blocks --- //
+					// --- Go Through the Blocks down to where Backpropagation stops --- //
 
-						for(int Block = Net.TotalBlocks - 1; Block >= 0; --Block)
+						for(int Block = Net.TotalBlocks - 1; Block >= Net.StopBlock; --Block)
 						{
-							BlockErrors[Block] = BlockBackwardCpu(Net.Blocks[Block], BlockErrors[Block + 1], BlockLayerOutputs[Block], Net.LearningRate);
+							int Stop = Block == Net.StopBlock ? Net.StopLayer : -1;
+
+							BlockErrors[Block] = BlockBackwardCpu(Net.Blocks[Block], &(BlockErrors[Block + 1]), BlockLayerOutputs[Block], Masks[Block], Caches[Block], Gradients[Block], Stop, Space);
 
 							// Do some Freeing Here so we don't have to cycle again
-							Free3D(BlockErrors[Block + 1]);
+							FreeTensor(&(BlockErrors[Block + 1]));
+						}
+
+					// --- Free --- //
+
+						FreeTensor(&(BlockErrors[Net.StopBlock]));
 
+						for(int Block = Net.TotalBlocks - 1; Block >= First; --Block)
+						{
 							for(int Layer = 0; Layer < Net.Blocks[Block].BlockSize + 1; ++Layer)
 							{
-								Free3D(BlockLayerOutputs[Block][Layer]);
+								FreeTensor(&(BlockLayerOutputs[Block][Layer]));
 							}
-							free(BlockLayerOutputs[Block]);
 						}
+				}
 
-					// --- Free --- //
+		// 1.2.3 --- Workspaces --- //
 
-						Free1D(Error);
-						free(BlockLayerOutputs);
+			// Everything a Training Thread writes to. Worker 0 uses the Pool Masks and Conv Caches of the Network itself.
+			// Gradients only exist while training, so Networks used for Classification never hold them
+			typedef struct
+			{
+				Tensor Input;					// Chunk of Samples, or of their Cached Features. TrainChunk Volumes
+				Tensor Truth;					// One hot Labels of the Chunk. TrainChunk Labels
+				Tensor** BlockLayerOutputs;		// [Block][Layer] Layer Outputs of the Chunk, kept from the Forward for the Backprop. Taken from the Scratch Arena
 
-						Free3D(BlockErrors[0]);
-						free(BlockErrors);
-				}
+				Tensor** Masks;					// [Block][Layer] Pool Masks, indexed like Block.Weights
+				ConvCache** Caches;				// [Block][Layer] Transformed Filters, indexed like Block.Weights. Every Thread transforms its own
+				Tensor** Gradients;				// [Block][Layer] Weight Gradients, indexed like Block.Weights. Empty for Pool Layers and Frozen Blocks
 
-// 2 --- Network Performance --- //
+				double Error;					// Error summed over the Samples of this Worker
+				double Accuracy;				// Correct Predictions of this Worker
 
-	// 2.1 --- Classify --- //
+			} TrainWorkspace;
 
-		/*
-			Get CNN Classification of a given Input
+			// 1.2.3.1 --- Init --- //
 
-			Input - Input to Classify
-			Network - Network to be used for Classification
+				/*
+					Create the Workspace of a Training Thread
 
-			return value - Class Input belongs to.
-		*/
+					Net - Network to be trained
+					Worker - Index of the Thread. Worker 0 shares the Network Masks and Conv Caches
+					First - First Block Training Forwards
 
-		int Classify(Network Net, double*** Input)
-		{
-			// --- Forward Input Through Network --- //
+					return value - Workspace
+				*/
 
-				double* Prediction = CNNForwardCpu(Net, Input);
+				static TrainWorkspace InitWorkspace(Network Net, int Worker, int First)
+				{
+					TrainWorkspace Space;
 
-			// --- Find Highest Value and save Index --- //
+					Space.Input = InitTensor(TrainChunk, Net.Blocks[First].Dims[0]);
+					Space.Truth = InitTensor(TrainChunk, Net.Blocks[Net.TotalBlocks - 1].Dims[Net.Blocks[Net.TotalBlocks - 1].BlockSize]);
+					Space.BlockLayerOutputs = calloc(Net.TotalBlocks, sizeof(Tensor*));
 
-				double MaxPrediction = Prediction[0];
-				int MaxPredictionIndex = 0;
+					Space.Masks = malloc(sizeof(Tensor*) * Net.TotalBlocks);
+					Space.Caches = malloc(sizeof(ConvCache*) * Net.TotalBlocks);
+					Space.Gradients = malloc(sizeof(Tensor*) * Net.TotalBlocks);
 
-				for(int i = 1; i < Net.Blocks[Net.TotalBlocks - 1].Dims[Net.Blocks[Net.TotalBlocks - 1].BlockSize][2]; ++i)
-				{
-					if(Prediction[i] > MaxPrediction)
+					if(Space.Input.Data == NULL || Space.Truth.Data == NULL || Space.BlockLayerOutputs == NULL || Space.Masks == NULL || Space.Caches == NULL || Space.Gradients == NULL)
 					{
-						MaxPrediction = Prediction[i];
-						MaxPredictionIndex = i;
+						printf("Memory Allocation Error.\n");
+						exit(MemoryError);
 					}
-				}
 
-			Free1D(Prediction);
+					Space.Error = 0;
+					Space.Accuracy = 0;
 
-			return MaxPredictionIndex;
-		}
+					for(int Block = 0; Block < Net.TotalBlocks; ++Block)
+					{
+						Space.BlockLayerOutputs[Block] = malloc(sizeof(Tensor) * (Net.Blocks[Block].BlockSize + 1));
+						if(Space.BlockLayerOutputs[Block] == NULL)
+						{
+							printf("Memory Allocation Error.\n");
+							exit(MemoryError);
+						}
 
-	// 2.2 --- Accuracy --- //
+						Space.Masks[Block] = Worker == 0 ? Net.Blocks[Block].Weights : calloc(Net.Blocks[Block].BlockSize, sizeof(Tensor));
+						Space.Caches[Block] = Worker == 0 ? Net.Blocks[Block].Caches : calloc(Net.Blocks[Block].BlockSize, sizeof(ConvCache));
+						Space.Gradients[Block] = calloc(Net.Blocks[Block].BlockSize, sizeof(Tensor));
 
-		// 2.2.1 --- Accuracy --- //
+						if(Space.Masks[Block] == NULL || Space.Caches[Block] == NULL || Space.Gradients[Block] == NULL)
+						{
+							printf("Memory Allocation Error.\n");
+							exit(MemoryError);
+						}
 
-			/*
-				Calculate Wether a Prediction is Correct
+						for(int Layer = 0; Layer < Net.Blocks[Block].BlockSize; ++Layer)
+						{
+							Tensor* Weights = &(Net.Blocks[Block].Weights[Layer]);
 
-				Prediction - Prediction from Network
-				Truth - Label for the Input
+							// Pool Weights are the Mask. Other Layers have Gradients, unless their Block is Frozen
+							Tensor* Own = NULL;
+							int Samples = Weights->Dims[0];
 
-				return value - 1 if Correct, 0 if Wrong
-			*/
+							if(Net.Blocks[Block].Layers[Layer] == Pool && Worker != 0)
+							{
+								Own = &(Space.Masks[Block][Layer]);
+								Samples = TrainChunk;
+							}
+							else if(Net.Blocks[Block].Layers[Layer] != Pool && !Net.Blocks[Block].Frozen)
+							{
+								Own = &(Space.Gradients[Block][Layer]);
+							}
 
-			static double CalcAccuracy(Network Net, double* Prediction, double* Truth)
-			{
-				double MaxPrediction = Prediction[0];
-				double MaxTruth = Truth[0];
+							if(Own == NULL)
+							{
+								continue;
+							}
 
-				double MaxPredictionJ = 0;
-				double MaxTruthJ = 0;
+							*Own = InitTensor(Samples, Weights->Dims + 1);
+							if(Own->Data == NULL)
+							{
+								printf("Memory Allocation Error.\n");
+								exit(MemoryError);
+							}
+						}
+					}
 
-				// --- Find Highest Value of Prediction and Label --- //
+					return Space;
+				}
 
-					for(int j = 1; j < Net.Blocks[Net.TotalBlocks - 1].Dims[Net.Blocks[Net.TotalBlocks - 1].BlockSize][2]; ++j)
-					{
-						// --- Find Max of Prediction --- //
+			// 1.2.3.2 --- Free --- //
 
-							if(Prediction[j] > MaxPrediction)
-							{
-								MaxPrediction = Prediction[j];
-								MaxPredictionJ = j;
-							}
+				/*
+					Free the Workspace of a Training Thread
 
-						// --- Find Max of Truth --- //
+					Net - Network being trained
+					Space - Workspace
+					Worker - Index of the Thread
+
+					return value - Nothing
+				*/
 
-							if(Truth[j] > MaxTruth)
+				static void FreeWorkspace(Network Net, TrainWorkspace* Space, int Worker)
+				{
+					for(int Block = 0; Block < Net.TotalBlocks; ++Block)
+					{
+						for(int Layer = 0; Layer < Net.Blocks[Block].BlockSize; ++Layer)
+						{
+							if(Worker != 0)
 							{
-								MaxTruth = Truth[j];
-								MaxTruthJ = j;
+								FreeTensor(&(Space->Masks[Block][Layer]));
+								FreeConvCache(&(Space->Caches[Block][Layer]));
 							}
+
+							FreeTensor(&(Space->Gradients[Block][Layer]));
+						}
+
+						if(Worker != 0)
+						{
+							free(Space->Masks[Block]);
+							free(Space->Caches[Block]);
+						}
+
+						free(Space->Gradients[Block]);
 					}
 
-				// --- Check if They Match --- //
-				if(MaxPredictionJ == MaxTruthJ)
-				{
-					return 1;
+					for(int Block = 0; Block < Net.TotalBlocks; ++Block)
+					{
+						free(Space->BlockLayerOutputs[Block]);
+					}
+
+					free(Space->Masks);
+					free(Space->Caches);
+					free(Space->Gradients);
+					free(Space->BlockLayerOutputs);
+
+					FreeTensor(&(Space->Input));
+					FreeTensor(&(Space->Truth));
 				}
-				else
+
+		// 1.2.4 --- Update Weights --- //
+
+			// Arguments of UpdateTask
+			typedef struct
+			{
+				Tensor* Weights;
+				Tensor** Gradients;				// Gradients of the Layer from every Workspace
+				int Workers;					// Size of Gradients
+
+				double Rate;
+
+			} UpdateArgs;
+
+			// Sum the Gradients [Start, End) of every Workspace, apply them and clear them. Threads own disjoint ranges, so no Locks are needed
+			static void UpdateTask(void* Args, int Start, int End, int Thread)
+			{
+				(void) Thread;
+
+				UpdateArgs* Task = Args;
+
+				for(int i = Start; i < End; ++i)
 				{
-					return 0;
+					// Summed in Worker order, so the Result only depends on how many Workers there are
+					double Gradient = 0;
+
+					for(int w = 0; w < Task->Workers; ++w)
+					{
+						Gradient += Task->Gradients[w]->Data[i];
+						Task->Gradients[w]->Data[i] = 0;
+					}
+
+					Task->Weights->Data[i] -= Task->Rate * Gradient;
 				}
 			}
 
-		// 2.2.2 --- TestAccuracy --- //
-
 			/*
-				Calculate Accuracy of a given Dataset
+				Reduce the Gradients every Workspace summed over a Batch, apply them to the Weights, and clear them for the next Batch
 
-				Net - Network to be used
-				Inputs - Inputs to Test
-				Truth - Labels of each Input
-				NSamples - How many Inputs to Test
+				Net - Network to be updated
+				Spaces - Workspace of every Training Thread
+				NSpaces - Size of Spaces
+				Rate - Step applied to the Gradients. LearningRate / BatchSize gives the Batch average
 
-				return value - Network Accuracy on the given DataSet
+				return value - Nothing
 			*/
 
-			double CalcTestAccuracy(Network Net, double**** Inputs, double** Labels, int NSamples)
+			static void UpdateWeights(Network Net, TrainWorkspace* Spaces, int NSpaces, double Rate)
 			{
-				double Accuracy = 0;
+				Tensor** Gradients = malloc(sizeof(Tensor*) * NSpaces);
 
-				double TotalTime = 0;
+				for(int Block = 0; Block < Net.TotalBlocks; ++Block)
+				{
+					for(int Layer = 0; Layer < Net.Blocks[Block].BlockSize; ++Layer)
+					{
+						// Pool Layers have no Weights, Frozen Blocks keep theirs, and Hogwild already applied the Fcon Gradients
+						if(Net.Blocks[Block].Layers[Layer] == Pool || Net.Blocks[Block].Frozen || (Net.Hogwild && Net.Blocks[Block].Layers[Layer] == Fcon))
+						{
+							continue;
+						}
 
-				double* Prediction;
+						for(int w = 0; w < NSpaces; ++w)
+						{
+							Gradients[w] = &(Spaces[w].Gradients[Block][Layer]);
+						}
 
-				printf("Current Accuracy -> %d/%d (%.2f%%)\n", (int)Accuracy, 0, 100*Accuracy);
-				printf("Elapsed Time = %.2fs\n", TotalTime/1000000);
+						// Weights and Gradients are both contiguous, with the same Dimensions
+						UpdateArgs Args = {&(Net.Blocks[Block].Weights[Layer]), Gradients, NSpaces, Rate};
+						ParallelFor(Net.Workers, TensorSize(Args.Weights), UpdateTask, &Args);
 
+						// Transformed Filters of every Thread no longer match the Weights. Worker 0 holds the ones of the Network
+						for(int w = 0; w < NSpaces && Net.Blocks[Block].Layers[Layer] == Conv; ++w)
+						{
+							InvalidateConvCache(&(Spaces[w].Caches[Block][Layer]));
+						}
+					}
+				}
 
-				// --- Go Trough every Sample in the DataSet--- //
+				free(Gradients);
+			}
 
-					for(int i = 0; i < NSamples; ++i)
-					{
-						StartTiming();
+	// 1.3 --- Workspace Plan --- //
 
-						// --- Get Network Prediction Prediction --- //
+		// 1.3.1 --- Memory Plan --- //
 
-							Prediction = CNNForwardCpu(Net, Inputs[i]);
+			// 1.3.1.1 --- Fusion --- //
 
-							double MaxPrediction = Prediction[0];
-							double MaxPredictionJ = 0;
+				/*
+					Find the Layers Classification can compute together. A Conv Layer followed by a Pool Layer in the same Block
+					has its Act Func in its Params, and its Output is only read by the Pool Layer, so ConvPoolForwCpu
+					can Pool it as it is computed instead of storing it whole
 
-							double MaxLabel = Labels[i][0];
-							double MaxLabelJ = 0;
+					Net - Network. Fused Layers are placed in Net->Plan.Fused
 
-						for(int j = 1; j < Net.Blocks[Net.TotalBlocks - 1].Dims[Net.Blocks[Net.TotalBlocks - 1].BlockSize][2]; ++j)
-						{
-							// --- Find Max of Prediction --- //
+					return value - Nothing
+				*/
 
-								if(Prediction[j] > MaxPrediction)
-								{
-									MaxPrediction = Prediction[j];
-									MaxPredictionJ = j;
-								}
+				static void PlanFusion(Network* Net)
+				{
+					Net->Plan.Fused = malloc(sizeof(char*) * Net->TotalBlocks);
+					if(Net->Plan.Fused == NULL)
+					{
+						printf("Memory Allocation Error.\n");
+						exit(MemoryError);
+					}
 
-							// --- Find Max of Truth --- //
+					for(int Block = 0; Block < Net->TotalBlocks; ++Block)
+					{
+						Net->Plan.Fused[Block] = calloc(Net->Blocks[Block].BlockSize, sizeof(char));
+						if(Net->Plan.Fused[Block] == NULL)
+						{
+							printf("Memory Allocation Error.\n");
+							exit(MemoryError);
+						}
 
-								if(Labels[i][j] > MaxLabel)
-								{
-									MaxLabel = Labels[i][j];
-									MaxLabelJ = j;
-								}
+						for(int Layer = 0; Layer + 1 < Net->Blocks[Block].BlockSize; ++Layer)
+						{
+							Net->Plan.Fused[Block][Layer] = Net->Blocks[Block].Layers[Layer] == Conv && Net->Blocks[Block].Layers[Layer + 1] == Pool;
 						}
+					}
+				}
 
-						// --- Check if Correct --- //
+			// 1.3.1.2 --- Plan --- //
 
-							if(MaxPredictionJ == MaxLabelJ)
-							{
-								Accuracy++;
-							}
+				/*
+					Give every Layer Output of a Classification a Buffer, from the Lifetimes of the Outputs.
+					The Output of Layer t (counting through every Block) is written by Layer t and last read by Layer t + 1,
+					so its Buffer is free again once Layer t + 1 is done. Each Output takes the free Buffer closest to its size,
+					growing the largest free one if none is big enough, and a new Buffer only if none is free.
+					For a chain of Layers this gives two Buffers used in turns, as big as the largest even and odd Outputs.
+					Activations don't need Buffers of their own, every Layer applies its Activation in place on its Output.
+					A fused Conv gets no Buffer, and its Input stays alive until the Pool Layer after it is done
 
-						// --- Free --- //
+					Net - Network. Plan is placed in Net->Plan
 
-							Free1D(Prediction);
+					return value - Nothing
+				*/
 
-						TotalTime += StopTiming();
+				static void PlanMemory(Network* Net)
+				{
+					MemoryPlan* Plan = &(Net->Plan);
 
-						printf("\033[F\33[2K\033[F\33[2K\033[F\33[2K");
-						printf("Sample -> %d/%d\n", i + 1, NSamples);
-						printf("Current Accuracy -> %d/%d (%.2f%%)\n", (int)Accuracy, i, 100*Accuracy/(i + 1));
-						printf("Elapsed Time = %.2fs\n", TotalTime/1000000);
-					}
+					PlanFusion(Net);
 
-				return 100*Accuracy/NSamples;
-			}
+					int TotalLayers = 0;
+					for(int Block = 0; Block < Net->TotalBlocks; ++Block)
+					{
+						TotalLayers += Net->Blocks[Block].BlockSize;
+					}
 
-// 3 --- Train --- //
+					// --- Allocate Plan. Never more Buffers than Layers --- //
 
-	/*
-		Train Network
-		
-		Net - Network to be used
-		Inputs - Training DataSet. Dimensions need to be {DataSize, InDims}
-		Labels - Labels. Dimensions need to be {DataSize, NClasses}
-		DataSize - How many Inputs the Training DataSet contains
-		MaxEpochs - Maximum Amount of Epochs to run Training for
-		GoalError - Target Error
-		GoalAccuracy - Target Accuracy
+						Plan->Slots = malloc(sizeof(int*) * Net->TotalBlocks);
+						Plan->Sizes = calloc(TotalLayers, sizeof(size_t));
+						int* FreeAfter = malloc(sizeof(int) * TotalLayers);			// Last Layer reading each Buffer
 
-		return value - Nothing
-	*/
+						if(Plan->Slots == NULL || Plan->Sizes == NULL || FreeAfter == NULL)
+						{
+							printf("Memory Allocation Error.\n");
+							exit(MemoryError);
+						}
 
-	void CNNTrainCPU(Network Net, double**** Inputs, double** Labels, int DataSize, int MaxEpochs, double GoalError, double GoalAccuracy)
-	{
-		double TotalTime = 0;
-		double Epochs = 0;
-		double Error = 0;
-		double Accuracy = 0;
+						Plan->Blocks = Net->TotalBlocks;
+						Plan->Buffers = 0;
+						Plan->Peak = 0;
+						Plan->Total = 0;
 
-		double BestError = FLT_MAX;
-		double BestAccuracy = 0;
+					// --- Go Through every Layer in order --- //
 
-		printf("Elapsed Time: %.4f s\n", TotalTime/1000000);
-		printf("Epoch %.2f:\n", Epochs);
-		printf("\tCurrent\t\tBest\n");
-		printf("Err\t%.2f\t\t%.2f\n", Error, BestError);
-		printf("Acc\t%.2f%%\t\t%.2f%%\n", Accuracy, BestAccuracy);
+						int Step = 0;
+						int Previous = -1;			// Buffer of the last Output. -1 for the Network Input
 
-		double* Prediction;
+						for(int Block = 0; Block < Net->TotalBlocks; ++Block)
+						{
+							Plan->Slots[Block] = malloc(sizeof(int) * Net->Blocks[Block].BlockSize);
+							if(Plan->Slots[Block] == NULL)
+							{
+								printf("Memory Allocation Error.\n");
+								exit(MemoryError);
+							}
 
-		// --- Start Training --- //
+							for(int Layer = 0; Layer < Net->Blocks[Block].BlockSize; ++Layer, ++Step)
+							{
+								int* OutDims = Net->Blocks[Block].Dims[Layer + 1];
+								size_t Size = (size_t) OutDims[0] * OutDims[1] * OutDims[2];
 
-			while(1)
-			{
-				StartTiming();
+								Plan->Total += Size;
 
-					// --- Take BatchSize random samples from DataSet --- //
+								// Network Output is written straight to the caller
+								if(Step == TotalLayers - 1)
+								{
+									Plan->Slots[Block][Layer] = -1;
+									continue;
+								}
 
-						for(int i = 0; i < Net.BatchSize; ++i)
-						{
-							int Sample = round(GenerateRand(0, DataSize - 1));
+								// Fused Conv Output is never stored. Its Input is read by the Pool Layer
+								if(Plan->Fused[Block][Layer])
+								{
+									if(Previous >= 0)
+									{
+										FreeAfter[Previous] = Step + 1;
+									}
 
-							// --- Forward BatchSize random samples from DataSet --- //
+									Plan->Slots[Block][Layer] = -2;
+									continue;
+								}
 
-								Prediction = CNNForwardCpu(Net, Inputs[Sample]);
+								// Free Buffers are the ones whose last Reader ran before this Layer
+								int Best = -1;
 
-							// --- Keep Statistics --- //
+								for(int Buffer = 0; Buffer < Plan->Buffers; ++Buffer)
+								{
+									if(FreeAfter[Buffer] >= Step)
+									{
+										continue;
+									}
+
+									char Fits = Plan->Sizes[Buffer] >= Size;
+									char BestFits = Best >= 0 && Plan->Sizes[Best] >= Size;
+
+									// Smallest Buffer that fits, otherwise the largest one, so it grows the least
+									if(Best < 0 || (Fits && (!BestFits || Plan->Sizes[Buffer] < Plan->Sizes[Best])) || (!Fits && !BestFits && Plan->Sizes[Buffer] > Plan->Sizes[Best]))
+									{
+										Best = Buffer;
+									}
+								}
 
-								Error += ErrorForward(Prediction, Labels[Sample], Net.Blocks[Net.TotalBlocks - 1].Dims[Net.Blocks[Net.TotalBlocks - 1].BlockSize][2], Net.EFunc);
-								Accuracy += CalcAccuracy(Net, Prediction, Labels[Sample]);
+								if(Best < 0)
+								{
+									Best = Plan->Buffers++;
+								}
 
-							// --- Backprop --- //
+								if(Size > Plan->Sizes[Best])
+								{
+									Plan->Sizes[Best] = Size;
+								}
 
-								CNNBackwardCpu(Net, Inputs[Sample], Labels[Sample]);
+								FreeAfter[Best] = Step + 1;
+								Plan->Slots[Block][Layer] = Best;
+								Previous = Best;
+							}
+						}
 
-							// --- Free --- //
-								
-								Free1D(Prediction);
+						for(int Buffer = 0; Buffer < Plan->Buffers; ++Buffer)
+						{
+							Plan->Peak += Plan->Sizes[Buffer];
 						}
 
-				// 1.2 --- Update Statistics --- //
+					// --- Free --- //
 
-					Epochs += (Net.BatchSize/(double)DataSize);
-					Error /= (double) Net.BatchSize;
-					Accuracy /= (double) (0.01 * Net.BatchSize);
+						free(FreeAfter);
+				}
 
-					if(Error < BestError)
-					{
-						BestError = Error;
-					}
-					if(Accuracy >= BestAccuracy)
-					{
-						BestAccuracy = Accuracy;
-					}
+			// 1.3.1.3 --- Free --- //
 
-				TotalTime += StopTiming();
+				/*
+					Free a Memory Plan. Safe on a Plan that was never made
 
-				// 1.3 --- Print Statistics to User --- //
+					Plan - Memory Plan
 
-				printf("\033[F\33[2K\033[F\33[2K\033[F\33[2K\033[F\33[2K\033[F\33[2K");
+					return value - Nothing
+				*/
 
-				if(Epochs > MaxEpochs)
+				void FreeMemoryPlan(MemoryPlan* Plan)
 				{
-					printf("Max Epochs Reached!\n");
-					return;
+					for(int Block = 0; Block < Plan->Blocks; ++Block)
+					{
+						free(Plan->Slots[Block]);
+						free(Plan->Fused[Block]);
+					}
+
+					free(Plan->Slots);
+					free(Plan->Fused);
+					free(Plan->Sizes);
+
+					memset(Plan, 0, sizeof(MemoryPlan));
 				}
-				if(BestError <= GoalError)
-				{
-					printf("Error reached Goal!\n");
-					return;
+
+		// 1.3.2 --- Backward Plan --- //
+
+			/*
+				Find where Backpropagation can stop. The Input Error of a Layer is only read by the Layers before it,
+				so nothing before the first Layer with Weights to Train needs an Error. That Layer only takes its Weight Gradients,
+				and the Layers before it are skipped. The first Conv Layer of a Network never computes the Error of the Network Input,
+				and Frozen Blocks at the start of the Network are never Backpropagated
+
+				Net - Network. Stop is placed in Net->StopBlock and Net->StopLayer
+
+				return value - Nothing
+			*/
+
+			static void PlanBackward(Network* Net)
+			{
+				// Nothing to Train, so no Layer is Backpropagated
+				Net->StopBlock = Net->TotalBlocks - 1;
+				Net->StopLayer = Net->Blocks[Net->StopBlock].BlockSize;
+
+				for(int Block = Net->TotalBlocks - 1; Block >= 0; --Block)
+				{
+					for(int Layer = Net->Blocks[Block].BlockSize - 1; Layer >= 0; --Layer)
+					{
+						// Pool Layers have no Weights, Frozen Blocks don't Train theirs
+						if(Net->Blocks[Block].Layers[Layer] != Pool && !Net->Blocks[Block].Frozen)
+						{
+							Net->StopBlock = Block;
+							Net->StopLayer = Layer;
+						}
+					}
+				}
+			}
+
+		// 1.3.3 --- Size --- //
+
+			/*
+				Doubles of Scratch Arena a Thread takes to Forward, or Train, Samples Volumes at once, plus the largest Layer Temporaries.
+				Classification needs the Buffers of the Memory Plan and the Network Output.
+				Training keeps every Layer Output and the Error of every Layer
+
+				Net - Network. Its Memory Plan has to be made already
+				Samples - Volumes Forwarded at once
+				Training - 1 to plan for Training, 0 for Classification
+
+				return value - Doubles needed
+			*/
+
+			static size_t PlanScratch(Network Net, int Samples, char Training)
+			{
+				int* NetOutDims = Net.Blocks[Net.TotalBlocks - 1].Dims[Net.Blocks[Net.TotalBlocks - 1].BlockSize];
+
+				// Network Output, or its Error Derivative while Training
+				size_t Activations = ArenaDoubles(Samples, NetOutDims);
+				size_t Temporaries = 0;
+
+				for(int Buffer = 0; Buffer < Net.Plan.Buffers && !Training; ++Buffer)
+				{
+					int BufferDims[3] = {1, 1, Samples * Net.Plan.Sizes[Buffer]};
+
+					Activations += ArenaDoubles(1, BufferDims);
+				}
+
+				for(int Block = 0; Block < Net.TotalBlocks; ++Block)
+				{
+					for(int Layer = 0; Layer < Net.Blocks[Block].BlockSize; ++Layer)
+					{
+						int* InDims = Net.Blocks[Block].Dims[Layer];
+						int* OutDims = Net.Blocks[Block].Dims[Layer + 1];
+
+						if(Training)
+						{
+							Activations += ArenaDoubles(Samples, OutDims) + ArenaDoubles(Samples, InDims);
+						}
+
+						size_t LayerScratch = 0;
+
+						switch(Net.Blocks[Block].Layers[Layer])
+						{
+							case Conv:
+										LayerScratch = ConvScratch(InDims, OutDims, Net.Blocks[Block].LayerParams[Layer], Samples, Training);
+
+										// Classification Pools a fused Conv as it is computed
+										if(!Training && Net.Plan.Fused[Block][Layer])
+										{
+											LayerScratch = ConvPoolScratch(InDims, Net.Blocks[Block].Dims[Layer + 2], Net.Blocks[Block].LayerParams[Layer],
+																		   Net.Blocks[Block].LayerParams[Layer + 1], Samples);
+										}
+										break;
+
+							case Fcon:
+										LayerScratch = FconScratch(OutDims, Samples, Training);
+										break;
+						}
+
+						if(LayerScratch > Temporaries)
+						{
+							Temporaries = LayerScratch;
+						}
+					}
+				}
+
+				return Activations + Temporaries;
+			}
+
+		// 1.3.4 --- Reserve --- //
+
+			// Grow the Scratch Arena of the Thread running it. Run with one Item per Thread
+			static void ReserveTask(void* Args, int Start, int End, int Thread)
+			{
+				(void) Start;
+				(void) End;
+				(void) Thread;
+
+				ReserveArena(ScratchArena(), *((size_t*) Args));
+			}
+
+			/*
+				Grow the Scratch Arena of the calling Thread and of every Worker
+
+				Workers - Threads. Can be NULL
+				Doubles - Doubles each Arena needs
+
+				return value - Nothing
+			*/
+
+			static void ReserveScratch(ThreadPool* Workers, size_t Doubles)
+			{
+				ParallelFor(Workers, PoolThreads(Workers), ReserveTask, &Doubles);
+			}
+
+			/*
+				Make the Memory and Backward Plans and size the Scratch Arenas for Classification from Block.Dims, so Forward Propagation allocates nothing.
+				Called once the Network is built, and again when the Threads change
+
+				Net - Network
+
+				return value - Nothing
+			*/
+
+			void PlanWorkspace(Network* Net)
+			{
+				FreeMemoryPlan(&(Net->Plan));
+				PlanMemory(Net);
+				PlanBackward(Net);
+
+				Net->Scratch = PlanScratch(*Net, 1, 0);
+
+				ReserveScratch(Net->Workers, Net->Scratch);
+			}
+
+// 2 --- Samples --- //
+
+	// Where Samples come from: a DataSet of doubles, or a DataBuffer of bytes converted and normalized as Samples are gathered
+	typedef struct
+	{
+		double**** Inputs;				// Samples as doubles. Not used with Data
+		double** Labels;				// Labels of Inputs, one hot
+		DataBuffer* Data;				// Samples as stored. NULL for Inputs and Labels
+
+	} SampleSource;
+
+	// 2.1 --- Source --- //
+
+		/*
+			Make a DataBuffer the Source of Samples. Its Images and Classes have to match the Network Input and Output
+
+			Net - Network the Samples are for
+			Data - DataBuffer
+
+			return value - Source
+		*/
+
+		static SampleSource DataSource(Network Net, DataBuffer* Data)
+		{
+			int* InDims = Net.Blocks[0].Dims[0];
+			int* OutDims = Net.Blocks[Net.TotalBlocks - 1].Dims[Net.Blocks[Net.TotalBlocks - 1].BlockSize];
+
+			if(Data->Dims[0] != InDims[0] || Data->Dims[1] != InDims[1] || Data->Dims[2] != InDims[2] || Data->Classes != OutDims[0] * OutDims[1] * OutDims[2])
+			{
+				printf("DataSet of {%d, %d, %d} Images and %d Classes does not match the Network.\n", Data->Dims[0], Data->Dims[1], Data->Dims[2], Data->Classes);
+				exit(CNNConstructionError);
+			}
+
+			SampleSource Source = {NULL, NULL, Data};
+
+			return Source;
+		}
+
+	// 2.2 --- Input --- //
+
+		/*
+			Copy a Sample into a Batch. Samples of a DataBuffer are converted to doubles on the way
+
+			Source - Where Samples come from
+			Sample - Index of the Sample
+			Values - Where to place its Values
+			Count - Values of a Sample
+
+			return value - Nothing
+		*/
+
+		static void GatherInput(SampleSource* Source, int Sample, double* Values, int Count)
+		{
+			if(Source->Data != NULL)
+			{
+				ConvertSample(Source->Data, Sample, Values);
+			}
+			else
+			{
+				Copy1D(Source->Inputs[Sample][0][0], Values, Count);
+			}
+		}
+
+	// 2.3 --- Label --- //
+
+		/*
+			Get the one hot Label of a Sample. Labels of a DataBuffer are expanded into Room
+
+			Source - Where Samples come from
+			Sample - Index of the Sample
+			Room - Where to expand the Label, as many Values as Classes
+
+			return value - Label
+		*/
+
+		static double* GatherLabel(SampleSource* Source, int Sample, double* Room)
+		{
+			if(Source->Data == NULL)
+			{
+				return Source->Labels[Sample];
+			}
+
+			ConvertLabel(Source->Data, Sample, Room);
+
+			return Room;
+		}
+
+// 3 --- Network Performance --- //
+
+	// 3.1 --- Classify --- //
+
+		// 3.1.1 --- Best Class --- //
+
+			/*
+				Find the Class with the highest Value
+
+				Values - Network Output, or Label, of one Sample
+				Classes - Size of Values
+
+				return value - Index of the highest Value. The first one on ties
+			*/
+
+			static int BestClass(double* Values, int Classes)
+			{
+				int Best = 0;
+
+				for(int i = 1; i < Classes; ++i)
+				{
+					if(Values[i] > Values[Best])
+					{
+						Best = i;
+					}
+				}
+
+				return Best;
+			}
+
+		// 3.1.2 --- Classify --- //
+
+			/*
+				Get CNN Classification of a given Input
+
+				Input - Input to Classify
+				Network - Network to be used for Classification
+
+				return value - Class Input belongs to.
+			*/
+
+			int Classify(Network Net, double*** Input)
+			{
+				int Class;
+
+				Tensor InputView = ViewTensor(Input[0][0], 1, Net.Blocks[0].Dims[0]);
+
+				ClassifyBatch(&Net, &InputView, &Class);
+
+				return Class;
+			}
+
+		// 3.1.3 --- Classify Batch --- //
+
+			/*
+				Get CNN Classification of every Sample of a Batch. Samples are Forwarded ClassifyChunk at a time,
+				so every Layer works on a whole Chunk: Fcon Layers are one Gemm instead of a Gemv per Sample,
+				and Conv Layers with small Outputs lower several Samples into one Gemm.
+				Chunks reuse the Buffers of the Memory Plan, taken from the Scratch Arena of the calling Thread
+
+				Net - Network to be used for Classification
+				Batch - Inputs to Classify. Any amount of Samples, each with the Dimensions of the Network Input
+				Classes - Where to place the Class of every Sample. Size Batch->Dims[0]
+
+				return value - Nothing
+			*/
+
+			void ClassifyBatch(Network* Net, Tensor* Batch, int* Classes)
+			{
+				int* OutDims = Net->Blocks[Net->TotalBlocks - 1].Dims[Net->Blocks[Net->TotalBlocks - 1].BlockSize];
+				int NClasses = OutDims[0] * OutDims[1] * OutDims[2];
+
+				int Chunk = Batch->Dims[0] < ClassifyChunk ? Batch->Dims[0] : ClassifyChunk;
+
+				// --- Size the Arena for a whole Chunk, unless the caller is using it already --- //
+
+					Arena* Space = ScratchArena();
+
+					if(Space->Used == 0)
+					{
+						ReserveArena(Space, PlanScratch(*Net, Chunk, 0));
+					}
+
+					size_t Mark = Space->Used;
+
+				// --- Forward every Chunk --- //
+
+					for(int First = 0; First < Batch->Dims[0]; First += Chunk)
+					{
+						int Samples = Batch->Dims[0] - First < Chunk ? Batch->Dims[0] - First : Chunk;
+
+						Tensor Input = *Batch;
+						Input.Data = Batch->Data + (size_t) First * Batch->Strides[0];
+						Input.Dims[0] = Samples;
+						Input.Owner = 0;
+
+						Tensor Output = ArenaTensor(Space, Samples, OutDims);
+						if(Output.Data == NULL)
+						{
+							printf("Memory Allocation Error.\n");
+							exit(MemoryError);
+						}
+
+						CNNForwardCpu(*Net, Net->TotalBlocks, &Input, &Output);
+
+						for(int sample = 0; sample < Samples; ++sample)
+						{
+							Classes[First + sample] = BestClass(Output.Data + sample * Output.Strides[0], NClasses);
+						}
+
+						FreeTensor(&Output);
+						ReleaseArena(Space, Mark);
+					}
+			}
+
+	// 3.2 --- Accuracy --- //
+
+		// 3.2.1 --- Accuracy --- //
+
+			/*
+				Calculate Wether a Prediction is Correct
+
+				Prediction - Prediction from Network
+				Truth - Label for the Input
+
+				return value - 1 if Correct, 0 if Wrong
+			*/
+
+			static double CalcAccuracy(Network Net, double* Prediction, double* Truth)
+			{
+				int NClasses = Net.Blocks[Net.TotalBlocks - 1].Dims[Net.Blocks[Net.TotalBlocks - 1].BlockSize][2];
+
+				return BestClass(Prediction, NClasses) == BestClass(Truth, NClasses);
+			}
+
+		// 3.2.2 --- TestAccuracy --- //
+
+			/*
+				Calculate Accuracy of the Samples of a Source. Samples are gathered and Classified ClassifyChunk at a time
+
+				Net - Network to be used
+				Source - Where Samples come from
+				NSamples - How many Samples to Test
+
+				return value - Network Accuracy on the given Samples
+			*/
+
+			static double TestAccuracyCpu(Network Net, SampleSource* Source, int NSamples)
+			{
+				double Accuracy = 0;
+
+				double TotalTime = 0;
+
+				int* OutDims = Net.Blocks[Net.TotalBlocks - 1].Dims[Net.Blocks[Net.TotalBlocks - 1].BlockSize];
+				int NClasses = OutDims[0] * OutDims[1] * OutDims[2];
+
+				// --- Chunk of Inputs and their Classes --- //
+
+					int Chunk = NSamples < ClassifyChunk ? NSamples : ClassifyChunk;
+
+					// Room for the Chunk next to what ClassifyBatch needs, so it is never taken from the heap
+					Arena* Space = ScratchArena();
+
+					if(Space->Used == 0)
+					{
+						ReserveArena(Space, ArenaDoubles(Chunk, Net.Blocks[0].Dims[0]) + PlanScratch(Net, Chunk, 0));
+					}
+
+					size_t Mark = Space->Used;
+
+					Tensor Batch = ArenaTensor(Space, Chunk, Net.Blocks[0].Dims[0]);
+					if(Batch.Data == NULL)
+					{
+						printf("Memory Allocation Error.\n");
+						exit(MemoryError);
+					}
+
+					int Classes[Chunk > 0 ? Chunk : 1];
+					double Room[NClasses];
+
+				printf("Current Accuracy -> %d/%d (%.2f%%)\n", (int)Accuracy, 0, 100*Accuracy);
+				printf("Elapsed Time = %.2fs\n", TotalTime/1000000);
+
+
+				// --- Go Trough every Chunk in the DataSet--- //
+
+					for(int First = 0; First < NSamples; First += Chunk)
+					{
+						StartTiming();
+
+						int Samples = NSamples - First < Chunk ? NSamples - First : Chunk;
+
+						// --- Gather Inputs --- //
+
+							Batch.Dims[0] = Samples;
+
+							for(int i = 0; i < Samples; ++i)
+							{
+								GatherInput(Source, First + i, Batch.Data + i * Batch.Strides[0], SampleSize(&Batch));
+							}
+
+						// --- Get Network Predictions and Check if Correct --- //
+
+							ClassifyBatch(&Net, &Batch, Classes);
+
+							for(int i = 0; i < Samples; ++i)
+							{
+								if(Classes[i] == BestClass(GatherLabel(Source, First + i, Room), NClasses))
+								{
+									Accuracy++;
+								}
+							}
+
+						TotalTime += StopTiming();
+
+						int Done = First + Samples;
+
+						printf("\033[F\33[2K\033[F\33[2K\033[F\33[2K");
+						printf("Sample -> %d/%d\n", Done, NSamples);
+						printf("Current Accuracy -> %d/%d (%.2f%%)\n", (int)Accuracy, Done, 100*Accuracy/Done);
+						printf("Elapsed Time = %.2fs\n", TotalTime/1000000);
+					}
+
+				// --- Free --- //
+
+					FreeTensor(&Batch);
+					ReleaseArena(Space, Mark);
+
+				return 100*Accuracy/NSamples;
+			}
+
+			/*
+				Calculate Accuracy of a given Dataset
+
+				Net - Network to be used
+				Inputs - Inputs to Test
+				Truth - Labels of each Input
+				NSamples - How many Inputs to Test
+
+				return value - Network Accuracy on the given DataSet
+			*/
+
+			double CalcTestAccuracy(Network Net, double**** Inputs, double** Labels, int NSamples)
+			{
+				SampleSource Source = {Inputs, Labels, NULL};
+
+				return TestAccuracyCpu(Net, &Source, NSamples);
+			}
+
+			/*
+				Calculate Accuracy of a DataSet kept as it is stored. Samples are converted as they are gathered
+
+				Net - Network to be used
+				Data - Samples to Test
+
+				return value - Network Accuracy on the given DataSet
+			*/
+
+			double CalcDataAccuracy(Network Net, DataBuffer* Data)
+			{
+				SampleSource Source = DataSource(Net, Data);
+
+				return TestAccuracyCpu(Net, &Source, Data->Samples);
+			}
+
+// 4 --- Train --- //
+
+	// 4.1 --- Feature Cache --- //
+
+		// Output of the Frozen Blocks at the start of the Network for every Training Sample
+		typedef struct
+		{
+			Tensor Features;				// {DataSize, Output Dimensions of the last Frozen Block}. Empty without a Cache
+			int Blocks;						// Frozen Blocks the Features stand for. 0 without a Cache
+
+			size_t Bytes;					// Size of the Mapping when Features are in a File, 0 when they are in memory
+
+		} FeatureCache;
+
+		// 4.1.1 --- Init --- //
+
+			/*
+				Forward the Frozen Blocks at the start of the Network once for every Training Sample, ClassifyChunk at a time and without Dropout.
+				Their Weights never change while Training, so neither do their Outputs.
+				Features are kept in memory, or in the File at Net.FeaturePath mapped with mmap, so Pages the OS needs back
+				are written to the File instead of Swap. The File is rewritten every time Training starts
+
+				Net - Network to be trained
+				Source - Training DataSet
+				DataSize - How many Samples the Training DataSet contains
+
+				return value - Cache. Blocks is 0 if nothing is Cached
+			*/
+
+			static FeatureCache InitFeatureCache(Network Net, SampleSource* Source, int DataSize)
+			{
+				FeatureCache Cache;
+				memset(&Cache, 0, sizeof(FeatureCache));
+
+				// --- Frozen Blocks at the start. The last Block is always Forwarded, it holds the Network Output --- //
+
+					while(Net.CacheFeatures && Cache.Blocks < Net.TotalBlocks - 1 && Net.Blocks[Cache.Blocks].Frozen)
+					{
+						++(Cache.Blocks);
+					}
+
+					if(Cache.Blocks == 0)
+					{
+						return Cache;
+					}
+
+				// --- Storage --- //
+
+					int* Dims = Net.Blocks[Cache.Blocks].Dims[0];
+
+					if(Net.FeaturePath == NULL)
+					{
+						Cache.Features = InitTensor(DataSize, Dims);
+						if(Cache.Features.Data == NULL)
+						{
+							printf("Memory Allocation Error.\n");
+							exit(MemoryError);
+						}
+					}
+					else
+					{
+						Cache.Features = ViewTensor(NULL, DataSize, Dims);
+						Cache.Bytes = (size_t) TensorSize(&(Cache.Features)) * sizeof(double);
+
+						int File = open(Net.FeaturePath, O_RDWR | O_CREAT | O_TRUNC, 0644);
+						if(File < 0 || ftruncate(File, Cache.Bytes) != 0)
+						{
+							printf("File opening Error.\n");
+							exit(FileError);
+						}
+
+						// The Mapping keeps the File open
+						void* Map = mmap(NULL, Cache.Bytes, PROT_READ | PROT_WRITE, MAP_SHARED, File, 0);
+						close(File);
+
+						if(Map == MAP_FAILED)
+						{
+							printf("File opening Error.\n");
+							exit(FileError);
+						}
+
+						Cache.Features.Data = Map;
+					}
+
+				// --- Forward every Chunk, with the Layers split between the Threads --- //
+
+					Tensor Input = InitTensor(ClassifyChunk, Net.Blocks[0].Dims[0]);
+					if(Input.Data == NULL)
+					{
+						printf("Memory Allocation Error.\n");
+						exit(MemoryError);
+					}
+
+					Arena* Space = ScratchArena();
+
+					if(Space->Used == 0)
+					{
+						ReserveArena(Space, PlanScratch(Net, ClassifyChunk, 0));
+					}
+
+					for(int First = 0; First < DataSize; First += ClassifyChunk)
+					{
+						int Samples = DataSize - First < ClassifyChunk ? DataSize - First : ClassifyChunk;
+
+						Input.Dims[0] = Samples;
+
+						for(int i = 0; i < Samples; ++i)
+						{
+							GatherInput(Source, First + i, Input.Data + i * Input.Strides[0], SampleSize(&Input));
+						}
+
+						Tensor Output = Cache.Features;
+						Output.Data = Cache.Features.Data + (size_t) First * Cache.Features.Strides[0];
+						Output.Dims[0] = Samples;
+						Output.Owner = 0;
+
+						CNNForwardCpu(Net, Cache.Blocks, &Input, &Output);
+					}
+
+					FreeTensor(&Input);
+
+				return Cache;
+			}
+
+		// 4.1.2 --- Free --- //
+
+			/*
+				Free a Feature Cache. The File of a mapped Cache is kept
+
+				Cache - Feature Cache
+
+				return value - Nothing
+			*/
+
+			static void FreeFeatureCache(FeatureCache* Cache)
+			{
+				if(Cache->Bytes > 0)
+				{
+					munmap(Cache->Features.Data, Cache->Bytes);
+				}
+				else
+				{
+					FreeTensor(&(Cache->Features));
+				}
+
+				memset(Cache, 0, sizeof(FeatureCache));
+			}
+
+	// 4.2 --- Sampler --- //
+
+		// Order the Training Samples are handed out in. Every Epoch is a new Permutation, so each Sample is used once per Epoch
+		typedef struct
+		{
+			int* Order;						// Permutation of the Training Samples for the current Epoch
+			int Next;						// First Sample of Order not handed out yet
+			int DataSize;
+
+			RandState Rand;					// Draws the Permutations, and the Dropout Seed of every Batch
+
+		} EpochSampler;
+
+		// 4.2.1 --- Init --- //
+
+			/*
+				Create a Sampler and shuffle its first Epoch. It is seeded from rand(), so srand still makes Training repeatable
+
+				Sampler - Where to place the Sampler
+				DataSize - How many Samples the Training DataSet contains
+
+				return value - Nothing
+			*/
+
+			static void InitSampler(EpochSampler* Sampler, int DataSize)
+			{
+				Sampler->Order = malloc(sizeof(int) * DataSize);
+
+				if(Sampler->Order == NULL)
+				{
+					printf("Memory Allocation Error.\n");
+					exit(MemoryError);
+				}
+
+				for(int i = 0; i < DataSize; ++i)
+				{
+					Sampler->Order[i] = i;
+				}
+
+				Sampler->Next = 0;
+				Sampler->DataSize = DataSize;
+
+				SeedRand(&(Sampler->Rand), ((uint64_t) rand() << 31) ^ rand());
+				ShuffleIndices(&(Sampler->Rand), Sampler->Order, DataSize);
+			}
+
+		// 4.2.2 --- Draw --- //
+
+			/*
+				Hand out the next Samples of the Permutation, as one contiguous range.
+				Once every Sample of the Epoch is handed out, the next Epoch is shuffled and the range carries on into it
+
+				Sampler - Sampler
+				Chosen - Where to place the Dataset Index of every Sample
+				Count - Amount of Samples
+
+				return value - Nothing
+			*/
+
+			static void DrawSamples(EpochSampler* Sampler, int* Chosen, int Count)
+			{
+				while(Count > 0)
+				{
+					if(Sampler->Next == Sampler->DataSize)
+					{
+						ShuffleIndices(&(Sampler->Rand), Sampler->Order, Sampler->DataSize);
+						Sampler->Next = 0;
+					}
+
+					int Range = Sampler->DataSize - Sampler->Next < Count ? Sampler->DataSize - Sampler->Next : Count;
+
+					memcpy(Chosen, Sampler->Order + Sampler->Next, sizeof(int) * Range);
+
+					Sampler->Next += Range;
+					Chosen += Range;
+					Count -= Range;
+				}
+			}
+
+		// 4.2.3 --- Free --- //
+
+			/*
+				Free a Sampler
+
+				Sampler - Sampler
+
+				return value - Nothing
+			*/
+
+			static void FreeSampler(EpochSampler* Sampler)
+			{
+				free(Sampler->Order);
+
+				memset(Sampler, 0, sizeof(EpochSampler));
+			}
+
+	// 4.3 --- Prefetch --- //
+
+		// Mini-Batch drawn ahead, and assembled by a Loader Thread if there are any
+		typedef struct
+		{
+			int* Chosen;					// Dataset Index of every Sample, drawn by the Training Thread
+			Tensor Inputs;					// Samples, or their Cached Features. BatchSize Volumes
+			Tensor Truth;					// One hot Labels. BatchSize Labels
+
+			uint64_t Seed;					// Seeds the Dropout of every Sample of the Batch
+			long Sequence;					// 2n + 1 once Batch n is requested, 2n + 2 once it is ready
+
+		} BatchSlot;
+
+		// Bounded Ring of Batches assembled ahead of Training. Batch n goes to Slot n % PrefetchBatches, and is assembled by Loader n % Loaders.
+		// Each Slot has one writer at a time, handed over through its Sequence, so neither side ever takes a Lock
+		typedef struct
+		{
+			BatchSlot Slots[PrefetchBatches];
+
+			int Loaders;					// Loader Threads. 0 to gather Batches in the Training Threads
+			pthread_t* Threads;
+			int Started;					// Loader Threads started so far. Each takes the next index
+
+			SampleSource* Source;			// Training DataSet
+			FeatureCache* Cache;			// Features of the Frozen Blocks, gathered instead of the Samples when it is not empty
+			EpochSampler Sampler;			// Samples of every Batch, drawn by the Training Thread
+			int BatchSize;
+
+			int Stop;						// Set once Training ends, so waiting Loaders return
+
+		} Prefetcher;
+
+		// 4.3.1 --- Gather --- //
+
+			/*
+				Copy a Training Sample, or its Cached Features, and its one hot Label
+
+				Source - Training DataSet
+				Cache - Feature Cache
+				Sample - Index of the Sample
+				Values - Where to place its Values
+				Count - Values of a Sample, or of its Features
+				Label - Where to place its Label
+
+				return value - Nothing
+			*/
+
+			static void GatherSample(SampleSource* Source, FeatureCache* Cache, int Sample, double* Values, int Count, double* Label, int Classes)
+			{
+				if(Cache->Blocks > 0)
+				{
+					Copy1D(Cache->Features.Data + (size_t) Sample * Cache->Features.Strides[0], Values, Count);
+				}
+				else
+				{
+					GatherInput(Source, Sample, Values, Count);
+				}
+
+				double* Truth = GatherLabel(Source, Sample, Label);
+
+				if(Truth != Label)
+				{
+					Copy1D(Truth, Label, Classes);
+				}
+			}
+
+		// 4.3.2 --- Wait --- //
+
+			/*
+				Wait until a Slot reaches a Sequence, or Training stops. Spins with sched_yield first, then sleeps briefly,
+				so a waiting Thread doesn't take a core from the Training Threads for long
+
+				Slot - Slot
+				Sequence - Sequence to wait for
+				Stop - Stop Flag of the Ring
+
+				return value - 1 once the Slot is at Sequence, 0 if Training stopped first
+			*/
+
+			static int WaitSlot(BatchSlot* Slot, long Sequence, int* Stop)
+			{
+				struct timespec Pause = {0, 20000};
+
+				for(int Spins = 0; __atomic_load_n(&(Slot->Sequence), __ATOMIC_ACQUIRE) != Sequence; ++Spins)
+				{
+					if(__atomic_load_n(Stop, __ATOMIC_ACQUIRE))
+					{
+						return 0;
+					}
+
+					if(Spins < 64)
+					{
+						sched_yield();
+					}
+					else
+					{
+						nanosleep(&Pause, NULL);
+					}
+				}
+
+				return 1;
+			}
+
+		// 4.3.3 --- Loader --- //
+
+			/*
+				Loader Thread. Assembles every Loaders-th Batch as soon as it is requested, until Training stops.
+				Conversion of the Samples, and any future Augmentation, happens here instead of in the Training Threads
+
+				Args - Ring
+
+				return value - NULL
+			*/
+
+			static void* LoaderLoop(void* Args)
+			{
+				Prefetcher* Ring = Args;
+
+				int Loader = __atomic_fetch_add(&(Ring->Started), 1, __ATOMIC_RELAXED);
+
+				for(long Batch = Loader; ; Batch += Ring->Loaders)
+				{
+					BatchSlot* Slot = &(Ring->Slots[Batch % PrefetchBatches]);
+
+					if(!WaitSlot(Slot, 2 * Batch + 1, &(Ring->Stop)))
+					{
+						return NULL;
+					}
+
+					for(int i = 0; i < Ring->BatchSize; ++i)
+					{
+						GatherSample(Ring->Source, Ring->Cache, Slot->Chosen[i], Slot->Inputs.Data + i * Slot->Inputs.Strides[0], SampleSize(&(Slot->Inputs)),
+									 Slot->Truth.Data + i * Slot->Truth.Strides[0], SampleSize(&(Slot->Truth)));
+					}
+
+					__atomic_store_n(&(Slot->Sequence), 2 * Batch + 2, __ATOMIC_RELEASE);
+				}
+			}
+
+		// 4.3.4 --- Request --- //
+
+			/*
+				Draw the Samples of a Batch and the Seed of its Dropout, and hand its Slot to the Loaders. Only the Training Thread draws,
+				so the Samples are the same for any amount of Loaders
+
+				Ring - Ring
+				Batch - Index of the Batch. Its Slot must hold no Batch still in use
+
+				return value - Nothing
+			*/
+
+			static void RequestBatch(Prefetcher* Ring, long Batch)
+			{
+				BatchSlot* Slot = &(Ring->Slots[Batch % PrefetchBatches]);
+
+				DrawSamples(&(Ring->Sampler), Slot->Chosen, Ring->BatchSize);
+				Slot->Seed = NextRand(&(Ring->Sampler.Rand));
+
+				__atomic_store_n(&(Slot->Sequence), 2 * Batch + 1, __ATOMIC_RELEASE);
+			}
+
+		// 4.3.5 --- Start --- //
+
+			/*
+				Allocate the Ring, request the first Batches and start the Loader Threads
+
+				Ring - Where to place the Ring
+				Net - Network to be trained
+				Source - Training DataSet
+				Cache - Feature Cache
+				DataSize - How many Samples the Training DataSet contains
+
+				return value - Nothing
+			*/
+
+			static void StartPrefetch(Prefetcher* Ring, Network Net, SampleSource* Source, FeatureCache* Cache, int DataSize)
+			{
+				memset(Ring, 0, sizeof(Prefetcher));
+
+				Ring->Loaders = Net.Loaders;
+				Ring->Source = Source;
+				Ring->Cache = Cache;
+				Ring->BatchSize = Net.BatchSize;
+
+				InitSampler(&(Ring->Sampler), DataSize);
+
+				Ring->Loaders = Ring->Loaders > 0 ? Ring->Loaders : 0;
+
+				int* OutDims = Net.Blocks[Net.TotalBlocks - 1].Dims[Net.Blocks[Net.TotalBlocks - 1].BlockSize];
+
+				for(int b = 0; b < PrefetchBatches; ++b)
+				{
+					BatchSlot* Slot = &(Ring->Slots[b]);
+
+					Slot->Chosen = malloc(sizeof(int) * Net.BatchSize);
+
+					if(Slot->Chosen == NULL)
+					{
+						printf("Memory Allocation Error.\n");
+						exit(MemoryError);
+					}
+
+					// Without Loaders, the Training Threads gather the Samples of Chosen themselves
+					if(Ring->Loaders > 0)
+					{
+						Slot->Inputs = InitTensor(Net.BatchSize, Net.Blocks[Cache->Blocks].Dims[0]);
+						Slot->Truth = InitTensor(Net.BatchSize, OutDims);
+
+						if(Slot->Inputs.Data == NULL || Slot->Truth.Data == NULL)
+						{
+							printf("Memory Allocation Error.\n");
+							exit(MemoryError);
+						}
+					}
+
+					RequestBatch(Ring, b);
 				}
-				if(BestAccuracy >= GoalAccuracy)
+
+				if(Ring->Loaders == 0)
 				{
-					printf("Accuracy reached Goal!\n");
 					return;
 				}
 
-				printf("Elapsed Time: %.4f s\n", TotalTime/1000000);
-				printf("Epoch %.2f:\n", Epochs);
-				printf("\tCurrent\t\tBest\n");
-				printf("Err\t%.2f\t\t%.2f\n", Error, BestError);
-				printf("Acc\t%.2f%%\t\t%.2f%%\n", Accuracy, BestAccuracy);
+				Ring->Threads = malloc(sizeof(pthread_t) * Ring->Loaders);
+
+				if(Ring->Threads == NULL)
+				{
+					printf("Memory Allocation Error.\n");
+					exit(MemoryError);
+				}
+
+				for(int l = 0; l < Ring->Loaders; ++l)
+				{
+					if(pthread_create(&(Ring->Threads[l]), NULL, LoaderLoop, Ring) != 0)
+					{
+						printf("Thread Creation Error.\n");
+						exit(MemoryError);
+					}
+				}
+			}
+
+		// 4.3.6 --- Stop --- //
+
+			/*
+				Stop the Loader Threads and free the Ring
+
+				Ring - Ring
+
+				return value - Nothing
+			*/
+
+			static void StopPrefetch(Prefetcher* Ring)
+			{
+				__atomic_store_n(&(Ring->Stop), 1, __ATOMIC_RELEASE);
+
+				for(int l = 0; l < Ring->Loaders; ++l)
+				{
+					pthread_join(Ring->Threads[l], NULL);
+				}
+
+				for(int b = 0; b < PrefetchBatches; ++b)
+				{
+					free(Ring->Slots[b].Chosen);
+
+					if(Ring->Loaders > 0)
+					{
+						FreeTensor(&(Ring->Slots[b].Inputs));
+						FreeTensor(&(Ring->Slots[b].Truth));
+					}
+				}
+
+				free(Ring->Threads);
+				FreeSampler(&(Ring->Sampler));
+
+				memset(Ring, 0, sizeof(Prefetcher));
+			}
+
+	// 4.4 --- Worker --- //
+
+		// Arguments of TrainTask
+		typedef struct
+		{
+			Network* Net;
+			TrainWorkspace* Spaces;
+			FeatureCache* Cache;			// Features of the Frozen Blocks. Samples come from the DataSet when it is empty
+
+			SampleSource* Source;			// Training DataSet
+			int* Chosen;					// Dataset Index of every Sample in the Batch
+			BatchSlot* Batch;				// Batch assembled by the Loaders. NULL to gather the Samples of Chosen here
+			uint64_t Seed;					// Dropout Seed of the Batch
+
+			double Rate;					// Step applied to the Gradients
+
+		} TrainArgs;
+
+		/*
+			Forward and Backpropagate Samples [Start, End) of a Batch, TrainChunk at a time, in the Workspace of Thread.
+			With Hogwild, Fcon Gradients are applied to the shared Weights after every Chunk, without Locks
+
+			Return Value - Nothing
+		*/
+
+		static void TrainTask(void* Args, int Start, int End, int Thread)
+		{
+			TrainArgs* Task = Args;
+			Network Net = *(Task->Net);
+			TrainWorkspace* Space = &(Task->Spaces[Thread]);
+
+			// Layer Outputs, Errors and Layer Temporaries of a Chunk, given back once it is done
+			Arena* Scratch = ScratchArena();
+			size_t Mark = Scratch->Used;
+
+			int* OutDims = Net.Blocks[Net.TotalBlocks - 1].Dims[Net.Blocks[Net.TotalBlocks - 1].BlockSize];
+
+			for(int First = Start; First < End; First += TrainChunk)
+			{
+				int Samples = End - First < TrainChunk ? End - First : TrainChunk;
+
+				// Dropout Masks come from the Seed of the Batch and the Position of each Sample in it
+				SetDropoutSeed(Task->Seed, First);
+
+				// --- Gather Samples, or read them from the prefetched Batch --- //
+
+					Tensor Input = Space->Input;
+					Tensor Labels = Space->Truth;
+
+					if(Task->Batch != NULL)
+					{
+						Input = Task->Batch->Inputs;
+						Input.Data += (size_t) First * Input.Strides[0];
+
+						Labels = Task->Batch->Truth;
+						Labels.Data += (size_t) First * Labels.Strides[0];
+					}
+					else
+					{
+						for(int i = 0; i < Samples; ++i)
+						{
+							GatherSample(Task->Source, Task->Cache, Task->Chosen[First + i], Input.Data + i * Input.Strides[0], SampleSize(&Input),
+										 Labels.Data + i * Labels.Strides[0], SampleSize(&Labels));
+						}
+					}
+
+					Input.Dims[0] = Samples;
+					Input.Owner = 0;
+
+				// --- Forward, once for both Statistics and Backprop. Cached Blocks are skipped --- //
 
-				Error = 0;
-				Accuracy = 0;
+					CNNForwardCpuTrain(Net, Task->Cache->Blocks, &Input, Space->BlockLayerOutputs, Space->Masks, Space->Caches, Scratch);
+
+					Tensor* Output = &(Space->BlockLayerOutputs[Net.TotalBlocks - 1][Net.Blocks[Net.TotalBlocks - 1].BlockSize]);
+
+					Tensor ErrorGrad = ArenaTensor(Scratch, Samples, OutDims);
+					if(ErrorGrad.Data == NULL)
+					{
+						printf("Memory Allocation Error.\n");
+						exit(MemoryError);
+					}
+
+				// --- Keep Statistics and get Error --- //
+
+					double* Truth[TrainChunk];
+
+					for(int i = 0; i < Samples; ++i)
+					{
+						Truth[i] = Labels.Data + i * Labels.Strides[0];
+					}
+
+					// A Softmax Output still holds its Logits. Softmax, Error and Error Derivative are done in one pass
+					if(Net.Blocks[Net.TotalBlocks - 1].LayerParams[Net.Blocks[Net.TotalBlocks - 1].BlockSize - 1][0] == Soft)
+					{
+						Space->Error += SoftmaxError(Output, Truth, &ErrorGrad, Net.EFunc);
+					}
+					else
+					{
+						for(int i = 0; i < Samples; ++i)
+						{
+							double* Prediction = Output->Data + i * Output->Strides[0];
+
+							Space->Error += ErrorForward(Prediction, Truth[i], OutDims[2], Net.EFunc);
+							ErrorBackward(Prediction, Truth[i], ErrorGrad.Data + i * ErrorGrad.Strides[0], OutDims[2], Net.EFunc);
+						}
+					}
+
+					for(int i = 0; i < Samples; ++i)
+					{
+						Space->Accuracy += CalcAccuracy(Net, Output->Data + i * Output->Strides[0], Truth[i]);
+					}
+
+				// --- Backprop. Accumulates Gradients and Frees Layer Outputs --- //
+
+					CNNBackwardCpu(Net, Task->Cache->Blocks, Space->BlockLayerOutputs, &ErrorGrad, Space->Masks, Space->Caches, Space->Gradients, Scratch);
+
+				// --- Hogwild --- //
+
+					// Other Workers may be reading or updating the same Weights. Lost updates are accepted in exchange for no waiting
+					for(int Block = 0; Block < Net.TotalBlocks && Net.Hogwild; ++Block)
+					{
+						for(int Layer = 0; Layer < Net.Blocks[Block].BlockSize; ++Layer)
+						{
+							if(Net.Blocks[Block].Layers[Layer] != Fcon || Net.Blocks[Block].Frozen)
+							{
+								continue;
+							}
+
+							double* Weights = Net.Blocks[Block].Weights[Layer].Data;
+							double* Gradients = Space->Gradients[Block][Layer].Data;
+
+							int Size = TensorSize(&(Net.Blocks[Block].Weights[Layer]));
+
+							for(int i = 0; i < Size; ++i)
+							{
+								Weights[i] -= Task->Rate * Gradients[i];
+								Gradients[i] = 0;
+							}
+						}
+					}
+
+				// --- Free --- //
+
+					FreeTensor(&ErrorGrad);
+					ReleaseArena(Scratch, Mark);
 			}
-	}
+
+			// Forwards outside Training draw their Masks from ThreadRand again
+			SetDropoutSeed(0, -1);
+		}
+
+	// 4.5 --- Train --- //
+
+		/*
+			Train Network.
+			Every Epoch goes through a new Permutation of the Training Samples (EpochSampler), BatchSize consecutive ones per Batch.
+			With Threads (SetNumThreads), every Batch is split between them. Each Thread keeps its own Gradients,
+			which are reduced before a single Weight Update per Batch.
+			Frozen Blocks (FreezeBlock) keep their Weights. Those at the start of the Network are Forwarded once into the Feature Cache (SetFeatureCache).
+			With Loaders (SetLoaders), Batches are assembled by background Threads while the previous ones are Trained
+			
+			Net - Network to be used
+			Source - Training DataSet
+			DataSize - How many Samples the Training DataSet contains
+			MaxEpochs - Maximum Amount of Epochs to run Training for
+			GoalError - Target Error
+			GoalAccuracy - Target Accuracy
+
+			return value - Nothing
+		*/
+
+		static void TrainCpu(Network Net, SampleSource* Source, int DataSize, int MaxEpochs, double GoalError, double GoalAccuracy)
+		{
+			double TotalTime = 0;
+			double Epochs = 0;
+			double Error = 0;
+			double Accuracy = 0;
+
+			double BestError = FLT_MAX;
+			double BestAccuracy = 0;
+
+			printf("Elapsed Time: %.4f s\n", TotalTime/1000000);
+			printf("Epoch %.2f:\n", Epochs);
+			printf("\tCurrent\t\tBest\n");
+			printf("Err\t%.2f\t\t%.2f\n", Error, BestError);
+			printf("Acc\t%.2f%%\t\t%.2f%%\n", Accuracy, BestAccuracy);
+
+			// --- Features of the Frozen Blocks --- //
+
+				FeatureCache Cache = InitFeatureCache(Net, Source, DataSize);
+
+			// --- Setup Workers --- //
+
+				int NSpaces = PoolThreads(Net.Workers);
+
+				TrainWorkspace* Spaces = malloc(sizeof(TrainWorkspace) * NSpaces);
+
+				if(Spaces == NULL)
+				{
+					printf("Memory Allocation Error.\n");
+					exit(MemoryError);
+				}
+
+				for(int w = 0; w < NSpaces; ++w)
+				{
+					Spaces[w] = InitWorkspace(Net, w, Cache.Blocks);
+				}
+
+				// Every Thread Forwards and Backpropagates its own Chunks
+				ReserveScratch(Net.Workers, PlanScratch(Net, TrainChunk, 1));
+
+				TrainArgs Args = {&Net, Spaces, &Cache, Source, NULL, NULL, 0, Net.LearningRate / Net.BatchSize};
+
+			// --- Batches drawn PrefetchBatches ahead, and assembled by the Loaders --- //
+
+				Prefetcher Ring;
+				StartPrefetch(&Ring, Net, Source, &Cache, DataSize);
+
+				long Batch = 0;
+
+			// --- Start Training --- //
+
+				while(1)
+				{
+					StartTiming();
+
+						// --- Take the next BatchSize Samples of the Epoch --- //
+
+							// Drawn by RequestBatch, before splitting the Batch, so the Samples don't depend on the Threads
+							Args.Chosen = Ring.Slots[Batch % PrefetchBatches].Chosen;
+							Args.Seed = Ring.Slots[Batch % PrefetchBatches].Seed;
+
+							if(Ring.Loaders > 0)
+							{
+								Args.Batch = &(Ring.Slots[Batch % PrefetchBatches]);
+								WaitSlot(Args.Batch, 2 * Batch + 2, &(Ring.Stop));
+							}
+
+						// --- Forward and Backprop, each Thread on its own part of the Batch --- //
+
+							ParallelFor(Net.Workers, Net.BatchSize, TrainTask, &Args);
+
+							// Its Slot is free again, for the Batch PrefetchBatches later
+							RequestBatch(&Ring, Batch + PrefetchBatches);
+
+							++Batch;
+
+						// --- One Weight Update per Batch --- //
+
+							UpdateWeights(Net, Spaces, NSpaces, Args.Rate);
+
+							for(int w = 0; w < NSpaces; ++w)
+							{
+								Error += Spaces[w].Error;
+								Accuracy += Spaces[w].Accuracy;
+
+								Spaces[w].Error = 0;
+								Spaces[w].Accuracy = 0;
+							}
+
+					// 1.2 --- Update Statistics --- //
+
+						Epochs += (Net.BatchSize/(double)DataSize);
+						Error /= (double) Net.BatchSize;
+						Accuracy /= (double) (0.01 * Net.BatchSize);
+
+						if(Error < BestError)
+						{
+							BestError = Error;
+						}
+						if(Accuracy >= BestAccuracy)
+						{
+							BestAccuracy = Accuracy;
+						}
+
+					TotalTime += StopTiming();
+
+					// 1.3 --- Print Statistics to User --- //
+
+					printf("\033[F\33[2K\033[F\33[2K\033[F\33[2K\033[F\33[2K\033[F\33[2K");
+
+					if(Epochs > MaxEpochs)
+					{
+						printf("Max Epochs Reached!\n");
+						break;
+					}
+					if(BestError <= GoalError)
+					{
+						printf("Error reached Goal!\n");
+						break;
+					}
+					if(BestAccuracy >= GoalAccuracy)
+					{
+						printf("Accuracy reached Goal!\n");
+						break;
+					}
+
+					printf("Elapsed Time: %.4f s\n", TotalTime/1000000);
+					printf("Epoch %.2f:\n", Epochs);
+					printf("\tCurrent\t\tBest\n");
+					printf("Err\t%.2f\t\t%.2f\n", Error, BestError);
+					printf("Acc\t%.2f%%\t\t%.2f%%\n", Accuracy, BestAccuracy);
+
+					Error = 0;
+					Accuracy = 0;
+				}
+
+			// --- Free --- //
+
+				StopPrefetch(&Ring);
+
+				for(int w = 0; w < NSpaces; ++w)
+				{
+					FreeWorkspace(Net, &(Spaces[w]), w);
+				}
+
+				free(Spaces);
+
+				FreeFeatureCache(&Cache);
+		}
+
+		/*
+			Train Network on a DataSet of doubles. See TrainCpu
+
+			Net - Network to be used
+			Inputs - Training DataSet. Dimensions need to be {DataSize, InDims}
+			Labels - Labels. Dimensions need to be {DataSize, NClasses}
+			DataSize - How many Inputs the Training DataSet contains
+			MaxEpochs - Maximum Amount of Epochs to run Training for
+			GoalError - Target Error
+			GoalAccuracy - Target Accuracy
+
+			return value - Nothing
+		*/
+
+		void CNNTrainCPU(Network Net, double**** Inputs, double** Labels, int DataSize, int MaxEpochs, double GoalError, double GoalAccuracy)
+		{
+			SampleSource Source = {Inputs, Labels, NULL};
+
+			TrainCpu(Net, &Source, DataSize, MaxEpochs, GoalError, GoalAccuracy);
+		}
+
+		/*
+			Train Network on a DataSet kept as it is stored. Each Chunk of Samples is converted to doubles, with the Scale and Shift of Data,
+			as the Worker Forwarding it gathers it. See TrainCpu
+
+			Net - Network to be used
+			Data - Training DataSet. Images need to match the Network Input, and Classes its Output
+			MaxEpochs - Maximum Amount of Epochs to run Training for
+			GoalError - Target Error
+			GoalAccuracy - Target Accuracy
+
+			return value - Nothing
+		*/
+
+		void CNNTrainCPUData(Network Net, DataBuffer* Data, int MaxEpochs, double GoalError, double GoalAccuracy)
+		{
+			SampleSource Source = DataSource(Net, Data);
+
+			TrainCpu(Net, &Source, Data->Samples, MaxEpochs, GoalError, GoalAccuracy);
+		}
@@ -7,6 +7,11 @@
 		#include <stdio.h>
 		#include <stdlib.h>
 		#include <stdint.h>
+		#include <time.h>
+		#include <sched.h>
+		#include <pthread.h>
+		#include <fcntl.h>
+		#include <sys/mman.h>
 		#include "../../../Libs/CNNLibs.h"
 
 #endif
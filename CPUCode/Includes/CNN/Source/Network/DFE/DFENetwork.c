@@ -24,14 +24,14 @@
 */
 
 // TESTHELPER
-static double*** BlockForwardCpu(Block Block, double*** Input, char* Flag1D)
+static Tensor BlockForwardCpu(Block Block, Tensor* Input)
 {
 	// --- Setup for Computation --- //
 
-		double**** LayerOutputs = malloc(sizeof(double***) * (Block.BlockSize + 1));
+		Tensor* LayerOutputs = malloc(sizeof(Tensor) * (Block.BlockSize + 1));
 
-		LayerOutputs[0] = Init3D(Block.Dims[0]);
-		Copy3D(Input, LayerOutputs[0], Block.Dims[0]);
+		LayerOutputs[0] = *Input;
+		LayerOutputs[0].Owner = 0;
 
 	// --- Go Through each Layer in Block and Compute Output--- //
 
@@ -39,67 +39,43 @@ static double*** BlockForwardCpu(Block Block, double*** Input, char* Flag1D)
 		{
 			// --- Init Output Volume --- //
 
-				LayerOutputs[Layer + 1] = Init3D(Block.Dims[Layer + 1]);
+				LayerOutputs[Layer + 1] = InitTensor(Input->Dims[0], Block.Dims[Layer + 1]);
 
 			// --- Calculate Layer Output --- //
 
 				switch(Block.Layers[Layer])
 				{
 					case Conv:		// Conv
-								ConvForwCpu(LayerOutputs[Layer], Block.Dims[Layer],
-											LayerOutputs[Layer + 1],
-											Block.Weights[Layer], Block.LayerParams[Layer]);
+								ConvForwCpu(&(LayerOutputs[Layer]),
+											&(LayerOutputs[Layer + 1]),
+											&(Block.Weights[Layer]), Block.LayerParams[Layer],
+											&(Block.Caches[Layer]),
+											NULL);
 								break;
 
 					case Pool:		// Pool
-								PoolForwCpu(LayerOutputs[Layer], Block.Dims[Layer],
-											Block.Weights[Layer][0],
-											LayerOutputs[Layer + 1],
-											Block.LayerParams[Layer]);
+								PoolForwCpu(&(LayerOutputs[Layer]),
+											&(Block.Weights[Layer]),
+											&(LayerOutputs[Layer + 1]),
+											Block.LayerParams[Layer],
+											NULL);
 								break;
 
 					case Fcon:		// Fcon
-
-								// Convert Size if Necessary
-								if((*Flag1D) == 0)
-								{
-									int InDim = Block.Dims[Layer][0] * Block.Dims[Layer][1] * Block.Dims[Layer][2];
-
-									double* Aux = Init1D(InDim);
-									ConvertTo1D(LayerOutputs[Layer], Aux, Block.Dims[Layer]);
-
-									FconForwCpu(Aux, Block.Dims[Layer][0] * Block.Dims[Layer][1] * Block.Dims[Layer][2],
-													LayerOutputs[Layer + 1][0][0], Block.Dims[Layer + 1][2],
-													Block.Weights[Layer][0][0], Block.LayerParams[Layer],
-													0);
-
-									Free1D(Aux);
-
-									*Flag1D = 1;
-
-								}
-								else
-								{
-									FconForwCpu(LayerOutputs[Layer][0][0], Block.Dims[Layer][0] * Block.Dims[Layer][1] * Block.Dims[Layer][2],
-												LayerOutputs[Layer + 1][0][0], Block.Dims[Layer + 1][2],
-												Block.Weights[Layer][0][0], Block.LayerParams[Layer],
-												0);
-								}
-
+								FconForwCpu(&(LayerOutputs[Layer]),
+											&(LayerOutputs[Layer + 1]),
+											&(Block.Weights[Layer]), Block.LayerParams[Layer],
+											0, NULL);
 								break;
 				}
 
-				Free3D(LayerOutputs[Layer]);
+				FreeTensor(&(LayerOutputs[Layer]));
 		}
 
-
-		double*** Output = Init3D(Block.Dims[Block.BlockSize]);
-
-		Copy3D(LayerOutputs[Block.BlockSize], Output, Block.Dims[Block.BlockSize]);
+		Tensor Output = LayerOutputs[Block.BlockSize];
 
 	// --- Free --- //
 
-		Free3D(LayerOutputs[Block.BlockSize]);
 		free(LayerOutputs);
 
 	return Output;
@@ -490,7 +466,7 @@ static double*** BlockForwardCpu(Block Block, double*** Input, char* Flag1D)
 													{
 														if((CurrentKernel + Kernel) < Net->Blocks[Block].Dims[Layer + 1][0])
 														{
-															FParams[Block].DFEWeights[CurrentCall][pos[CurrentCall]] = Net->Blocks[Block].Weights[Layer][CurrentKernel + Kernel][Channel][y][x];
+															FParams[Block].DFEWeights[CurrentCall][pos[CurrentCall]] = TensorAt(&(Net->Blocks[Block].Weights[Layer]), CurrentKernel + Kernel, Channel, y, x);
 														}
 														else
 														{
@@ -581,7 +557,7 @@ static double*** BlockForwardCpu(Block Block, double*** Input, char* Flag1D)
 												{
 													if((int)(BurstMult[Layer] * BurstSizeDataType * (FParams[Block].MemControl[CurrentCall][Layer] - 1) + j) < Net->Blocks[Block].Dims[Layer + 1][0] * Net->Blocks[Block].Dims[Layer + 1][1] * Net->Blocks[Block].Dims[Layer + 1][2])
 													{
-														FParams[Block].DFEWeights[CurrentCall][pos[CurrentCall]] = Net->Blocks[Block].Weights[Layer][0][0][(FParams[Block].FirstOutputs[CurrentCall][Layer] * BurstSizeDataType * BurstMult[Layer] + i)][BurstMult[Layer] * BurstSizeDataType * (FParams[Block].MemControl[CurrentCall][Layer] - 1) + j];
+														FParams[Block].DFEWeights[CurrentCall][pos[CurrentCall]] = TensorAt(&(Net->Blocks[Block].Weights[Layer]), 0, 0, BurstMult[Layer] * BurstSizeDataType * (FParams[Block].MemControl[CurrentCall][Layer] - 1) + j, (FParams[Block].FirstOutputs[CurrentCall][Layer] * BurstSizeDataType * BurstMult[Layer] + i));
 													}
 													else
 													{
@@ -916,18 +892,18 @@ static double*** BlockForwardCpu(Block Block, double*** Input, char* Flag1D)
 
 		// Run CPU
 
-			char* aux = malloc(sizeof(char));
-			*aux = 0;
+			Tensor InputView = ViewTensor(Input[0][0], 1, Net.Blocks[0].Dims[0]);
 
 			printf("Running CPU!\n");
 			StartTiming();
-			double*** TestOutput = BlockForwardCpu(Net.Blocks[1], BlockForwardCpu(Net.Blocks[0], Input, aux), aux);
+			Tensor Block0Output = BlockForwardCpu(Net.Blocks[0], &InputView);
+			Tensor TestOutput = BlockForwardCpu(Net.Blocks[1], &Block0Output);
 
 			printf("CPU Finished. Time Taken = %.2f milliseconds\n", StopTiming()/1000);
 
 			double* TestOutput1D = Init1D(OutDims1D);
 
-			ConvertTo1D(TestOutput, TestOutput1D, Net.Blocks[1].Dims[Net.Blocks[1].BlockSize]);
+			Copy1D(TestOutput.Data, TestOutput1D, SampleSize(&TestOutput));
 
 			Print1DMatrix(TestOutput1D, OutDims1D);
 
@@ -936,5 +912,8 @@ static double*** BlockForwardCpu(Block Block, double*** Input, char* Flag1D)
 			double Margin = .5e-2;
 			Compare1D(Output, TestOutput1D, Net.Blocks[1].Dims[Net.Blocks[1].BlockSize][0] * Net.Blocks[1].Dims[Net.Blocks[1].BlockSize][1] * Net.Blocks[1].Dims[Net.Blocks[1].BlockSize][2], Margin);
 
+			FreeTensor(&Block0Output);
+			FreeTensor(&TestOutput);
+
 		return NULL;
 	}
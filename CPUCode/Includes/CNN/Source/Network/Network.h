@@ -24,13 +24,34 @@
 			char* Layers;				// Array Containing Layers
 			int BlockSize;				// Size of Layers and Dims
 
-			double***** Weights;		// Weights for Layers that have them. For pooling Layer this will hold the Mask
+			Tensor* Weights;			// Weights for Layers that have them. For pooling Layer this will hold the Mask, the Position of the Max of every Output
+			ConvCache* Caches;			// Transformed Weights for Conv Layers. Invalidated by every Weight Update
 
 			double** LayerParams;		// Arrays Containing Layer Parameters
 
+			char Frozen;				// 1 if Training leaves the Weights of this Block as they are. Set with FreezeBlock
+
 		} Block;
 
-		// 2.2 --- Network --- //
+		// 2.2 --- Memory Plan --- //
+
+			// Where Classification keeps Layer Outputs. Outputs that are never alive at the same time share a Buffer.
+			// A Conv followed by a Pool Layer is fused, so its Output needs no Buffer
+
+			typedef struct
+			{
+				int** Slots;				// [Block][Layer] Buffer the Layer Output is written to. -1 for the Network Output, written straight to the caller, -2 for the Output of a fused Conv, never stored
+				char** Fused;				// [Block][Layer] 1 for a Conv Layer computed together with the Pool Layer after it, by ConvPoolForwCpu
+				int Blocks;					// Size of Slots
+				size_t* Sizes;				// Doubles per Sample of every Buffer
+				int Buffers;				// Size of Sizes
+
+				size_t Peak;				// Doubles per Sample of all Buffers together
+				size_t Total;				// Doubles per Sample if every Layer Output had its own Buffer
+
+			} MemoryPlan;
+
+		// 2.3 --- Network --- //
 
 			typedef struct
 			{
@@ -43,6 +64,19 @@
 				double Momentum;			// How much previous changes to Weights influence current iteration
 				char EFunc;					// Error function used to calculate error;
 
+				ThreadPool* Workers;		// Threads for the CPU Layers and Training. NULL means single Threaded. Set with SetNumThreads
+				char Hogwild;				// 1 if Training Threads update Fcon Weights without Reduction. Set with SetHogwild
+				int Loaders;				// Background Threads assembling Batches ahead of Training. 0 gathers them in the Training Threads. Set with SetLoaders
+
+				size_t Scratch;				// Doubles of Scratch Arena a Thread needs to Classify. Planned by PlanWorkspace once the Network is built
+				MemoryPlan Plan;			// Buffers of the Layer Outputs while Classifying. Planned with Scratch
+
+				int StopBlock;				// Block of the first Layer with Weights to Train. Errors before it are never read, so Backpropagation stops there
+				int StopLayer;				// Layer of StopBlock Backpropagation stops at, without its Input Error. -1 to Backpropagate the whole Block. Planned with Scratch
+
+				char CacheFeatures;			// 1 to keep the Output of the Frozen Blocks at the start of the Network for every Training Sample. Set with SetFeatureCache
+				char* FeaturePath;			// File the Feature Cache is mapped to, owned by the Network. NULL keeps it in memory
+
 			} Network;
 
 	// 3 --- Error Codes --- //
@@ -62,16 +96,33 @@
 		#define DefMomentum 0.01
 		#define DefEFunc CrossEnt
 
-	// 5 --- Function Prototypes --- //
+	// 5 --- Training --- //
+
+		#define TrainChunk 16			// Samples of a Batch Forwarded and Backpropagated together
+		#define DefCacheFeatures 1		// Frozen Blocks at the start of the Network are Forwarded once per Training Sample
+		#define DefLoaders 1			// Background Threads assembling Batches
+		#define PrefetchBatches 4		// Batches the Loaders assemble ahead of Training
+
+	// 6 --- Classification --- //
+
+		#define ClassifyChunk 64		// Samples ClassifyBatch Forwards together
+
+	// 7 --- Function Prototypes --- //
+
+		// 7.1 --- CPU --- //
 
-		// 5.1 --- CPU --- //
+			void PlanWorkspace(Network* Net);
+			void FreeMemoryPlan(MemoryPlan* Plan);
 
 			int Classify(Network Net, double*** Input);
+			void ClassifyBatch(Network* Net, Tensor* Batch, int* Classes);
 			double CalcTestAccuracy(Network Net, double**** Inputs, double** Labels, int NSamples);
+			double CalcDataAccuracy(Network Net, DataBuffer* Data);
 
 			void CNNTrainCPU(Network Net, double**** Inputs, double** Labels, int DataSize, int MaxEpochs, double GoalError, double GoalAccuracy);
+			void CNNTrainCPUData(Network Net, DataBuffer* Data, int MaxEpochs, double GoalError, double GoalAccuracy);
 
-		// 5.2 --- DFE --- //
+		// 7.2 --- DFE --- //
 
 			void SetLMemFreq(int Freq);
 			void SetDesignFreq(int Freq);
@@ -29,3 +29,156 @@
 
 		printf("DataTest Complete!\n\n");
 	}
+
+// 2 --- Contents --- //
+
+	void DataContentsTest()
+	{
+		printf("Starting DataContentsTest!\n\n");
+		char DataSet = MNIST;
+		double Split = 0.3;
+
+		int DataSize = 70000;
+		int InputSize = 28;
+		int NClasses = 10;
+
+		double**** XTrain;
+		double**** XTest;
+		double** YTrain;
+		double** YTest;
+
+		StartTiming();
+		LoadData(&XTrain, &YTrain, &XTest, &YTest, Split, DataSet);
+		printf("Load Time = %.2f ms\n", StopTiming()/1000);
+
+		// Read the File again one Number at a time, and compare every Value
+		FILE* File = fopen("CPUCode/Includes/CNN/Source/DataSets/MNIST/MNIST.csv", "r");
+
+		int SplitSample = round(DataSize * Split);
+		int Mismatches = 0;
+
+		for(int i = 0; i < DataSize; ++i)
+		{
+			double*** Image = i < SplitSample ? XTest[i] : XTrain[i - SplitSample];
+			double* Label = i < SplitSample ? YTest[i] : YTrain[i - SplitSample];
+
+			int Value;
+			fscanf(File, "%d", &Value);
+
+			for(int k = 0; k < NClasses; ++k)
+			{
+				Mismatches += Label[k] != (k == Value);
+			}
+
+			for(int p = 0; p < InputSize * InputSize; ++p)
+			{
+				fscanf(File, ",%d", &Value);
+				Mismatches += Image[0][p / InputSize][p % InputSize] != Value;
+			}
+		}
+
+		printf("Mismatches = %d\n", Mismatches);
+
+		fclose(File);
+		FreeData(XTrain, YTrain, XTest, YTest, DataSet);
+
+		printf("DataContentsTest Complete!\n\n");
+	}
+
+// 3 --- Cache --- //
+
+	void DataCacheTest()
+	{
+		printf("Starting DataCacheTest!\n\n");
+		char DataSet = MNIST;
+		double Split = 0.3;
+
+		int DataSize = 70000;
+		int Pixels = 28 * 28;
+		int NClasses = 10;
+
+		int SplitSample = round(DataSize * Split);
+
+		double* Images = malloc(sizeof(double) * DataSize * Pixels);
+		double* Labels = malloc(sizeof(double) * DataSize * NClasses);
+
+		// First Load reads the Source and writes the Cache, the second one maps it. Both must give the same Values
+		remove("CPUCode/Includes/CNN/Source/DataSets/MNIST/MNIST.cache");
+
+		int Mismatches = 0;
+
+		for(int Load = 0; Load < 2; ++Load)
+		{
+			double**** XTrain;
+			double**** XTest;
+			double** YTrain;
+			double** YTest;
+
+			StartTiming();
+			LoadData(&XTrain, &YTrain, &XTest, &YTest, Split, DataSet);
+			printf("%s Load Time = %.2f ms\n", Load == 0 ? "Source" : "Cache", StopTiming()/1000);
+
+			for(int i = 0; i < DataSize; ++i)
+			{
+				double* Image = i < SplitSample ? XTest[i][0][0] : XTrain[i - SplitSample][0][0];
+				double* Label = i < SplitSample ? YTest[i] : YTrain[i - SplitSample];
+
+				for(int p = 0; p < Pixels; ++p)
+				{
+					if(Load == 0)
+					{
+						Images[(size_t) i * Pixels + p] = Image[p];
+					}
+
+					Mismatches += Images[(size_t) i * Pixels + p] != Image[p];
+				}
+
+				for(int k = 0; k < NClasses; ++k)
+				{
+					if(Load == 0)
+					{
+						Labels[i * NClasses + k] = Label[k];
+					}
+
+					Mismatches += Labels[i * NClasses + k] != Label[k];
+				}
+			}
+
+			FreeData(XTrain, YTrain, XTest, YTest, DataSet);
+		}
+
+		// Kept as stored, the Cache is only mapped
+		DataBuffer Data;
+
+		StartTiming();
+		LoadDataBuffer(&Data, DataSet);
+		printf("Buffer Load Time = %.2f ms\n", StopTiming()/1000);
+
+		double Values[Pixels];
+		double Label[NClasses];
+
+		for(int i = 0; i < DataSize; ++i)
+		{
+			ConvertSample(&Data, i, Values);
+			ConvertLabel(&Data, i, Label);
+
+			for(int p = 0; p < Pixels; ++p)
+			{
+				Mismatches += Images[(size_t) i * Pixels + p] != Values[p];
+			}
+
+			for(int k = 0; k < NClasses; ++k)
+			{
+				Mismatches += Labels[i * NClasses + k] != Label[k];
+			}
+		}
+
+		FreeDataBuffer(&Data);
+
+		printf("Mismatches = %d\n", Mismatches);
+
+		free(Images);
+		free(Labels);
+
+		printf("DataCacheTest Complete!\n\n");
+	}
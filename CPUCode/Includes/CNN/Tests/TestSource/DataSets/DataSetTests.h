@@ -4,5 +4,7 @@
 	// 2 --- Function Prototypes --- //
 
 		void DataTest();
+		void DataContentsTest();
+		void DataCacheTest();
 
 #endif
\ No newline at end of file
@@ -82,8 +82,8 @@ void ErrorBackwardTest()
 	RandomizeArray1D(Prediction, Dim, RandMin, RandMax);
 	RandomizeArray1D(Truth, Dim, RandMin, RandMax);
 
-	double* Output;
-	Output = ErrorBackward(Prediction, Truth, Dim, EFunc);
+	double* Output = Init1D(Dim);
+	ErrorBackward(Prediction, Truth, Output, Dim, EFunc);
 
 	if(Debug)
 	{
@@ -111,4 +111,121 @@ void ErrorBackwardTest()
 
 	printf("\nError Backward Test Complete!\n");
 }
-		
+
+
+void SoftmaxErrorTest()
+{
+	printf("\nStarting Softmax Error Test\n");
+
+	int Samples = 4;
+	int Dim = 10;
+	int Dims[3] = {1, 1, Dim};
+
+	double Margin = 1e-10;
+	double Step = 1e-6;
+
+	char EFuncs[2] = {CrossEnt, MSE};
+	char* Names[2] = {"CrossEnt", "MSE"};
+
+	Tensor Logits = InitTensor(Samples, Dims);
+	Tensor Output = InitTensor(Samples, Dims);
+	Tensor Gradient = InitTensor(Samples, Dims);
+	Tensor Reference = InitTensor(Samples, Dims);
+	Tensor Numerical = InitTensor(Samples, Dims);
+
+	// One hot Labels
+	double* Truth[4];
+	for(int sample = 0; sample < Samples; ++sample)
+	{
+		Truth[sample] = Init1D(Dim);
+		memset(Truth[sample], 0, Dim * sizeof(double));
+		Truth[sample][(int) GenerateRand(0, Dim - 1)] = 1;
+	}
+
+	RandomizeTensor(&Logits, -5, 5);
+
+	for(int e = 0; e < 2; ++e)
+	{
+		// --- Fused --- //
+
+			Copy1D(Logits.Data, Output.Data, TensorSize(&Logits));
+			double Error = SoftmaxError(&Output, Truth, &Gradient, EFuncs[e]);
+
+		// --- Softmax, then ErrorForward and ErrorBackward --- //
+
+			double ReferenceError = 0;
+
+			for(int sample = 0; sample < Samples; ++sample)
+			{
+				double* Prediction = Reference.Data + sample * Reference.Strides[0];
+
+				Copy1D(Logits.Data + sample * Logits.Strides[0], Prediction, Dim);
+				SoftmaxRow(Prediction, Dim);
+
+				ReferenceError += ErrorForward(Prediction, Truth[sample], Dim, EFuncs[e]);
+				ErrorBackward(Prediction, Truth[sample], Numerical.Data + sample * Numerical.Strides[0], Dim, EFuncs[e]);
+			}
+
+			printf("%s: Error %.12f, Reference %.12f\n\tPrediction: ", Names[e], Error, ReferenceError);
+			CompareTensor(&Reference, &Output, Margin);
+
+			printf("\tErrorBackward: ");
+			CompareTensor(&Numerical, &Gradient, Margin);
+
+		// --- Central Differences of the Error, with respect to every Logit --- //
+
+			for(int sample = 0; sample < Samples; ++sample)
+			{
+				for(int i = 0; i < Dim; ++i)
+				{
+					double Sides[2];
+
+					for(int side = 0; side < 2; ++side)
+					{
+						int OneDims[3] = {1, 1, Dim};
+						Tensor One = InitTensor(1, OneDims);
+						Tensor OneGradient = InitTensor(1, OneDims);
+
+						Copy1D(Logits.Data + sample * Logits.Strides[0], One.Data, Dim);
+						One.Data[i] += side == 0 ? Step : -Step;
+
+						Sides[side] = SoftmaxError(&One, &Truth[sample], &OneGradient, EFuncs[e]);
+
+						FreeTensor(&One);
+						FreeTensor(&OneGradient);
+					}
+
+					TensorAt(&Numerical, sample, 0, 0, i) = (Sides[0] - Sides[1]) / (2 * Step);
+				}
+			}
+
+			printf("\tNumerical Gradient: ");
+			CompareTensor(&Numerical, &Gradient, 1e-6);
+	}
+
+	// --- Logits big enough to overflow exp. Cross Entropy stays finite --- //
+
+		for(int i = 0; i < Dim; ++i)
+		{
+			Output.Data[i] = i == 0 ? 1000 : -1000;
+		}
+
+		Output.Dims[0] = 1;
+
+		double Error = SoftmaxError(&Output, Truth, &Gradient, CrossEnt);
+
+		printf("Big Logits: Error %.4f (Expected %.4f)\n", Error, Truth[0][0] == 1 ? 0.0 : 2000.0);
+
+	for(int sample = 0; sample < Samples; ++sample)
+	{
+		Free1D(Truth[sample]);
+	}
+
+	FreeTensor(&Logits);
+	FreeTensor(&Output);
+	FreeTensor(&Gradient);
+	FreeTensor(&Reference);
+	FreeTensor(&Numerical);
+
+	printf("\nSoftmax Error Test Complete!\n");
+}
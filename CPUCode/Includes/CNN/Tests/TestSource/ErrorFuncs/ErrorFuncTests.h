@@ -5,5 +5,6 @@
 		
 		void ErrorForwardTest();
 		void ErrorBackwardTest();
+		void SoftmaxErrorTest();
 		
 #endif
\ No newline at end of file
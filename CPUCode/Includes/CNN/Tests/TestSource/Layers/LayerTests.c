@@ -56,17 +56,16 @@
 					}
 				}
 
-				double**** Filters = malloc(sizeof(double***) * NKernels);
+				Tensor Filters = InitTensor(NKernels, FiltDims);
 				for(int i = 0; i < NKernels; ++i)
 				{
-					Filters[i] = Init3D(FiltDims);
 					for(int j = 0; j < FiltDims[0]; ++j)
 					{
 						for(int k = 0; k < FiltDims[1]; ++k)
 						{
 							for(int l = 0; l < FiltDims[2]; ++l)
 							{
-								fscanf(WeightFile, "%lf", &Filters[i][j][k][l]);
+								fscanf(WeightFile, "%lf", &TensorAt(&Filters, i, j, k, l));
 							}
 						}
 					}
@@ -86,7 +85,10 @@
 
 				double*** Output = Init3D(OutDims);
 
-				ConvForwCpu(Input, InDims, Output, Filters, Params);
+				Tensor InputView = ViewTensor(Input[0][0], 1, InDims);
+				Tensor OutputView = ViewTensor(Output[0][0], 1, OutDims);
+
+				ConvForwCpu(&InputView, &OutputView, &Filters, Params, NULL, NULL);
 					
 				if(Debug)
 				{
@@ -95,10 +97,7 @@
 					Print3DMatrix(Input, InDims);
 
 					printf("Filters:\n");
-					for(int i = 0; i < NKernels; ++i)
-					{
-						Print3DMatrix(Filters[i], FiltDims);
-					}
+					PrintTensor(&Filters);
 
 					printf("Output:\n");
 					Print3DMatrix(Output, OutDims);
@@ -108,13 +107,7 @@
 				Compare3D(Output, TestOutput, OutDims, Margin);
 
 				Free3D(Input);
-
-				for(int i = 0; i < NKernels; ++i)
-				{
-					Free3D(Filters[i]);
-				}
-				free(Filters);
-
+				FreeTensor(&Filters);
 				Free3D(Output);
 				Free3D(TestOutput);
 
@@ -131,7 +124,7 @@
 				int NKernels = 5;
 				char KernelSize = 3, Stride = 2, Padding = 1;
 
-				double LearningRate = 0.01;
+				double Margin = 1e-9;
 
 				int NChannels = 3, InDim = 5;
 
@@ -161,16 +154,50 @@
 				FiltDims[1] = (int) KernelSize;
 				FiltDims[2] = FiltDims[1];
 
-				double**** Filters = malloc(sizeof(double***) * NKernels);		// Kernel Weights
-				for(int i = 0; i < NKernels; ++i)
-				{
-					Filters[i] = Init3D(FiltDims);
-					RandomizeArray3D(Filters[i], FiltDims, 0, 3);
-				}
+				Tensor Filters = InitTensor(NKernels, FiltDims);				// Kernel Weights
+				RandomizeTensor(&Filters, 0, 3);
+
+				Tensor Gradients = InitTensor(NKernels, FiltDims);				// Weight Gradients
 
 				double Params[5] = {Act, NKernels, KernelSize, Stride, Padding};
 
-				ConvBackCpu(PrevInput, InDims, PrevOutput, OutDims, Error, Output, Filters, Params, LearningRate);
+				Tensor PrevInputView = ViewTensor(PrevInput[0][0], 1, InDims);
+				Tensor PrevOutputView = ViewTensor(PrevOutput[0][0], 1, OutDims);
+				Tensor ErrorView = ViewTensor(Error[0][0], 1, OutDims);
+				Tensor OutputView = ViewTensor(Output[0][0], 1, InDims);
+
+				ConvBackCpu(&PrevInputView, &PrevOutputView, &ErrorView, &OutputView, &Filters, Params, NULL, &Gradients);
+
+				// Reference Weight Gradients. Gradient[k][c][y][x] sums Delta[k] times every Input Pixel Weight[k][c][y][x] was multiplied with
+				Tensor TestGradients = InitTensor(NKernels, FiltDims);
+
+				for(int k = 0; k < NKernels; ++k)
+				{
+					for(int c = 0; c < NChannels; ++c)
+					{
+						for(int y = 0; y < KernelSize; ++y)
+						{
+							for(int x = 0; x < KernelSize; ++x)
+							{
+								for(int outy = 0; outy < OutDims[1]; ++outy)
+								{
+									for(int outx = 0; outx < OutDims[2]; ++outx)
+									{
+										int iny = outy * Stride + y - Padding;
+										int inx = outx * Stride + x - Padding;
+
+										if(iny >= 0 && iny < InDim && inx >= 0 && inx < InDim && PrevOutput[k][outy][outx] > 0)
+										{
+											TensorAt(&TestGradients, k, c, y, x) += Error[k][outy][outx] * PrevInput[c][iny][inx];
+										}
+									}
+								}
+							}
+						}
+					}
+				}
+
+				CompareTensor(&Gradients, &TestGradients, Margin);
 
 				if(Debug)
 				{
@@ -202,26 +229,194 @@
 					Print3DMatrix(Output, InDims);
 
 					printf("Filters:\n\n");
-					for(int i = 0; i < NKernels; ++i)
-					{
-						printf("Filter %d\n", i+1);
-						Print3DMatrix(Filters[i], FiltDims);
-					}
+					PrintTensor(&Filters);
 
+					printf("Gradients:\n\n");
+					PrintTensor(&Gradients);
 				}
 
 				Free3D(PrevInput);
 				Free3D(PrevOutput);
 				Free3D(Error);
 				Free3D(Output);
+				FreeTensor(&Filters);
+				FreeTensor(&Gradients);
+				FreeTensor(&TestGradients);
 
-				for(int i = 0; i < NKernels; ++i)
+				printf("Conv Back Test Done!\n");
+			}
+
+		// 1.1.3 --- Algorithms --- //
+
+			void ConvAlgorithmTest()
+			{
+				printf("Starting Conv Algorithm Test\n\n");
+
+				double RandMin = -1;
+				double RandMax = 1;
+
+				double Margin = 1e-9;
+
+				// {Channels, InDim, NKernels, KernelSize, Stride, Padding, Samples}. Odd shapes first, in Batches so Gemm lowers Samples together,
+				// then AlexNet and VGG16 layers
+				int Shapes[][7] = {{3, 7, 5, 3, 2, 1, 5},
+								   {2, 9, 4, 2, 1, 0, 3},
+								   {6, 12, 10, 5, 1, 0, 40},
+								   {3, 227, 96, 11, 4, 0, 1},
+								   {96, 27, 256, 5, 1, 2, 1},
+								   {256, 13, 384, 3, 1, 1, 1},
+								   {64, 112, 128, 3, 1, 1, 1},
+								   {256, 28, 512, 3, 1, 1, 1}};
+				int NShapes = sizeof(Shapes) / sizeof(Shapes[0]);
+
+				char Algorithms[4] = {ConvDirect, ConvGemm, ConvWinograd, ConvFFT};
+				char* Names[4] = {"Direct", "Gemm", "Winograd", "FFT"};
+
+				for(int i = 0; i < NShapes; ++i)
 				{
-					Free3D(Filters[i]);
+					int InDims[3] = {Shapes[i][0], Shapes[i][1], Shapes[i][1]};
+					int FiltDims[3] = {Shapes[i][0], Shapes[i][3], Shapes[i][3]};
+
+					int OutDim = 1 + ((Shapes[i][1] - Shapes[i][3] + 2 * Shapes[i][5]) / Shapes[i][4]);
+					int OutDims[3] = {Shapes[i][2], OutDim, OutDim};
+
+					double Params[5] = {ReLu, Shapes[i][2], Shapes[i][3], Shapes[i][4], Shapes[i][5]};
+
+					Tensor Input = InitTensor(Shapes[i][6], InDims);
+					Tensor Filters = InitTensor(Shapes[i][2], FiltDims);
+					RandomizeTensor(&Input, RandMin, RandMax);
+					RandomizeTensor(&Filters, RandMin, RandMax);
+
+					Tensor Outputs[4];
+
+					printf("Samples = %d, In = %dx%dx%d, NKernels = %d, KernelSize = %d, Stride = %d, Padding = %d\n", Shapes[i][6], InDims[0], InDims[1], InDims[2], Shapes[i][2], Shapes[i][3], Shapes[i][4], Shapes[i][5]);
+
+					for(int j = 0; j < 4; ++j)
+					{
+						Outputs[j] = InitTensor(Shapes[i][6], OutDims);
+
+						SetConvAlgorithm(Algorithms[j]);
+
+						StartTiming();
+						ConvForwCpu(&Input, &(Outputs[j]), &Filters, Params, NULL, NULL);
+						printf("\t%s: %.2f ms\n", Names[j], StopTiming()/1000);
+					}
+
+					for(int j = 1; j < 4; ++j)
+					{
+						CompareTensor(&(Outputs[0]), &(Outputs[j]), Margin);
+					}
+
+					FreeTensor(&Input);
+					FreeTensor(&Filters);
+					for(int j = 0; j < 4; ++j)
+					{
+						FreeTensor(&(Outputs[j]));
+					}
 				}
-				free(Filters);
 
-				printf("Conv Back Test Done!\n");
+				SetConvAlgorithm(ConvAuto);
+
+				printf("Conv Algorithm Test Complete\n\n");
+			}
+
+		// 1.1.4 --- Backward Algorithms --- //
+
+			void ConvBackAlgorithmTest()
+			{
+				printf("Starting Conv Back Algorithm Test\n\n");
+
+				double RandMin = -1;
+				double RandMax = 1;
+
+				double Margin = 1e-9;
+
+				// Input and Weight Gradients of a Batch are compared against the Direct Loop
+				int Samples = 3;
+
+				// {Channels, InDim, NKernels, KernelSize, Stride, Padding}. Strided Layers only use Winograd when Stride is 1
+				int Shapes[][6] = {{5, 6, 4, 3, 1, 0},
+								   {3, 11, 8, 3, 1, 1},
+								   {4, 9, 16, 3, 1, 2},
+								   {8, 15, 8, 3, 2, 1},
+								   {6, 12, 10, 5, 1, 0},
+								   {3, 31, 16, 11, 4, 0},
+								   {64, 56, 64, 3, 1, 1},
+								   {96, 27, 256, 5, 1, 2},
+								   {256, 28, 512, 3, 1, 1}};
+				int NShapes = sizeof(Shapes) / sizeof(Shapes[0]);
+
+				char Algorithms[4] = {ConvDirect, ConvGemm, ConvWinograd, ConvFFT};
+				char* Names[4] = {"Direct", "Gemm", "Winograd", "FFT"};
+
+				for(int i = 0; i < NShapes; ++i)
+				{
+					int InDims[3] = {Shapes[i][0], Shapes[i][1], Shapes[i][1]};
+					int FiltDims[3] = {Shapes[i][0], Shapes[i][3], Shapes[i][3]};
+
+					int OutDim = 1 + ((Shapes[i][1] - Shapes[i][3] + 2 * Shapes[i][5]) / Shapes[i][4]);
+					int OutDims[3] = {Shapes[i][2], OutDim, OutDim};
+
+					double Params[5] = {ReLu, Shapes[i][2], Shapes[i][3], Shapes[i][4], Shapes[i][5]};
+
+					Tensor PrevInput = InitTensor(Samples, InDims);
+					Tensor PrevOutput = InitTensor(Samples, OutDims);
+					Tensor Error = InitTensor(Samples, OutDims);
+					Tensor Filters = InitTensor(Shapes[i][2], FiltDims);
+					RandomizeTensor(&PrevInput, RandMin, RandMax);
+					RandomizeTensor(&PrevOutput, RandMin, RandMax);
+					RandomizeTensor(&Error, RandMin, RandMax);
+					RandomizeTensor(&Filters, RandMin, RandMax);
+
+					Tensor Outputs[4];
+					Tensor Gradients[4];
+
+					printf("In = %dx%dx%dx%d, NKernels = %d, KernelSize = %d, Stride = %d, Padding = %d\n", Samples, InDims[0], InDims[1], InDims[2], Shapes[i][2], Shapes[i][3], Shapes[i][4], Shapes[i][5]);
+
+					for(int j = 0; j < 4; ++j)
+					{
+						Outputs[j] = InitTensor(Samples, InDims);
+						Gradients[j] = InitTensor(Shapes[i][2], FiltDims);
+
+						SetConvAlgorithm(Algorithms[j]);
+
+						StartTiming();
+						ConvBackCpu(&PrevInput, &PrevOutput, &Error, &(Outputs[j]), &Filters, Params, NULL, &(Gradients[j]));
+						printf("\t%s: %.2f ms\n", Names[j], StopTiming()/1000);
+					}
+
+					for(int j = 1; j < 4; ++j)
+					{
+						CompareTensor(&(Outputs[0]), &(Outputs[j]), Margin);
+						CompareTensor(&(Gradients[0]), &(Gradients[j]), Margin);
+					}
+
+					// Weight Gradients only, as for the first Layer of a Network
+					Tensor WeightsOnly = InitTensor(Shapes[i][2], FiltDims);
+
+					SetConvAlgorithm(ConvAuto);
+
+					StartTiming();
+					ConvBackCpu(&PrevInput, &PrevOutput, &Error, NULL, &Filters, Params, NULL, &WeightsOnly);
+					printf("\tWeights Only: %.2f ms\n", StopTiming()/1000);
+
+					CompareTensor(&(Gradients[0]), &WeightsOnly, Margin);
+					FreeTensor(&WeightsOnly);
+
+					FreeTensor(&PrevInput);
+					FreeTensor(&PrevOutput);
+					FreeTensor(&Error);
+					FreeTensor(&Filters);
+					for(int j = 0; j < 4; ++j)
+					{
+						FreeTensor(&(Outputs[j]));
+						FreeTensor(&(Gradients[j]));
+					}
+				}
+
+				SetConvAlgorithm(ConvAuto);
+
+				printf("Conv Back Algorithm Test Complete\n\n");
 			}
 
 	// 1.2 --- Fcon --- //
@@ -251,13 +446,14 @@
 					fscanf(InputDataFile, "%lf", &Input[i]);
 				}
 
-				double** Weights = malloc(sizeof(double*) * InDim);
+				// The File lists Weights Input by Input. Row j of Weights holds the Weights of Output j
+				int WeightDims[3] = {1, OutDim, InDim};
+				Tensor Weights = InitTensor(1, WeightDims);
 				for(int i = 0; i < InDim; ++i)
 				{
-					Weights[i] = Init1D(OutDim);
 					for(int j = 0; j < OutDim; ++j)
 					{
-						fscanf(WeightFile, "%lf", &Weights[i][j]);
+						fscanf(WeightFile, "%lf", &TensorAt(&Weights, 0, 0, j, i));
 					}
 				}
 
@@ -269,7 +465,13 @@
 
 				double* Output = Init1D(OutDim);
 
-				FconForwCpu(Input, InDim, Output, OutDim, Weights, Params, 1);
+				int InDims[3] = {1, 1, InDim};
+				int OutDims[3] = {1, 1, OutDim};
+
+				Tensor InputView = ViewTensor(Input, 1, InDims);
+				Tensor OutputView = ViewTensor(Output, 1, OutDims);
+
+				FconForwCpu(&InputView, &OutputView, &Weights, Params, 1, NULL);
 
 				if(Debug)
 				{
@@ -295,10 +497,10 @@
 					Print1DMatrix(Output, OutDim);
 
 					printf("Weights:\n");
-					for(int i = 0; i < InDim; ++i)
+					for(int j = 0; j < OutDim; ++j)
 					{
-						printf("Input %d:\n", i+1);
-						Print1DMatrix(Weights[i], OutDim);
+						printf("Output %d:\n", j+1);
+						Print1DMatrix(TensorRow(&Weights, 0, 0, j), InDim);
 					}
 				}
 
@@ -306,12 +508,7 @@
 
 				Free1D(Input);
 				Free1D(Output);
-
-				for(int i = 0; i < InDim; ++i)
-				{
-					Free1D(Weights[i]);
-				}
-				free(Weights);
+				FreeTensor(&Weights);
 
 				printf("Fcon Test Complete\n\n");
 			}
@@ -325,7 +522,8 @@
 				char Act = ReLu, Outputs = 4;
 				double DropP = 0;
 				int InDim = 16, OutDim = 32;
-				double LearningRate = 0.01;
+
+				double Margin = 1e-9;
 
 				double* PrevInput = Init1D(InDim);
 				RandomizeArray1D(PrevInput, InDim, 0, 1);
@@ -338,16 +536,39 @@
 
 				double* Output = Init1D(InDim);
 
-				double** Weights = malloc(sizeof(double*) * InDim);
-				for(int i = 0; i < InDim; ++i)
-				{
-					Weights[i] = Init1D(OutDim);
-					RandomizeArray1D(Weights[i], OutDim, 0, 5);
-				}
+				int WeightDims[3] = {1, OutDim, InDim};
+				Tensor Weights = InitTensor(1, WeightDims);
+				RandomizeTensor(&Weights, 0, 5);
+
+				Tensor Gradients = InitTensor(1, WeightDims);
 
 				double Params[3] = {Act, DropP, Outputs};
 
-				FconBackCpu(PrevInput, InDim, PrevOutput, OutDim, Error, Output, Weights, Params, LearningRate);
+				int InDims[3] = {1, 1, InDim};
+				int OutDims[3] = {1, 1, OutDim};
+
+				Tensor PrevInputView = ViewTensor(PrevInput, 1, InDims);
+				Tensor PrevOutputView = ViewTensor(PrevOutput, 1, OutDims);
+				Tensor ErrorView = ViewTensor(Error, 1, OutDims);
+				Tensor OutputView = ViewTensor(Output, 1, InDims);
+
+				FconBackCpu(&PrevInputView, &PrevOutputView, &ErrorView, &OutputView, &Weights, Params, &Gradients);
+
+				// --- Reference, one Weight at a time --- //
+
+					double* TestOutput = Init1D(InDim);
+					double* TestGradients = Init1D(OutDim * InDim);
+
+					for(int j = 0; j < OutDim; ++j)
+					{
+						double Delta = PrevOutput[j] > 0 ? Error[j] : 0;
+
+						for(int i = 0; i < InDim; ++i)
+						{
+							TestOutput[i] += Delta * TensorAt(&Weights, 0, 0, j, i);
+							TestGradients[j * InDim + i] = Delta * PrevInput[i];
+						}
+					}
 
 				if(Debug)
 				{
@@ -379,22 +600,31 @@
 					Print1DMatrix(Output, InDim);
 
 					printf("Weights:\n");
-					for(int i = 0; i < InDim; ++i)
+					for(int j = 0; j < OutDim; ++j)
+					{
+						printf("Output %d:\n", j+1);
+						Print1DMatrix(TensorRow(&Weights, 0, 0, j), InDim);
+					}
+
+					printf("Gradients:\n");
+					for(int j = 0; j < OutDim; ++j)
 					{
-						printf("Input %d:\n", i+1);
-						Print1DMatrix(Weights[i], OutDim);
+						printf("Output %d:\n", j+1);
+						Print1DMatrix(TensorRow(&Gradients, 0, 0, j), InDim);
 					}
 				}
 
+				Compare1D(Output, TestOutput, InDim, Margin);
+				Compare1D(Gradients.Data, TestGradients, OutDim * InDim, Margin);
+
 				Free1D(PrevInput);
 				Free1D(PrevOutput);
 				Free1D(Error);
 				Free1D(Output);
-				for(int i = 0; i < InDim; ++i)
-				{
-					Free1D(Weights[i]);
-				}
-				free(Weights);
+				Free1D(TestOutput);
+				Free1D(TestGradients);
+				FreeTensor(&Weights);
+				FreeTensor(&Gradients);
 
 				printf("Fcon Backward Test Complete\n\n");
 			}
@@ -453,11 +683,16 @@
 					}
 				}
 
-				double*** Mask = Init3D(InDims);							// Mask ( only needed for training)
+				int MaskDims[3];
+				PoolMaskDims(InDims, Params, MaskDims);
+				Tensor Mask = InitTensor(1, MaskDims);						// Max Positions ( only needed for training)
 
 				double*** Output = Init3D(OutDims);							// Output
 
-				PoolForwCpu(Input, InDims, Mask, Output, Params);
+				Tensor InputView = ViewTensor(Input[0][0], 1, InDims);
+				Tensor OutputView = ViewTensor(Output[0][0], 1, OutDims);
+
+				PoolForwCpu(&InputView, &Mask, &OutputView, Params, NULL);
 
 
 				if(Debug)
@@ -488,8 +723,11 @@
 					printf("Input:\n");
 					Print3DMatrix(Input, InDims);
 
-					printf("Mask:\n");
-					Print3DMatrix(Mask, InDims);
+					printf("Max Positions:\n");
+					for(int i = 0; i < OutDims[0] * OutDims[1] * OutDims[2]; ++i)
+					{
+						printf("%d%c", PoolArgmax(&Mask, 0)[i], (i + 1) % OutDims[2] == 0 ? '\n' : ' ');
+					}
 
 					printf("Output:\n");
 					Print3DMatrix(Output, OutDims);
@@ -498,7 +736,7 @@
 				Compare3D(Output, TestOutput, OutDims, Margin);
 				
 				Free3D(Input);
-				Free3D(Mask);
+				FreeTensor(&Mask);
 				Free3D(Output);
 				Free3D(TestOutput);
 				
@@ -534,7 +772,14 @@
 				double*** Error = Init3D(OutDims);
 				RandomizeArray3D(Error, OutDims, 0, 3);
 
-				double*** Mask = Init3D(InDims);
+				double Margin = 1e-12;
+
+				// Random Max in every Window. The whole Error of a Window has to end up there
+				int MaskDims[3];
+				PoolMaskDims(InDims, Params, MaskDims);
+				Tensor Mask = InitTensor(1, MaskDims);
+
+				double*** TestOutput = Init3D(InDims);
 				for(int channel = 0; channel < OutDims[0]; channel++)
 				{
 					for(int i = 0; i < OutDims[1]; i++)
@@ -544,14 +789,20 @@
 							int y = round(GenerateRand(0, WindowSize - 1));
 							int x = round(GenerateRand(0, WindowSize - 1));
 
-							Mask[channel][(i * WindowSize) + y][(j * WindowSize) + x] = 1;
+							PoolArgmax(&Mask, 0)[(channel * OutDims[1] + i) * OutDims[2] + j] = ((i * Stride) + y) * InDims[2] + (j * Stride) + x;
+
+							TestOutput[channel][(i * Stride) + y][(j * Stride) + x] = (1 - pow(PrevOutput[channel][i][j], 2)) * Error[channel][i][j];
 						}
 					}
 				}
 
 				double*** Output = Init3D(InDims);
 				
-				PoolBackCpu(PrevOutput, OutDims, Error, Mask, Output, Params);
+				Tensor PrevOutputView = ViewTensor(PrevOutput[0][0], 1, OutDims);
+				Tensor ErrorView = ViewTensor(Error[0][0], 1, OutDims);
+				Tensor OutputView = ViewTensor(Output[0][0], 1, InDims);
+
+				PoolBackCpu(&PrevOutputView, &ErrorView, &Mask, &OutputView, Params);
 
 				if(Debug)
 				{
@@ -584,17 +835,403 @@
 					printf("Error:\n");
 					Print3DMatrix(Error, OutDims);
 
-					printf("Mask:\n");
-					Print3DMatrix(Mask, InDims);
-
 					printf("Output:\n");
 					Print3DMatrix(Output, InDims);
 				}
+
+				Compare3D(Output, TestOutput, InDims, Margin);
 				
 				Free3D(PrevOutput);
 				Free3D(Error);
-				Free3D(Mask);
+				FreeTensor(&Mask);
 				Free3D(Output);
+				Free3D(TestOutput);
 
 				printf("Pool Backward Test Complete\n\n");
 			}
+
+		// 1.3.3 --- Fused Conv --- //
+
+			void ConvPoolTest()
+			{
+				printf("Starting Conv Pool Test\n\n");
+
+				double RandMin = -1;
+				double RandMax = 1;
+
+				double Margin = 0;
+
+				// {Channels, InDim, NKernels, KernelSize, Stride, Padding, WindowSize, PoolStride, Samples}. Small Samples Pooled in groups,
+				// overlapping Windows, then Samples big enough to be split in Bands
+				int Shapes[][9] = {{3, 28, 32, 3, 1, 0, 2, 2, 5},
+								   {2, 11, 4, 3, 1, 1, 3, 2, 3},
+								   {3, 15, 8, 3, 2, 1, 2, 1, 4},
+								   {16, 64, 32, 3, 1, 1, 2, 2, 2},
+								   {64, 56, 64, 3, 1, 1, 2, 2, 1}};
+				int NShapes = sizeof(Shapes) / sizeof(Shapes[0]);
+
+				char Algorithms[4] = {ConvDirect, ConvGemm, ConvWinograd, ConvFFT};
+				char* Names[4] = {"Direct", "Gemm", "Winograd", "FFT"};
+
+				char Types[2] = {MaxPool, MeanPool};
+
+				ThreadPool* Workers = CreateThreadPool(4);
+
+				for(int i = 0; i < NShapes; ++i)
+				{
+					int Samples = Shapes[i][8];
+
+					int InDims[3] = {Shapes[i][0], Shapes[i][1], Shapes[i][1]};
+					int FiltDims[3] = {Shapes[i][0], Shapes[i][3], Shapes[i][3]};
+
+					int ConvDim = 1 + ((Shapes[i][1] - Shapes[i][3] + 2 * Shapes[i][5]) / Shapes[i][4]);
+					int ConvDims[3] = {Shapes[i][2], ConvDim, ConvDim};
+
+					int PoolDim = 1 + ((ConvDim - Shapes[i][6]) / Shapes[i][7]);
+					int PoolDims[3] = {Shapes[i][2], PoolDim, PoolDim};
+
+					double ConvParams[5] = {Sigmoid, Shapes[i][2], Shapes[i][3], Shapes[i][4], Shapes[i][5]};
+
+					Tensor Input = InitTensor(Samples, InDims);
+					Tensor Filters = InitTensor(Shapes[i][2], FiltDims);
+					RandomizeTensor(&Input, RandMin, RandMax);
+					RandomizeTensor(&Filters, RandMin, RandMax);
+
+					Tensor ConvOutput = InitTensor(Samples, ConvDims);
+					Tensor Reference = InitTensor(Samples, PoolDims);
+					Tensor Output = InitTensor(Samples, PoolDims);
+
+					printf("Samples = %d, In = %dx%dx%d, NKernels = %d, KernelSize = %d, Stride = %d, Padding = %d, WindowSize = %d, PoolStride = %d\n",
+						   Samples, InDims[0], InDims[1], InDims[2], Shapes[i][2], Shapes[i][3], Shapes[i][4], Shapes[i][5], Shapes[i][6], Shapes[i][7]);
+
+					for(int t = 0; t < 2; ++t)
+					{
+						double PoolParams[4] = {ReLu, Shapes[i][6], Types[t], Shapes[i][7]};
+
+						int MaskDims[3];
+						PoolMaskDims(ConvDims, PoolParams, MaskDims);
+
+						Tensor Mask = InitTensor(Samples, MaskDims);
+						Tensor Argmax = InitTensor(Samples, MaskDims);
+
+						for(int j = 0; j < 4; ++j)
+						{
+							SetConvAlgorithm(Algorithms[j]);
+
+							// --- Conv then Pool --- //
+
+								StartTiming();
+
+								ConvForwCpu(&Input, &ConvOutput, &Filters, ConvParams, NULL, Workers);
+								PoolForwCpu(&ConvOutput, &Mask, &Reference, PoolParams, Workers);
+
+								double Separate = StopTiming()/1000;
+
+							// --- Fused --- //
+
+								StartTiming();
+
+								ConvPoolForwCpu(&Input, &Output, &Filters, ConvParams, PoolParams, &Argmax, NULL, Workers);
+
+								double Fused = StopTiming()/1000;
+
+							printf("\t%s, %s: Separate %.2f ms, Fused %.2f ms\n\t", Types[t] == MaxPool ? "MaxPool" : "MeanPool", Names[j], Separate, Fused);
+
+							CompareTensor(&Reference, &Output, Margin);
+
+							// Every Max has to be where PoolForwCpu has it
+							if(Types[t] == MaxPool)
+							{
+								int Mismatches = 0;
+
+								for(int sample = 0; sample < Samples; ++sample)
+								{
+									for(int p = 0; p < PoolDims[0] * PoolDim * PoolDim; ++p)
+									{
+										if(PoolArgmax(&Mask, sample)[p] != PoolArgmax(&Argmax, sample)[p])
+										{
+											++Mismatches;
+										}
+									}
+								}
+
+								printf("\tArgmax Mismatches = %d\n", Mismatches);
+							}
+						}
+
+						FreeTensor(&Mask);
+						FreeTensor(&Argmax);
+					}
+
+					FreeTensor(&Input);
+					FreeTensor(&Filters);
+					FreeTensor(&ConvOutput);
+					FreeTensor(&Reference);
+					FreeTensor(&Output);
+				}
+
+				FreeThreadPool(Workers);
+				SetConvAlgorithm(ConvAuto);
+
+				printf("Conv Pool Test Complete\n\n");
+			}
+
+		// 1.3.4 --- Shapes --- //
+
+			void PoolShapesTest()
+			{
+				printf("Starting Pool Shapes Test\n\n");
+
+				double Margin = 0;
+
+				// {Channels, InDim, WindowSize, Stride, Samples}. 2x2 and 3x3 Windows with Stride 2, as in VGG and AlexNet,
+				// overlapping Stride 1 Windows, and a Stride the Kernels don't handle. Odd Widths leave Outputs for PoolWindow
+				int Shapes[][5] = {{4, 28, 2, 2, 3},
+								   {3, 55, 3, 2, 2},
+								   {2, 13, 3, 2, 3},
+								   {3, 17, 2, 1, 2},
+								   {2, 15, 3, 3, 2}};
+				int NShapes = sizeof(Shapes) / sizeof(Shapes[0]);
+
+				char Types[2] = {MaxPool, MeanPool};
+
+				for(int i = 0; i < NShapes; ++i)
+				{
+					int Samples = Shapes[i][4];
+					int WindowSize = Shapes[i][2], Stride = Shapes[i][3];
+
+					int InDims[3] = {Shapes[i][0], Shapes[i][1], Shapes[i][1]};
+
+					int OutDim = 1 + ((Shapes[i][1] - WindowSize) / Stride);
+					int OutDims[3] = {Shapes[i][0], OutDim, OutDim};
+
+					Tensor Input = InitTensor(Samples, InDims);
+					RandomizeTensor(&Input, -1, 1);
+
+					// Repeat some Values, so Max Pool has ties to break
+					for(size_t p = 0; p + 1 < (size_t) Samples * Input.Strides[0]; p += 7)
+					{
+						Input.Data[p] = Input.Data[p + 1];
+					}
+
+					Tensor Output = InitTensor(Samples, OutDims);
+					Tensor Reference = InitTensor(Samples, OutDims);
+
+					Tensor Error = InitTensor(Samples, OutDims);
+					RandomizeTensor(&Error, -1, 1);
+
+					Tensor Back = InitTensor(Samples, InDims);
+					Tensor BackReference = InitTensor(Samples, InDims);
+
+					printf("Samples = %d, In = %dx%dx%d, WindowSize = %d, Stride = %d\n", Samples, InDims[0], InDims[1], InDims[2], WindowSize, Stride);
+
+					for(int t = 0; t < 2; ++t)
+					{
+						double Params[4] = {0, WindowSize, Types[t], Stride};
+
+						int MaskDims[3];
+						PoolMaskDims(InDims, Params, MaskDims);
+						Tensor Mask = InitTensor(Samples, MaskDims);
+
+						PoolForwCpu(&Input, &Mask, &Output, Params, NULL);
+						PoolBackCpu(&Output, &Error, &Mask, &Back, Params);
+
+						// --- Window by Window, first Max wins. Every Window adds its Error to the Pixels it covers --- //
+
+							int Mismatches = 0;
+
+							ZeroTensor(&BackReference);
+
+							for(int sample = 0; sample < Samples; ++sample)
+							{
+								for(int channel = 0; channel < OutDims[0]; ++channel)
+								{
+									for(int y = 0; y < OutDim; ++y)
+									{
+										for(int x = 0; x < OutDim; ++x)
+										{
+											double Value = Types[t] == MaxPool ? -DBL_MAX : 0;
+											int Position = 0;
+
+											for(int wy = 0; wy < WindowSize; ++wy)
+											{
+												for(int wx = 0; wx < WindowSize; ++wx)
+												{
+													double Pixel = TensorAt(&Input, sample, channel, y * Stride + wy, x * Stride + wx);
+
+													if(Types[t] == MeanPool)
+													{
+														Value += Pixel;
+													}
+													else if(Pixel > Value)
+													{
+														Value = Pixel;
+														Position = (y * Stride + wy) * InDims[2] + x * Stride + wx;
+													}
+												}
+											}
+
+											double Delta = TensorAt(&Error, sample, channel, y, x);
+
+											if(Types[t] == MeanPool)
+											{
+												Value /= (WindowSize * WindowSize);
+
+												for(int wy = 0; wy < WindowSize; ++wy)
+												{
+													for(int wx = 0; wx < WindowSize; ++wx)
+													{
+														TensorAt(&BackReference, sample, channel, y * Stride + wy, x * Stride + wx) += Delta / (WindowSize * WindowSize);
+													}
+												}
+											}
+											else
+											{
+												if(PoolArgmax(&Mask, sample)[(channel * OutDim + y) * OutDim + x] != Position)
+												{
+													++Mismatches;
+												}
+
+												TensorRow(&BackReference, sample, channel, 0)[Position] += Delta;
+											}
+
+											TensorAt(&Reference, sample, channel, y, x) = Value;
+										}
+									}
+								}
+							}
+
+						printf("\t%s Forward: ", Types[t] == MaxPool ? "MaxPool" : "MeanPool");
+						CompareTensor(&Reference, &Output, Margin);
+
+						printf("\t%s Backward: ", Types[t] == MaxPool ? "MaxPool" : "MeanPool");
+						CompareTensor(&BackReference, &Back, Margin);
+
+						if(Types[t] == MaxPool)
+						{
+							printf("\tArgmax Mismatches = %d\n", Mismatches);
+						}
+
+						FreeTensor(&Mask);
+					}
+
+					FreeTensor(&Input);
+					FreeTensor(&Output);
+					FreeTensor(&Reference);
+					FreeTensor(&Error);
+					FreeTensor(&Back);
+					FreeTensor(&BackReference);
+				}
+
+				printf("Pool Shapes Test Complete\n\n");
+			}
+
+	// 1.4 --- Activation --- //
+
+		void ActivationTest()
+		{
+			printf("Starting Activation Test\n\n");
+
+			// Odd Count, so the padded Tail is tested too. The last Values need Overflow Control, or would overflow exp
+			int Count = 100001;
+			int Dims[3] = {1, 1, Count};
+
+			Tensor Input = InitTensor(1, Dims);
+			RandomizeTensor(&Input, -20, 20);
+
+			Input.Data[0] = MaxValue + 5;
+			Input.Data[1] = -2 * MaxValue;
+			Input.Data[2] = 1e-12;
+			Input.Data[3] = 0;
+
+			Tensor Output = InitTensor(1, Dims);
+			Tensor Reference = InitTensor(1, Dims);
+
+			char Accuracies[2] = {ActPrecise, ActFast};
+			double Margins[2] = {1e-15, 1e-7};
+			char* AccuracyNames[2] = {"Precise", "Fast"};
+
+			char Acts[3] = {ReLu, Sigmoid, Tanh};
+			char* ActNames[3] = {"ReLu", "Sigmoid", "Tanh"};
+
+			for(int a = 0; a < 2; ++a)
+			{
+				SetActivationAccuracy(Accuracies[a]);
+
+				for(int f = 0; f < 3; ++f)
+				{
+					// --- libm, one Value at a time --- //
+
+						StartTiming();
+
+						for(int i = 0; i < Count; ++i)
+						{
+							double Value = Input.Data[i] > MaxValue ? MaxValue : Input.Data[i];
+
+							if(Acts[f] == ReLu)
+							{
+								Value = Value > 0 ? Value : 0;
+							}
+							else if(Acts[f] == Sigmoid)
+							{
+								Value = 1/(double)(1 + exp(-Value));
+							}
+							else
+							{
+								Value = tanh(Value);
+							}
+
+							Reference.Data[i] = Value;
+						}
+
+						double Scalar = StopTiming()/1000;
+
+					// --- Vectorized --- //
+
+						memcpy(Output.Data, Input.Data, Count * sizeof(double));
+
+						StartTiming();
+
+						ActivateRow(Output.Data, Count, Acts[f]);
+
+						double Vector = StopTiming()/1000;
+
+					printf("\t%s, %s: libm %.2f ms, ActivateRow %.2f ms\n\t", AccuracyNames[a], ActNames[f], Scalar, Vector);
+					CompareTensor(&Reference, &Output, Margins[a]);
+				}
+
+				// --- Softmax. Big Values would overflow exp without subtracting the Max first --- //
+
+					double Values[5] = {MaxValue, MaxValue - 1, MaxValue - 3, 0.5, -2};
+					int SoftDims[3] = {1, 1, 5};
+
+					Tensor SoftReference = InitTensor(1, SoftDims);
+
+					double Sum = 0;
+					for(int i = 0; i < 5; ++i)
+					{
+						SoftReference.Data[i] = exp(Values[i] - MaxValue);
+						Sum += SoftReference.Data[i];
+					}
+					for(int i = 0; i < 5; ++i)
+					{
+						SoftReference.Data[i] /= Sum;
+					}
+
+					Tensor SoftOutput = ViewTensor(Values, 1, SoftDims);
+					SoftmaxRow(Values, 5);
+
+					printf("\t%s, Softmax: ", AccuracyNames[a]);
+					CompareTensor(&SoftReference, &SoftOutput, Margins[a]);
+
+					FreeTensor(&SoftReference);
+			}
+
+			SetActivationAccuracy(ActPrecise);
+
+			FreeTensor(&Input);
+			FreeTensor(&Output);
+			FreeTensor(&Reference);
+
+			printf("Activation Test Complete\n\n");
+		}
@@ -5,11 +5,17 @@
 
 		void ConvForwTest();
 		void ConvBackTest();
+		void ConvAlgorithmTest();
+		void ConvBackAlgorithmTest();
 
 		void FconForwTest();
 		void FconBackTest();
 
 		void PoolForwTest();
 		void PoolBackTest();
+		void ConvPoolTest();
+		void PoolShapesTest();
+
+		void ActivationTest();
 		
 #endif
\ No newline at end of file
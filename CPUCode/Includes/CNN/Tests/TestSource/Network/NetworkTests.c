@@ -7,8 +7,16 @@
     2 - Performance
     	2.1 - Classify
     	2.2 - TestAccuracy
+    	2.3 - Threads
+    	2.4 - Classify Batch
 
 	3 - Train
+		3.1 - Train
+		3.2 - Small Network
+		3.3 - Train Threads
+		3.4 - Freeze
+		3.5 - Data Buffer
+		3.6 - Prefetch
 */
 
 // 1 --- Create Network --- //
@@ -146,8 +154,127 @@
 			printf("\nCalcTestAccuracy Test Done!\n\n");
 		}
 
+	// 2.3 --- Threads --- //
+
+		void ThreadsTest()
+		{
+			printf("\nStarting Threads Test\n\n");
+
+			int NSamples = 8;
+			int InDims[3] = {1, 28, 28};
+			int RandMin = 0;
+			int RandMax = 5;
+
+			int Threads[4] = {1, 2, 4, 8};
+
+			double**** Inputs = malloc(sizeof(double***) * NSamples);
+			int* Classes = malloc(sizeof(int) * NSamples);
+
+			for(int i = 0; i < NSamples; ++i)
+			{
+				Inputs[i] = Init3D(InDims);
+				RandomizeArray3D(Inputs[i], InDims, RandMin, RandMax);
+			}
+
+			Network* Net = malloc(sizeof(Network));
+			CreateNetwork(Net);
+
+			// Classes with 1 Thread are the reference. Every Thread count has to give the same ones
+			for(int t = 0; t < 4; ++t)
+			{
+				SetNumThreads(Net, Threads[t]);
+
+				int Mismatches = 0;
+
+				StartTiming();
+
+				for(int i = 0; i < NSamples; ++i)
+				{
+					int Class = Classify(*Net, Inputs[i]);
+
+					if(t == 0)
+					{
+						Classes[i] = Class;
+					}
+					else if(Class != Classes[i])
+					{
+						++Mismatches;
+					}
+				}
+
+				printf("Threads = %d, Time = %.2f ms, Mismatches = %d\n", Threads[t], StopTiming()/1000, Mismatches);
+			}
+
+			for(int i = 0; i < NSamples; ++i)
+			{
+				Free3D(Inputs[i]);
+			}
+			free(Inputs);
+			free(Classes);
+
+			FreeCNN(Net);
+			free(Net);
+
+			printf("\nThreads Test Done!\n\n");
+		}
+
+	// 2.4 --- Classify Batch --- //
+
+		void ClassifyBatchTest()
+		{
+			printf("\nStarting Classify Batch Test\n\n");
+
+			// Not a multiple of ClassifyChunk, so the last Chunk is smaller
+			int NSamples = 100;
+			int InDims[3] = {1, 28, 28};
+			int RandMin = 0;
+			int RandMax = 5;
+
+			Tensor Batch = InitTensor(NSamples, InDims);
+			RandomizeTensor(&Batch, RandMin, RandMax);
+
+			int* Classes = malloc(sizeof(int) * NSamples);
+
+			Network* Net = malloc(sizeof(Network));
+			CreateNetwork(Net);
+
+			StartTiming();
+			ClassifyBatch(Net, &Batch, Classes);
+			printf("Batch of %d, Time = %.2f ms\n", NSamples, StopTiming()/1000);
+
+			// Every Sample Classified on its own has to get the same Class
+			int Mismatches = 0;
+
+			StartTiming();
+
+			for(int i = 0; i < NSamples; ++i)
+			{
+				double*** Input = Init3D(InDims);
+				Copy1D(Batch.Data + i * Batch.Strides[0], Input[0][0], SampleSize(&Batch));
+
+				if(Classify(*Net, Input) != Classes[i])
+				{
+					++Mismatches;
+				}
+
+				Free3D(Input);
+			}
+
+			printf("One at a time, Time = %.2f ms, Mismatches = %d\n", StopTiming()/1000, Mismatches);
+
+			FreeTensor(&Batch);
+			free(Classes);
+
+			FreeCNN(Net);
+			free(Net);
+
+			printf("\nClassify Batch Test Done!\n\n");
+		}
+
 // 3 --- CNN Train --- //
 
+	// 3.1 --- Train --- //
+
 	void CNNTrainTest()
 	{
 		printf("\nStarting CNNTrainTest\n\n");
@@ -205,3 +332,350 @@
 
 		printf("\nCNNTrainTest Done!\n\n");
 	}
+
+	// 3.2 --- Small Network --- //
+
+		// Random Samples for CreateSmallNetwork, as bytes and converted to doubles
+		typedef struct
+		{
+			DataBuffer Data;			// Pixels and Labels as stored
+			double**** Inputs;			// Same Samples as doubles
+			double** Labels;			// One hot Labels
+
+		} SmallData;
+
+		/*
+			Create random Samples for CreateSmallNetwork. Labels cycle through the Classes
+
+			NSamples - Amount of Samples
+
+			Return Value - Samples. Free them with FreeSmallData
+		*/
+
+		static SmallData CreateSmallData(int NSamples)
+		{
+			SmallData Set;
+
+			int InDims[3] = {1, 12, 12};
+			int NClasses = 10;
+			int Pixels = InDims[0] * InDims[1] * InDims[2];
+
+			InitDataBuffer(&(Set.Data), NSamples, InDims, NClasses);
+
+			Set.Data.Scale = 1.0 / 255;
+			Set.Data.Shift = -0.5;
+
+			Set.Inputs = malloc(sizeof(double***) * NSamples);
+			Set.Labels = malloc(sizeof(double*) * NSamples);
+
+			for(int i = 0; i < NSamples; ++i)
+			{
+				for(int p = 0; p < Pixels; ++p)
+				{
+					Set.Data.Pixels[i * Pixels + p] = rand() % 256;
+				}
+
+				Set.Data.Labels[i] = i % NClasses;
+
+				Set.Inputs[i] = Init3D(InDims);
+				Set.Labels[i] = Init1D(NClasses);
+
+				ConvertSample(&(Set.Data), i, Set.Inputs[i][0][0]);
+				ConvertLabel(&(Set.Data), i, Set.Labels[i]);
+			}
+
+			return Set;
+		}
+
+		static void FreeSmallData(SmallData* Set)
+		{
+			for(int i = 0; i < Set->Data.Samples; ++i)
+			{
+				Free3D(Set->Inputs[i]);
+				Free1D(Set->Labels[i]);
+			}
+			free(Set->Inputs);
+			free(Set->Labels);
+
+			FreeDataBuffer(&(Set->Data));
+		}
+
+		/*
+			Create a small Network, so every Thread count trains quickly. The same Seed gives the same Weights.
+			The second Conv Layer Backpropagates its Input Error through the Transformed Filters
+
+			Seed - Seed of the Weights
+
+			Return Value - Network. Free it with FreeSmallNetwork
+		*/
+
+		static Network* CreateSmallNetwork(unsigned int Seed)
+		{
+			Network* Net = malloc(sizeof(Network));
+
+			int Dims[3] = {1, 12, 12};
+
+			srand(Seed);
+			InitCNN(Net, Dims);
+
+			SetBatchSize(Net, 37);
+			SetLearningRate(Net, 0.1);
+
+			AddBlock(Net);
+			AddConv(8, 3, 1, 1);
+			AddActi(ReLu);
+			AddConv(8, 3, 1, 1);
+			AddActi(ReLu);
+			AddPool(2, MaxPool, 2);
+
+			AddBlock(Net);
+			AddFcon(32);
+			AddActi(Sigmoid);
+			AddDrop(0.25);
+			AddFcon(10);
+			AddActi(Soft);
+
+			return Net;
+		}
+
+		static void FreeSmallNetwork(Network* Net)
+		{
+			FreeCNN(Net);
+			free(Net);
+		}
+
+		// Compare the Weights of every Layer of two Networks with the same Architecture
+		static void CompareNetworks(Network* Ref, Network* Net, double Margin)
+		{
+			for(int Block = 0; Block < Net->TotalBlocks; ++Block)
+			{
+				for(int Layer = 0; Layer < Net->Blocks[Block].BlockSize; ++Layer)
+				{
+					if(Net->Blocks[Block].Layers[Layer] != Pool)
+					{
+						CompareTensor(&(Ref->Blocks[Block].Weights[Layer]), &(Net->Blocks[Block].Weights[Layer]), Margin);
+					}
+				}
+			}
+		}
+
+	// 3.3 --- Train Threads --- //
+
+		void TrainThreadsTest()
+		{
+			printf("\nStarting Train Threads Test\n\n");
+
+			int NSamples = 200;
+			int MaxEpochs = 2;
+			unsigned int Seed = 42;
+
+			double Margin = 1e-9;
+
+			int Threads[3] = {2, 4, 8};
+
+			// Winograd and FFT keep Transformed Filters, which every Thread rebuilds after each Weight Update
+			char Algorithms[3] = {ConvAuto, ConvWinograd, ConvFFT};
+
+			SmallData Set = CreateSmallData(NSamples);
+
+			for(int a = 0; a < 3; ++a)
+			{
+				SetConvAlgorithm(Algorithms[a]);
+
+				// --- Reference, single Threaded --- //
+
+					Network* Ref = CreateSmallNetwork(Seed);
+
+					CNNTrainCPU(*Ref, Set.Inputs, Set.Labels, NSamples, MaxEpochs, 0, 101);
+
+				// --- Every Thread count has to end with the same Weights, up to rounding of the Reduction --- //
+
+					for(int t = 0; t < 3; ++t)
+					{
+						Network* Net = CreateSmallNetwork(Seed);
+						SetNumThreads(Net, Threads[t]);
+
+						StartTiming();
+						CNNTrainCPU(*Net, Set.Inputs, Set.Labels, NSamples, MaxEpochs, 0, 101);
+						printf("Algorithm = %d, Threads = %d, Time = %.2f ms\n", Algorithms[a], Threads[t], StopTiming()/1000);
+
+						CompareNetworks(Ref, Net, Margin);
+
+						FreeSmallNetwork(Net);
+					}
+
+				FreeSmallNetwork(Ref);
+			}
+
+			SetConvAlgorithm(ConvAuto);
+
+			FreeSmallData(&Set);
+
+			printf("\nTrain Threads Test Done!\n\n");
+		}
+
+	// 3.4 --- Freeze --- //
+
+		void FreezeTest()
+		{
+			printf("\nStarting Freeze Test\n\n");
+
+			int NSamples = 200;
+			int MaxEpochs = 2;
+			unsigned int Seed = 42;
+
+			double Margin = 1e-9;
+
+			char* Path = "FeatureCache.bin";
+
+			SmallData Set = CreateSmallData(NSamples);
+
+			// --- Reference, Forwarding the Frozen Conv Block for every Sample --- //
+
+				Network* Ref = CreateSmallNetwork(Seed);
+				FreezeBlock(Ref, 0, 1);
+				SetFeatureCache(Ref, 0, NULL);
+
+				Network* Initial = CreateSmallNetwork(Seed);
+
+				StartTiming();
+				CNNTrainCPU(*Ref, Set.Inputs, Set.Labels, NSamples, MaxEpochs, 0, 101);
+				printf("No Cache, Time = %.2f ms\n", StopTiming()/1000);
+
+				// Frozen Weights don't change
+				for(int Layer = 0; Layer < Ref->Blocks[0].BlockSize; ++Layer)
+				{
+					if(Ref->Blocks[0].Layers[Layer] != Pool)
+					{
+						CompareTensor(&(Initial->Blocks[0].Weights[Layer]), &(Ref->Blocks[0].Weights[Layer]), 0);
+					}
+				}
+
+			// --- Cached Features, in memory and mapped to a File, have to end with the same Weights --- //
+
+				for(int Mapped = 0; Mapped < 2; ++Mapped)
+				{
+					Network* Net = CreateSmallNetwork(Seed);
+					FreezeBlock(Net, 0, 1);
+					SetFeatureCache(Net, 1, Mapped ? Path : NULL);
+
+					StartTiming();
+					CNNTrainCPU(*Net, Set.Inputs, Set.Labels, NSamples, MaxEpochs, 0, 101);
+					printf("%s Cache, Time = %.2f ms\n", Mapped ? "File" : "Memory", StopTiming()/1000);
+
+					CompareNetworks(Ref, Net, Margin);
+
+					FreeSmallNetwork(Net);
+				}
+
+				remove(Path);
+
+			FreeSmallData(&Set);
+
+			FreeSmallNetwork(Initial);
+			FreeSmallNetwork(Ref);
+
+			printf("\nFreeze Test Done!\n\n");
+		}
+
+	// 3.5 --- Data Buffer --- //
+
+		void DataBufferTest()
+		{
+			printf("\nStarting Data Buffer Test\n\n");
+
+			int NSamples = 200;
+			int MaxEpochs = 2;
+			unsigned int Seed = 42;
+
+			double Margin = 0;
+
+			// --- Byte DataSet, and the same Samples converted to doubles --- //
+
+				SmallData Set = CreateSmallData(NSamples);
+
+				int Pixels = Set.Data.Dims[0] * Set.Data.Dims[1] * Set.Data.Dims[2];
+
+				printf("Bytes as doubles = %zu, as stored = %zu\n", sizeof(double) * NSamples * (Pixels + Set.Data.Classes), (sizeof(unsigned char) * Pixels + sizeof(int)) * NSamples);
+
+			// --- Both have to Train to the same Weights and Accuracy --- //
+
+				Network* Ref = CreateSmallNetwork(Seed);
+
+				StartTiming();
+				CNNTrainCPU(*Ref, Set.Inputs, Set.Labels, NSamples, MaxEpochs, 0, 101);
+				printf("doubles, Time = %.2f ms\n", StopTiming()/1000);
+
+				Network* Net = CreateSmallNetwork(Seed);
+
+				StartTiming();
+				CNNTrainCPUData(*Net, &(Set.Data), MaxEpochs, 0, 101);
+				printf("Data Buffer, Time = %.2f ms\n", StopTiming()/1000);
+
+				CompareNetworks(Ref, Net, Margin);
+
+				DataBuffer Test = ViewDataBuffer(&(Set.Data), NSamples / 2, NSamples / 2);
+
+				double RefAccuracy = CalcTestAccuracy(*Ref, Set.Inputs + NSamples / 2, Set.Labels + NSamples / 2, NSamples / 2);
+				double Accuracy = CalcDataAccuracy(*Net, &Test);
+
+				printf("Accuracy = %.2f%%, Data Buffer Accuracy = %.2f%%\n", RefAccuracy, Accuracy);
+
+			FreeDataBuffer(&Test);
+			FreeSmallData(&Set);
+
+			FreeSmallNetwork(Ref);
+			FreeSmallNetwork(Net);
+
+			printf("\nData Buffer Test Done!\n\n");
+		}
+
+	// 3.6 --- Prefetch --- //
+
+		void PrefetchTest()
+		{
+			printf("\nStarting Prefetch Test\n\n");
+
+			int NSamples = 300;
+			int MaxEpochs = 3;
+			unsigned int Seed = 42;
+
+			double Margin = 1e-9;
+
+			int Loaders[3] = {1, 3, 2};
+			int Threads[3] = {1, 1, 4};
+
+			SmallData Set = CreateSmallData(NSamples);
+
+			// --- Reference, Batches gathered by the Training Thread --- //
+
+				Network* Ref = CreateSmallNetwork(Seed);
+				SetLoaders(Ref, 0);
+
+				StartTiming();
+				CNNTrainCPUData(*Ref, &(Set.Data), MaxEpochs, 0, 101);
+				printf("Loaders = 0, Threads = 1, Time = %.2f ms\n", StopTiming()/1000);
+
+			// --- Loaders only assemble the Batches, so Weights end the same --- //
+
+				for(int t = 0; t < 3; ++t)
+				{
+					Network* Net = CreateSmallNetwork(Seed);
+					SetLoaders(Net, Loaders[t]);
+					SetNumThreads(Net, Threads[t]);
+
+					StartTiming();
+					CNNTrainCPUData(*Net, &(Set.Data), MaxEpochs, 0, 101);
+					printf("Loaders = %d, Threads = %d, Time = %.2f ms\n", Loaders[t], Threads[t], StopTiming()/1000);
+
+					CompareNetworks(Ref, Net, Margin);
+
+					FreeSmallNetwork(Net);
+				}
+
+			FreeSmallData(&Set);
+
+			FreeSmallNetwork(Ref);
+
+			printf("\nPrefetch Test Done!\n\n");
+		}
@@ -5,7 +5,13 @@
 
 		void ClassifyTest();
 		void CalcTestAccuracyTest();
+		void ThreadsTest();
+		void ClassifyBatchTest();
 
 		void CNNTrainTest();
+		void TrainThreadsTest();
+		void FreezeTest();
+		void DataBufferTest();
+		void PrefetchTest();
 
 #endif